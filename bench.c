@@ -0,0 +1,379 @@
+/*
+ * bench.c - In-process scaling benchmark driver
+ *
+ * Runs strong and weak scaling sweeps inside a single MPI job: for
+ * each problem size and each process count p = 1, 2, 4, ..., P the
+ * first p ranks form a
+ * sub-communicator, generate their row blocks, run warm-ups and then
+ * timed repeats of the chosen solver. Timings exclude job startup and
+ * data generation; each repeat is the slowest rank's time.
+ * Results (median, min, 95% confidence interval, speedup, efficiency)
+ * are written to CSV by rank 0.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+#include <mpi.h>
+#include "src/data.h"
+#include "src/ols.h"
+#include "src/gd.h"
+#include "src/iterative.h"
+#include "src/sgd.h"
+#include "src/utils.h"
+#include "src/threads.h"
+
+#define BENCH_STRONG 0
+#define BENCH_WEAK   1
+
+typedef struct {
+    char algorithm[10];
+    int n;               // rows (strong) or rows per process (weak)
+    int d;
+    int iterations;      // GD iterations / CG, L-BFGS limit / SGD steps
+    double learning_rate;
+    int warmups;
+    int repeats;
+    unsigned int seed;
+} bench_config_t;
+
+typedef struct {
+    double median;
+    double min;
+    double mean;
+    double ci_low;       // 95% confidence interval of the mean
+    double ci_high;
+} bench_stats_t;
+
+void print_usage(const char *prog_name) {
+    printf("Usage: %s [OPTIONS]\n", prog_name);
+    printf("Options:\n");
+    printf("  -a <algorithm>  Algorithm: ols, gd, cg, lbfgs or sgd (default: ols)\n");
+    printf("  -m <mode>       Scaling: strong, weak or both (default: both)\n");
+    printf("  -n <samples>    Samples (strong) / samples per process (weak); a comma list\n");
+    printf("                  sweeps several sizes, e.g. 10000,100000 (default: 100000)\n");
+    printf("  -d <features>   Number of features (default: 100)\n");
+    printf("  -i <iterations> GD iterations / iteration limit / SGD steps (default: 1000)\n");
+    printf("  -l <lr>         GD/SGD learning rate (default: 0.01)\n");
+    printf("  -w <runs>       Warm-up runs per configuration (default: 1)\n");
+    printf("  -r <runs>       Timed repeats per configuration (default: 5)\n");
+    printf("  -t <threads>    OpenMP threads per MPI process (default: OMP_NUM_THREADS)\n");
+    printf("  -o <file>       CSV output file (default: results/bench.csv)\n");
+    printf("  -h              Show this help message\n");
+}
+
+/*
+ * Two-sided 95% Student t quantile for df degrees of freedom
+ */
+static double t_quantile_95(int df) {
+    static const double table[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+    if (df < 1) return 0.0;
+    if (df <= 30) return table[df - 1];
+    return 1.960;
+}
+
+/*
+ * Parse a comma-separated list of positive problem sizes
+ *
+ * Returns:
+ *   number of values (stored in a malloc'd array), or -1 if invalid
+ */
+static int parse_sizes(const char *list, int **sizes) {
+    int count = 1;
+    for (const char *c = list; *c; c++) {
+        if (*c == ',') count++;
+    }
+    *sizes = (int *)malloc(count * sizeof(int));
+
+    const char *p = list;
+    for (int i = 0; i < count; i++) {
+        char *end;
+        long value = strtol(p, &end, 10);
+        if (end == p || (*end != ',' && *end != '\0') || value < 1 || value > INT_MAX) {
+            free(*sizes);
+            *sizes = NULL;
+            return -1;
+        }
+        (*sizes)[i] = (int)value;
+        p = end + 1;
+    }
+    return count;
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void compute_stats(double *times, int count, bench_stats_t *stats) {
+    qsort(times, count, sizeof(double), compare_doubles);
+    stats->min = times[0];
+    stats->median = (count % 2) ? times[count / 2]
+                                : 0.5 * (times[count / 2 - 1] + times[count / 2]);
+    double sum = 0.0;
+    for (int i = 0; i < count; i++) sum += times[i];
+    stats->mean = sum / count;
+    double var = 0.0;
+    for (int i = 0; i < count; i++) {
+        var += (times[i] - stats->mean) * (times[i] - stats->mean);
+    }
+    double half = 0.0;
+    if (count > 1) {
+        half = t_quantile_95(count - 1) * sqrt(var / (count - 1)) / sqrt(count);
+    }
+    stats->ci_low = stats->mean - half;
+    stats->ci_high = stats->mean + half;
+}
+
+/*
+ * One solve on the sub-communicator's pre-distributed rows
+ */
+static void run_solver(const bench_config_t *cfg, const double *X, const double *y,
+                       double *beta, int n, int local_n, int start_row, MPI_Comm comm) {
+    const char *alg = cfg->algorithm;
+    if (strcmp(alg, "gd") == 0) {
+        gd_parallel_local(X, y, beta, n, local_n, cfg->d, cfg->iterations,
+                          cfg->learning_rate, comm);
+    } else if (strcmp(alg, "cg") == 0) {
+        cg_parallel_local(X, y, beta, local_n, cfg->d, cfg->iterations, 1e-10, NULL, comm);
+    } else if (strcmp(alg, "lbfgs") == 0) {
+        lbfgs_parallel_local(X, y, beta, local_n, cfg->d, cfg->iterations, 1e-10,
+                             LBFGS_DEFAULT_MEMORY, NULL, comm);
+    } else if (strcmp(alg, "sgd") == 0) {
+        sgd_config_t sgd;
+        sgd_default_config(&sgd);
+        sgd.steps = cfg->iterations;
+        sgd.learning_rate = cfg->learning_rate;
+        sgd.seed = cfg->seed;
+        sgd_parallel_local(X, y, beta, n, local_n, start_row, cfg->d, &sgd, comm);
+    } else {
+        ols_parallel_local(X, y, beta, local_n, cfg->d, comm);
+    }
+}
+
+/*
+ * Time one configuration on the first p ranks
+ *
+ * Returns (on world rank 0) the per-repeat times in times[0..repeats-1];
+ * ranks outside the sub-communicator just wait.
+ */
+static void bench_configuration(const bench_config_t *cfg, int p, int n,
+                                double *times, MPI_Comm world) {
+    int world_rank;
+    MPI_Comm_rank(world, &world_rank);
+
+    MPI_Comm sub;
+    MPI_Comm_split(world, world_rank < p ? 0 : MPI_UNDEFINED, world_rank, &sub);
+
+    if (sub != MPI_COMM_NULL) {
+        int rank, local_n, start_row;
+        MPI_Comm_rank(sub, &rank);
+        get_row_partition(n, rank, p, &local_n, &start_row);
+
+        // Data generation is not timed
+        double *X = (double *)malloc((size_t)local_n * cfg->d * sizeof(double));
+        double *y = (double *)malloc(local_n * sizeof(double));
+        double *beta = (double *)malloc(cfg->d * sizeof(double));
+        if (local_n > 0 && (!X || !y)) {
+            fprintf(stderr, "Error: Memory allocation failed on rank %d\n", world_rank);
+            MPI_Abort(world, 1);
+        }
+        generate_synthetic_data_local(X, y, NULL, cfg->d, start_row, local_n, cfg->seed);
+
+        for (int run = 0; run < cfg->warmups + cfg->repeats; run++) {
+            MPI_Barrier(sub);
+            double start = MPI_Wtime();
+            run_solver(cfg, X, y, beta, n, local_n, start_row, sub);
+            double elapsed = MPI_Wtime() - start;
+
+            // A run takes as long as its slowest rank
+            double slowest;
+            MPI_Reduce(&elapsed, &slowest, 1, MPI_DOUBLE, MPI_MAX, 0, sub);
+            if (rank == 0 && run >= cfg->warmups) {
+                times[run - cfg->warmups] = slowest;
+            }
+        }
+
+        free(X);
+        free(y);
+        free(beta);
+        MPI_Comm_free(&sub);
+    }
+    MPI_Barrier(world);
+}
+
+int main(int argc, char *argv[]) {
+    // Only the main thread of each rank makes MPI calls
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    // Default parameters
+    bench_config_t cfg;
+    strcpy(cfg.algorithm, "ols");
+    cfg.d = 100;
+    cfg.iterations = 1000;
+    cfg.learning_rate = 0.01;
+    cfg.warmups = 1;
+    cfg.repeats = 5;
+    cfg.seed = 42;
+    char mode[10] = "both";
+    const char *size_list = "100000";
+    int num_threads = 0;
+    const char *csv_path = "results/bench.csv";
+
+    // Parse command line arguments
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) {
+            strncpy(cfg.algorithm, argv[++i], sizeof(cfg.algorithm) - 1);
+        } else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+            strncpy(mode, argv[++i], sizeof(mode) - 1);
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            size_list = argv[++i];
+        } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            cfg.d = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) {
+            cfg.iterations = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc) {
+            cfg.learning_rate = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            cfg.warmups = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            cfg.repeats = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            num_threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            csv_path = argv[++i];
+        } else if (strcmp(argv[i], "-h") == 0) {
+            if (rank == 0) print_usage(argv[0]);
+            MPI_Finalize();
+            return 0;
+        }
+    }
+
+    // Validate options
+    const char *algorithms[] = {"ols", "gd", "cg", "lbfgs", "sgd"};
+    int known = 0;
+    for (int k = 0; k < 5; k++) {
+        if (strcmp(cfg.algorithm, algorithms[k]) == 0) known = 1;
+    }
+    int run_strong = strcmp(mode, "strong") == 0 || strcmp(mode, "both") == 0;
+    int run_weak = strcmp(mode, "weak") == 0 || strcmp(mode, "both") == 0;
+    int *sizes = NULL;
+    int num_sizes = parse_sizes(size_list, &sizes);
+    if (!known || (!run_strong && !run_weak) || cfg.repeats < 1 || cfg.warmups < 0 ||
+        num_sizes < 1) {
+        if (rank == 0) {
+            fprintf(stderr, "Error: Invalid options (algorithm '%s', mode '%s', sizes '%s', "
+                            "%d repeats).\n", cfg.algorithm, mode, size_list, cfg.repeats);
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    set_num_threads(num_threads);
+    num_threads = get_num_threads();
+
+    // Process counts: powers of two, plus the full job size
+    int counts[32];
+    int num_counts = 0;
+    for (int p = 1; p < size; p *= 2) counts[num_counts++] = p;
+    counts[num_counts++] = size;
+
+    // Weak scaling grows n to size * p rows; the largest must fit in int
+    for (int s = 0; run_weak && s < num_sizes; s++) {
+        if ((long long)sizes[s] * size > INT_MAX) {
+            if (rank == 0) {
+                fprintf(stderr, "Error: Weak scaling size %d x %d processes exceeds %d rows.\n",
+                        sizes[s], size, INT_MAX);
+            }
+            free(sizes);
+            MPI_Finalize();
+            return 1;
+        }
+    }
+
+    FILE *csv = NULL;
+    if (rank == 0) {
+        csv = fopen(csv_path, "w");
+        if (!csv) {
+            fprintf(stderr, "Error: Cannot write '%s'\n", csv_path);
+        }
+    }
+    int ok = (rank != 0 || csv != NULL);
+    MPI_Bcast(&ok, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (!ok) {
+        free(sizes);
+        MPI_Finalize();
+        return 1;
+    }
+
+    if (rank == 0) {
+        printf("=== Scaling Benchmark (%s) ===\n", cfg.algorithm);
+        printf("d=%d, %d size(s), %d warm-up + %d timed runs, up to %d processes x %d threads\n\n",
+               cfg.d, num_sizes, cfg.warmups, cfg.repeats, size, num_threads);
+        fprintf(csv, "scaling,algorithm,n,d,processes,threads,repeats,median_seconds,"
+                     "min_seconds,mean_seconds,ci95_low,ci95_high,speedup,efficiency\n");
+    }
+
+    double *times = (double *)malloc(cfg.repeats * sizeof(double));
+    for (int scaling = BENCH_STRONG; scaling <= BENCH_WEAK; scaling++) {
+        if ((scaling == BENCH_STRONG && !run_strong) || (scaling == BENCH_WEAK && !run_weak)) {
+            continue;
+        }
+        const char *label = (scaling == BENCH_STRONG) ? "strong" : "weak";
+
+        // Every size gets its own sweep over p, relative to its own p = 1
+        for (int s = 0; s < num_sizes; s++) {
+            cfg.n = sizes[s];
+            double base_median = 0.0;
+
+            for (int c = 0; c < num_counts; c++) {
+                int p = counts[c];
+                int n = (int)((scaling == BENCH_STRONG) ? cfg.n : (long long)cfg.n * p);
+                bench_configuration(&cfg, p, n, times, MPI_COMM_WORLD);
+
+                if (rank == 0) {
+                    bench_stats_t stats;
+                    compute_stats(times, cfg.repeats, &stats);
+                    if (p == 1) base_median = stats.median;
+
+                    // Weak scaling: efficiency T1/Tp, scaled speedup p * T1/Tp
+                    double ratio = base_median / stats.median;
+                    double speedup = (scaling == BENCH_STRONG) ? ratio : p * ratio;
+                    double efficiency = speedup / p;
+
+                    printf("%-6s p=%-3d n=%-9d median %.6f s  min %.6f s  "
+                           "95%% CI [%.6f, %.6f]  speedup %.2f  efficiency %.2f\n",
+                           label, p, n, stats.median, stats.min, stats.ci_low,
+                           stats.ci_high, speedup, efficiency);
+                    fprintf(csv, "%s,%s,%d,%d,%d,%d,%d,%.6f,%.6f,%.6f,%.6f,%.6f,%.4f,%.4f\n",
+                            label, cfg.algorithm, n, cfg.d, p, num_threads, cfg.repeats,
+                            stats.median, stats.min, stats.mean, stats.ci_low,
+                            stats.ci_high, speedup, efficiency);
+                    fflush(csv);
+                }
+            }
+        }
+    }
+
+    if (rank == 0) {
+        fclose(csv);
+        printf("\nResults saved to: %s\n", csv_path);
+    }
+    free(times);
+    free(sizes);
+
+    MPI_Finalize();
+    return 0;
+}
@@ -8,26 +8,92 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 #include <mpi.h>
 #include "src/data.h"
+#include "src/dataset.h"
+#include "src/sparse.h"
 #include "src/ols.h"
+#include "src/ols_state.h"
+#include "src/ridge.h"
+#include "src/predict.h"
+#include "src/standardize.h"
+#include "src/context.h"
 #include "src/gd.h"
+#include "src/iterative.h"
+#include "src/sgd.h"
 #include "src/utils.h"
+#include "src/threads.h"
+#include "src/kernels.h"
+#include "src/timing.h"
 
 void print_usage(const char *prog_name) {
     printf("Usage: %s [OPTIONS]\n", prog_name);
     printf("Options:\n");
-    printf("  -a <algorithm>  Algorithm: ols or gd (default: ols)\n");
+    printf("  -a <algorithm>  Algorithm: ols, gd, cg, lbfgs or sgd (default: ols)\n");
     printf("  -n <samples>    Number of samples (default: 100000)\n");
     printf("  -d <features>   Number of features (default: 100)\n");
     printf("  -s <seed>       Random seed (default: 42)\n");
-    printf("  -i <iterations> GD iterations (default: 1000)\n");
-    printf("  -l <lr>         GD learning rate (default: 0.01)\n");
+    printf("  -i <iterations> GD iterations, CG/L-BFGS iteration limit, SGD steps (default: 1000)\n");
+    printf("  -l <lr>         GD/SGD learning rate (default: 0.01)\n");
+    printf("  -e <tol>        CG/L-BFGS relative residual tolerance (default: 1e-10)\n");
+    printf("  -b <rows>       SGD mini-batch size per process (default: 256)\n");
+    printf("  -k <steps>      SGD local steps between model averaging (default: 8)\n");
+    printf("  -D <decay>      SGD learning rate decay: lr / (1 + decay * step) (default: 0)\n");
+    printf("  -g <mode>       Data generation: root or dist (default: root)\n");
+    printf("  -f <file>       Load dataset file instead of generating (sets n, d)\n");
+    printf("  -m              Memory-map the dataset file instead of reading it (with -f)\n");
+    printf("  -w <file>       Write the generated dataset to file\n");
+    printf("  -p <precision>  Storage of X for OLS/GD: double or single (default: double)\n");
+    printf("  -z <density>    Sparse CSR X with this fraction of nonzeros (OLS/GD/CG/L-BFGS)\n");
+    printf("  -c <rows>       Streaming OLS: process data in chunks of <rows> rows\n");
+    printf("  -Z              Scale each column to unit RMS before fitting (beta in original units)\n");
+    printf("  -M <mode>       GD iterations: auto, data or gram (default: auto)\n");
+    printf("  -r <mode>       GD gradient reduction: root or allreduce (default: root)\n");
+    printf("  -S <solver>     OLS solve: root, dist or tsqr (default: root)\n");
+    printf("  -K <targets>    OLS/GD: fit <targets> response columns at once (default: 1)\n");
+    printf("  -R <l1,l2,...>  Ridge path: OLS with each penalty lambda from one data pass\n");
+    printf("  -cv <folds>     OLS with k-fold cross-validation from one data pass\n");
+    printf("  -B <file>       Write the fitted coefficients to <file>\n");
+    printf("  -P <file>       Predict/score mode: load coefficients from <file> instead of fitting\n");
+    printf("  -O <file>       Write predictions (float64 per row) in predict mode\n");
+    printf("  -u <file>       Incremental OLS: add the rows to the model state in <file> and re-solve\n");
+    printf("  -j <file>       Write the per-phase timing breakdown as JSON\n");
+    printf("  -t <threads>    OpenMP threads per MPI process (default: OMP_NUM_THREADS)\n");
     printf("  -h              Show this help message\n");
 }
 
+/*
+ * Parse a comma-separated list of non-negative ridge penalties
+ * 
+ * Returns:
+ *   number of values (stored in a malloc'd array), or -1 if invalid
+ */
+static int parse_lambdas(const char *list, double **lambdas) {
+    int count = 1;
+    for (const char *c = list; *c; c++) {
+        if (*c == ',') count++;
+    }
+    *lambdas = (double *)malloc(count * sizeof(double));
+    
+    const char *p = list;
+    for (int i = 0; i < count; i++) {
+        char *end;
+        (*lambdas)[i] = strtod(p, &end);
+        if (end == p || (*end != ',' && *end != '\0') || (*lambdas)[i] < 0.0) {
+            free(*lambdas);
+            *lambdas = NULL;
+            return -1;
+        }
+        p = end + 1;
+    }
+    return count;
+}
+
 int main(int argc, char *argv[]) {
-    MPI_Init(&argc, &argv);
+    // Only the main thread of each rank makes MPI calls
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
     
     int rank, size;
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
@@ -40,6 +106,30 @@ int main(int argc, char *argv[]) {
     unsigned int seed = 42;
     int gd_iterations = 1000;
     double gd_learning_rate = 0.01;
+    double tolerance = 1e-10;
+    int sgd_batch = 256;
+    int sgd_local_steps = 8;
+    double sgd_decay = 0.0;
+    char gen_mode[10] = "root";
+    const char *input_file = NULL;
+    const char *output_file = NULL;
+    const char *timing_file = NULL;
+    const char *state_file = NULL;
+    int targets = 1;
+    const char *ridge_list = NULL;
+    int cv_folds = 0;
+    const char *beta_out = NULL;
+    const char *beta_in = NULL;
+    const char *pred_file = NULL;
+    int use_mmap = 0;
+    int use_standardize = 0;
+    char precision[10] = "double";
+    double sparse_density = 0.0;
+    int chunk_rows = 0;
+    int num_threads = 0;
+    char solver[10] = "root";
+    char gd_comm[10] = "root";
+    char gd_space[10] = "auto";
     
     // Parse command line arguments
     for (int i = 1; i < argc; i++) {
@@ -55,6 +145,54 @@ int main(int argc, char *argv[]) {
             gd_iterations = atoi(argv[++i]);
         } else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc) {
             gd_learning_rate = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) {
+            tolerance = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            sgd_batch = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) {
+            sgd_local_steps = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-D") == 0 && i + 1 < argc) {
+            sgd_decay = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-g") == 0 && i + 1 < argc) {
+            strncpy(gen_mode, argv[++i], sizeof(gen_mode) - 1);
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            input_file = argv[++i];
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            timing_file = argv[++i];
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            output_file = argv[++i];
+        } else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            strncpy(precision, argv[++i], sizeof(precision) - 1);
+        } else if (strcmp(argv[i], "-z") == 0 && i + 1 < argc) {
+            sparse_density = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            chunk_rows = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            num_threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-M") == 0 && i + 1 < argc) {
+            strncpy(gd_space, argv[++i], sizeof(gd_space) - 1);
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            strncpy(gd_comm, argv[++i], sizeof(gd_comm) - 1);
+        } else if (strcmp(argv[i], "-S") == 0 && i + 1 < argc) {
+            strncpy(solver, argv[++i], sizeof(solver) - 1);
+        } else if (strcmp(argv[i], "-K") == 0 && i + 1 < argc) {
+            targets = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-R") == 0 && i + 1 < argc) {
+            ridge_list = argv[++i];
+        } else if (strcmp(argv[i], "-cv") == 0 && i + 1 < argc) {
+            cv_folds = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-B") == 0 && i + 1 < argc) {
+            beta_out = argv[++i];
+        } else if (strcmp(argv[i], "-P") == 0 && i + 1 < argc) {
+            beta_in = argv[++i];
+        } else if (strcmp(argv[i], "-O") == 0 && i + 1 < argc) {
+            pred_file = argv[++i];
+        } else if (strcmp(argv[i], "-u") == 0 && i + 1 < argc) {
+            state_file = argv[++i];
+        } else if (strcmp(argv[i], "-m") == 0) {
+            use_mmap = 1;
+        } else if (strcmp(argv[i], "-Z") == 0) {
+            use_standardize = 1;
         } else if (strcmp(argv[i], "-h") == 0) {
             if (rank == 0) print_usage(argv[0]);
             MPI_Finalize();
@@ -64,11 +202,251 @@ int main(int argc, char *argv[]) {
     
     // Validate algorithm choice
     int use_gd = 0;
+    int use_cg = 0;
+    int use_lbfgs = 0;
+    int use_sgd = 0;
     if (strcmp(algorithm, "gd") == 0) {
         use_gd = 1;
+    } else if (strcmp(algorithm, "cg") == 0) {
+        use_cg = 1;
+    } else if (strcmp(algorithm, "lbfgs") == 0) {
+        use_lbfgs = 1;
+    } else if (strcmp(algorithm, "sgd") == 0) {
+        use_sgd = 1;
     } else if (strcmp(algorithm, "ols") != 0) {
         if (rank == 0) {
-            fprintf(stderr, "Error: Unknown algorithm '%s'. Use 'ols' or 'gd'.\n", algorithm);
+            fprintf(stderr, "Error: Unknown algorithm '%s'. Use 'ols', 'gd', 'cg', 'lbfgs' or 'sgd'.\n", algorithm);
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    int use_iterative = use_cg || use_lbfgs;
+    const char *algorithm_name = use_gd ? "GD" : use_cg ? "CG" :
+                                 use_lbfgs ? "L-BFGS" : use_sgd ? "SGD" : "OLS";
+    
+    // Validate data generation mode
+    int dist_gen = 0;
+    if (strcmp(gen_mode, "dist") == 0) {
+        dist_gen = 1;
+    } else if (strcmp(gen_mode, "root") != 0) {
+        if (rank == 0) {
+            fprintf(stderr, "Error: Unknown generation mode '%s'. Use 'root' or 'dist'.\n", gen_mode);
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    
+    // Validate OLS solver choice
+    if (strcmp(solver, "dist") == 0) {
+        ols_set_solver(OLS_SOLVER_DISTRIBUTED);
+    } else if (strcmp(solver, "tsqr") == 0) {
+        ols_set_solver(OLS_SOLVER_TSQR);
+    } else if (strcmp(solver, "root") != 0) {
+        if (rank == 0) {
+            fprintf(stderr, "Error: Unknown solver '%s'. Use 'root', 'dist' or 'tsqr'.\n", solver);
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    
+    // Validate GD reduction mode
+    if (strcmp(gd_comm, "allreduce") == 0) {
+        gd_set_comm_mode(GD_COMM_ALLREDUCE);
+    } else if (strcmp(gd_comm, "root") != 0) {
+        if (rank == 0) {
+            fprintf(stderr, "Error: Unknown GD reduction '%s'. Use 'root' or 'allreduce'.\n", gd_comm);
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    
+    // Validate GD iteration space
+    if (strcmp(gd_space, "data") == 0) {
+        gd_set_mode(GD_MODE_DATA);
+    } else if (strcmp(gd_space, "gram") == 0) {
+        gd_set_mode(GD_MODE_GRAM);
+    } else if (strcmp(gd_space, "auto") != 0) {
+        if (rank == 0) {
+            fprintf(stderr, "Error: Unknown GD mode '%s'. Use 'auto', 'data' or 'gram'.\n", gd_space);
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    
+    // Threads inside each rank
+    set_num_threads(num_threads);
+    num_threads = get_num_threads();
+    if (rank == 0 && provided < MPI_THREAD_FUNNELED) {
+        fprintf(stderr, "Warning: MPI library does not provide MPI_THREAD_FUNNELED\n");
+    }
+    
+    // Streaming reads data inside the solver, which only OLS supports
+    int use_stream = (chunk_rows > 0);
+    if (use_stream && (use_gd || use_iterative || use_sgd || output_file || use_mmap)) {
+        if (rank == 0) {
+            fprintf(stderr, "Error: -c only supports OLS and cannot be combined with -w or -m.\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    
+    // Memory mapping needs a dataset file to map
+    if (use_mmap && !input_file) {
+        if (rank == 0) {
+            fprintf(stderr, "Error: -m maps a dataset file and needs -f.\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    
+    // Mixed precision keeps X in float32 inside the OLS and GD solvers
+    int use_single = 0;
+    if (strcmp(precision, "single") == 0) {
+        use_single = 1;
+    } else if (strcmp(precision, "double") != 0) {
+        if (rank == 0) {
+            fprintf(stderr, "Error: Unknown precision '%s'. Use 'double' or 'single'.\n", precision);
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    if (use_single && (use_iterative || use_sgd || use_stream || use_mmap)) {
+        if (rank == 0) {
+            fprintf(stderr, "Error: -p single only supports OLS and GD and cannot be combined with -c or -m.\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    
+    // Incremental OLS merges new rows into stored XtX/Xty
+    if (state_file && (use_gd || use_iterative || use_sgd || use_stream || use_single)) {
+        if (rank == 0) {
+            fprintf(stderr, "Error: -u only supports double-precision OLS and cannot be combined with -c.\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    
+    // Multi-target fits use generated in-memory data
+    if (targets < 1 || (targets > 1 && (use_iterative || use_sgd || use_stream || use_single ||
+                                        state_file || input_file || output_file))) {
+        if (rank == 0) {
+            fprintf(stderr, "Error: -K needs a positive count and only supports OLS and GD on "
+                            "generated double-precision data.\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    
+    // Ridge path reduces the sufficient statistics once for all lambdas
+    double *lambdas = NULL;
+    int num_lambdas = 0;
+    if (ridge_list) {
+        num_lambdas = parse_lambdas(ridge_list, &lambdas);
+        if (num_lambdas < 0 || use_gd || use_iterative || use_sgd || use_stream ||
+            use_single || state_file || targets > 1) {
+            if (rank == 0) {
+                fprintf(stderr, "Error: -R needs a comma-separated list of lambdas >= 0 and only "
+                                "supports single-target double-precision OLS without -c or -u.\n");
+            }
+            MPI_Finalize();
+            return 1;
+        }
+    }
+    
+    // Cross-validation reduces per-fold statistics in one pass
+    if (cv_folds != 0 && (cv_folds < 2 || use_gd || use_iterative || use_sgd || use_stream ||
+                          use_single || state_file || ridge_list || targets > 1)) {
+        if (rank == 0) {
+            fprintf(stderr, "Error: -cv needs at least 2 folds and only supports single-target "
+                            "double-precision OLS without -c, -u or -R.\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    
+    // Predict mode streams the rows through a loaded model; no fitting
+    int use_predict = (beta_in != NULL);
+    if ((pred_file && !use_predict) ||
+        (use_predict && (use_gd || use_iterative || use_sgd || use_single || use_mmap ||
+                         output_file || state_file || ridge_list || cv_folds || targets > 1 ||
+                         beta_out))) {
+        if (rank == 0) {
+            fprintf(stderr, "Error: -O needs -P, and -P only combines with -f/-n/-d/-s/-c/-t.\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    if (beta_out && targets > 1) {
+        if (rank == 0) {
+            fprintf(stderr, "Error: -B writes a single coefficient vector and cannot be combined with -K.\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    
+    // Problem size comes from the file header when loading a dataset
+    dataset_header_t header;
+    if (input_file) {
+        if (dataset_read_header(input_file, &header, MPI_COMM_WORLD) != 0) {
+            MPI_Finalize();
+            return 1;
+        }
+        n = header.n;
+        d = header.d;
+        if (header.dtype == DATASET_DTYPE_FLOAT32 && !use_single) {
+            if (rank == 0) {
+                fprintf(stderr, "Error: '%s' stores X as float32; use -p single.\n", input_file);
+            }
+            MPI_Finalize();
+            return 1;
+        }
+    }
+    
+    // Sparse X: generated with -z, or a CSR file; rows are split by nonzeros
+    int use_sparse = (sparse_density > 0.0) ||
+                     (input_file && header.layout == DATASET_LAYOUT_CSR);
+    if (sparse_density < 0.0 || sparse_density > 1.0 || (sparse_density > 0.0 && input_file) ||
+        (use_sparse && (use_sgd || use_stream || use_mmap || use_single || state_file ||
+                        targets > 1 || ridge_list || cv_folds || use_predict))) {
+        if (rank == 0) {
+            fprintf(stderr, "Error: -z needs a density in (0, 1] and cannot be combined with -f; "
+                            "sparse X only supports OLS, GD, CG and L-BFGS without "
+                            "-c/-m/-p/-u/-K/-R/-cv/-P.\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    
+    // TSQR factors the row blocks themselves, so it needs plain float64 rows
+    int use_tsqr = (strcmp(solver, "tsqr") == 0);
+    if (use_tsqr && (use_gd || use_iterative || use_sgd || use_stream || use_single ||
+                     state_file || targets > 1 || ridge_list || cv_folds || use_sparse ||
+                     use_predict)) {
+        if (rank == 0) {
+            fprintf(stderr, "Error: -S tsqr only supports single-target double-precision dense "
+                            "OLS without -c/-u/-K/-R/-cv/-z/-P.\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    
+    // The distributed Cholesky takes one right-hand side from a single fit
+    if (strcmp(solver, "dist") == 0 && (state_file || targets > 1 || ridge_list || cv_folds)) {
+        if (rank == 0) {
+            fprintf(stderr, "Error: -S dist solves one fit with a single target and cannot be "
+                            "combined with -u/-K/-R/-cv.\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    
+    // Standardisation rescales the in-memory float64 rows in place
+    if (use_standardize && (use_mmap || use_stream || use_single || use_sparse || use_predict ||
+                            state_file || targets > 1 || ridge_list || cv_folds)) {
+        if (rank == 0) {
+            fprintf(stderr, "Error: -Z needs single-target double-precision rows in memory and "
+                            "cannot be combined with -m/-c/-p single/-z/-P/-u/-K/-R/-cv.\n");
         }
         MPI_Finalize();
         return 1;
@@ -76,27 +454,211 @@ int main(int argc, char *argv[]) {
     
     // Print configuration (rank 0 only)
     if (rank == 0) {
-        printf("=== Parallel Linear Regression (%s) ===\n", use_gd ? "GD" : "OLS");
+        printf("=== Parallel Linear Regression (%s) ===\n", algorithm_name);
         printf("Problem size: n=%d, d=%d\n", n, d);
-        printf("Random seed: %u\n", seed);
+        if (input_file) {
+            printf("Input file: %s%s\n", input_file, use_mmap ? " (mmap)" : "");
+        } else {
+            printf("Random seed: %u\n", seed);
+            printf("Data generation: %s\n", dist_gen ? "distributed" : "rank 0");
+        }
         if (use_gd) {
             printf("GD iterations: %d\n", gd_iterations);
             printf("Learning rate: %.6f\n", gd_learning_rate);
+            // Only data-space iterations reduce a gradient each step
+            int gram = !use_sparse && gd_uses_gram_multi(n, d, targets, gd_iterations);
+            if (!use_sparse) {
+                printf("GD iteration space: %s\n", gram ? "Gram matrix (d x d)" : "data (n x d)");
+            }
+            if (!gram) {
+                printf("Gradient reduction: %s\n", gd_comm);
+            }
+        }
+        if (use_iterative) {
+            printf("Iteration limit: %d\n", gd_iterations);
+            printf("Tolerance: %.2e\n", tolerance);
+        }
+        if (use_sgd) {
+            printf("SGD steps: %d\n", gd_iterations);
+            printf("Batch size: %d rows per process\n", sgd_batch);
+            printf("Local steps between averaging: %d\n", sgd_local_steps);
+            printf("Learning rate: %.6f (decay %.3g)\n", gd_learning_rate, sgd_decay);
+        }
+        if (!use_gd && !use_iterative && !use_sgd) {
+            printf("OLS solver: %s\n", use_tsqr ? "TSQR (tree-reduced QR)" :
+                   strcmp(solver, "dist") == 0 ? "distributed Cholesky" : "rank 0");
+        }
+        if (use_standardize) {
+            printf("Feature scaling: unit RMS columns\n");
+        }
+        if (state_file) {
+            printf("Model state: %s (incremental)\n", state_file);
+        }
+        if (targets > 1) {
+            printf("Targets: %d\n", targets);
+        }
+        if (ridge_list) {
+            printf("Ridge penalties: %d (%s)\n", num_lambdas, ridge_list);
+        }
+        if (cv_folds) {
+            printf("Cross-validation folds: %d\n", cv_folds);
+        }
+        if (use_predict) {
+            printf("Predict mode: coefficients from %s%s%s\n", beta_in,
+                   pred_file ? ", predictions to " : "", pred_file ? pred_file : "");
+        }
+        if (use_stream) {
+            printf("Streaming chunk: %d rows\n", chunk_rows);
+        }
+        if (use_single) {
+            printf("X storage: float32 (float64 accumulation)\n");
+        }
+        if (use_sparse) {
+            printf("X storage: CSR, nonzero-balanced row blocks\n");
+            if (sparse_density > 0.0) {
+                printf("Density: %g\n", sparse_density);
+            }
         }
         printf("MPI processes: %d\n", size);
+        printf("Threads per process: %d\n", num_threads);
         printf("=========================================\n\n");
     }
     
-    // Allocate memory (only rank 0 generates data)
+    // Allocate memory
     double *X = NULL;
     double *y = NULL;
     double *beta_true = NULL;
-    double *beta = (double *)malloc(d * sizeof(double));
+    double *beta = (double *)malloc((size_t)d * targets * sizeof(double));
+    int local_n = 0;
+    int start_row = 0;
     
-    if (rank == 0) {
-        X = (double *)malloc(n * d * sizeof(double));
-        y = (double *)malloc(n * sizeof(double));
-        beta_true = (double *)malloc(d * sizeof(double));
+    // Data is pre-distributed unless rank 0 generates everything
+    int data_local = dist_gen || input_file;
+    
+    // Row block seen by the solvers: X/y, or the file mapping with -m
+    dataset_mapping_t mapping = {0};
+    const double *data_X = NULL;
+    const double *data_y = NULL;
+    
+    // float32 copy of X with -p single (replaces X)
+    float *X32 = NULL;
+    
+    // CSR X with -z or a CSR file (all rows on rank 0 unless data_local)
+    csr_matrix_t sparse_X = {0};
+    
+    if (use_sparse) {
+        int ok = 1;
+        if (input_file) {
+            // Rank 0 splits the rows by nonzeros, each rank reads its own
+            if (rank == 0) printf("[All ranks] Loading CSR dataset...\n");
+            if (dataset_read_csr_local(input_file, &header, &sparse_X, &y, &start_row,
+                                       MPI_COMM_WORLD) != 0) {
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+            local_n = sparse_X.rows;
+        } else if (dist_gen) {
+            // Equal row counts: generated rows are statistically alike
+            get_row_partition(n, rank, size, &local_n, &start_row);
+            y = (double *)malloc((local_n > 0 ? (size_t)local_n : 1) * sizeof(double));
+            beta_true = (double *)malloc(d * sizeof(double));
+            if (rank == 0) printf("[All ranks] Generating local CSR blocks...\n");
+            ok = y && beta_true &&
+                 generate_synthetic_sparse_local(&sparse_X, y, beta_true, d, sparse_density,
+                                                 start_row, local_n, seed) == 0;
+        } else if (rank == 0) {
+            y = (double *)malloc(n * sizeof(double));
+            beta_true = (double *)malloc(d * sizeof(double));
+            printf("[Rank 0] Generating sparse synthetic data...\n");
+            ok = y && beta_true &&
+                 generate_synthetic_sparse_local(&sparse_X, y, beta_true, d, sparse_density,
+                                                 0, n, seed) == 0;
+        }
+        if (!ok) {
+            fprintf(stderr, "Error: Memory allocation failed on rank %d\n", rank);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        long long nnz = csr_nnz(&sparse_X);
+        MPI_Allreduce(MPI_IN_PLACE, &nnz, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+        if (rank == 0) {
+            printf("Nonzeros: %lld (%.4f%% of n x d)\n\n", nnz, 100.0 * nnz / ((double)n * d));
+        }
+    } else if (use_stream || use_predict) {
+        // Rows are produced chunk by chunk inside the solver
+        get_row_partition(n, rank, size, &local_n, &start_row);
+        if (!input_file) {
+            beta_true = (double *)malloc(d * sizeof(double));
+            generate_synthetic_data_local(NULL, NULL, beta_true, d, 0, 0, seed);
+        }
+    } else if (input_file && use_mmap) {
+        // Every rank maps its own row range read-only: no copy, no scatter
+        get_row_partition(n, rank, size, &local_n, &start_row);
+        int ok = (dataset_map_local(input_file, &header, start_row, local_n, &mapping) == 0);
+        int all_ok;
+        MPI_Allreduce(&ok, &all_ok, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+        if (!all_ok) {
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        data_X = mapping.X;
+        data_y = mapping.y;
+        if (rank == 0) printf("[All ranks] Dataset mapped.\n\n");
+    } else if (input_file && header.dtype == DATASET_DTYPE_FLOAT32) {
+        // float32 file: read X straight into single precision
+        get_row_partition(n, rank, size, &local_n, &start_row);
+        X32 = (float *)malloc((size_t)local_n * d * sizeof(float));
+        y = (double *)malloc(local_n * sizeof(double));
+        
+        if (local_n > 0 && (!X32 || !y)) {
+            fprintf(stderr, "Error: Memory allocation failed on rank %d\n", rank);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        
+        if (rank == 0) printf("[All ranks] Loading dataset...\n");
+        if (dataset_read_local_f32(input_file, &header, X32, y, start_row, local_n,
+                                   MPI_COMM_WORLD) != 0) {
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        if (rank == 0) printf("[All ranks] Dataset loaded.\n\n");
+    } else if (input_file) {
+        // Every rank reads only its own row range
+        get_row_partition(n, rank, size, &local_n, &start_row);
+        X = (double *)malloc((size_t)local_n * d * sizeof(double));
+        y = (double *)malloc(local_n * sizeof(double));
+        
+        if (local_n > 0 && (!X || !y)) {
+            fprintf(stderr, "Error: Memory allocation failed on rank %d\n", rank);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        
+        if (rank == 0) printf("[All ranks] Loading dataset...\n");
+        if (dataset_read_local(input_file, &header, X, y, start_row, local_n,
+                               MPI_COMM_WORLD) != 0) {
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        if (rank == 0) printf("[All ranks] Dataset loaded.\n\n");
+    } else if (dist_gen) {
+        // Every rank generates only its own row block
+        get_row_partition(n, rank, size, &local_n, &start_row);
+        X = (double *)malloc((size_t)local_n * d * sizeof(double));
+        y = (double *)malloc((size_t)local_n * targets * sizeof(double));
+        beta_true = (double *)malloc((size_t)d * targets * sizeof(double));
+        
+        if ((local_n > 0 && (!X || !y)) || !beta_true) {
+            fprintf(stderr, "Error: Memory allocation failed on rank %d\n", rank);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        
+        if (rank == 0) printf("[All ranks] Generating local data blocks...\n");
+        if (targets > 1) {
+            generate_synthetic_targets_local(X, y, beta_true, d, targets, start_row, local_n, seed);
+        } else {
+            generate_synthetic_data_local(X, y, beta_true, d, start_row, local_n, seed);
+        }
+        if (rank == 0) printf("[All ranks] Data generation complete.\n\n");
+    } else if (rank == 0) {
+        // Only rank 0 generates data
+        X = (double *)malloc((size_t)n * d * sizeof(double));
+        y = (double *)malloc((size_t)n * targets * sizeof(double));
+        beta_true = (double *)malloc((size_t)d * targets * sizeof(double));
         
         if (!X || !y || !beta_true) {
             fprintf(stderr, "Error: Memory allocation failed\n");
@@ -105,21 +667,317 @@ int main(int argc, char *argv[]) {
         
         // Generate synthetic data
         printf("[Rank 0] Generating synthetic data...\n");
-        generate_synthetic_data(X, y, beta_true, n, d, seed);
+        if (targets > 1) {
+            generate_synthetic_targets_local(X, y, beta_true, d, targets, 0, n, seed);
+        } else {
+            generate_synthetic_data(X, y, beta_true, n, d, seed);
+        }
         printf("[Rank 0] Data generation complete.\n\n");
     }
     
+    if (!(input_file && use_mmap)) {
+        data_X = X;
+        data_y = y;
+    }
+    
+    // Narrow X to float32 once; the solvers only ever see X32
+    if (use_single && X) {
+        size_t rows = data_local ? (size_t)local_n : (size_t)n;
+        X32 = (float *)malloc(rows * d * sizeof(float));
+        if (rows > 0 && !X32) {
+            fprintf(stderr, "Error: Memory allocation failed on rank %d\n", rank);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        convert_f64_to_f32(X, X32, rows * d);
+        free(X);
+        X = NULL;
+        data_X = NULL;
+    }
+    
+    // Save the dataset so later runs can skip generation
+    if (output_file && use_sparse) {
+        if (dataset_write_csr_local(output_file, n, d, &sparse_X, y, data_local ? start_row : 0,
+                                    MPI_COMM_WORLD) != 0) {
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        if (rank == 0) printf("Dataset written to %s (CSR)\n\n", output_file);
+    } else if (output_file) {
+        int write_n = data_local ? local_n : (rank == 0 ? n : 0);
+        int write_start = data_local ? start_row : 0;
+        int write_err = use_single ?
+            dataset_write_local_f32(output_file, n, d, X32, data_y, write_start, write_n,
+                                    MPI_COMM_WORLD) :
+            dataset_write_local(output_file, n, d, data_X, data_y, write_start, write_n,
+                                MPI_COMM_WORLD);
+        if (write_err != 0) {
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        if (rank == 0) printf("Dataset written to %s\n\n", output_file);
+    }
+    
     // Synchronize before timing
     MPI_Barrier(MPI_COMM_WORLD);
     double start_time = MPI_Wtime();
+    timing_start("total");
+    
+    // Rescale the columns in place; beta is mapped back after the fit
+    feature_scaling_t scaling = {0};
+    solver_context_t scale_ctx = {0};
+    if (use_standardize) {
+        // Every rank scales its own row block: scatter rank 0's rows
+        // first, after which the solvers take the pre-distributed path
+        double *scale_X = X;
+        if (!data_local) {
+            if (solver_context_init(&scale_ctx, n, d, MPI_COMM_WORLD) != 0) {
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+            timing_start("scatter");
+            solver_context_scatter(&scale_ctx, X, y);
+            timing_stop("scatter");
+            scale_X = scale_ctx.local_X;
+            data_X = scale_ctx.local_X;
+            data_y = scale_ctx.local_y;
+            local_n = scale_ctx.local_n;
+            start_row = scale_ctx.start_row;
+            data_local = 1;
+        }
+        if (standardize_compute(scale_X, local_n, d, &scaling, MPI_COMM_WORLD) != 0) {
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        standardize_apply(scale_X, local_n, &scaling);
+        if (rank == 0) {
+            double min_scale = scaling.scale[0];
+            double max_scale = scaling.scale[0];
+            for (int j = 1; j < d; j++) {
+                if (scaling.scale[j] < min_scale) min_scale = scaling.scale[j];
+                if (scaling.scale[j] > max_scale) max_scale = scaling.scale[j];
+            }
+            printf("[All ranks] Columns scaled (RMS from %.3e to %.3e)\n", min_scale, max_scale);
+        }
+    }
     
     // Execute chosen algorithm
-    if (use_gd) {
-        gd_parallel(X, y, beta, n, d, gd_iterations, gd_learning_rate, MPI_COMM_WORLD);
+    iter_stats_t iter_stats = {0};
+    score_t score = {0};
+    long long state_rows = 0;
+    double *ridge_betas = NULL;
+    double *ridge_mse = NULL;
+    double *cv_mse = NULL;
+    double cv_mean = 0.0;
+    if (use_predict) {
+        // Score every rank's rows with the loaded coefficients
+        if (beta_read(beta_in, beta, d, MPI_COMM_WORLD) != 0) {
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        int predict_chunk = use_stream ? chunk_rows : 8192;
+        row_stream_t stream;
+        int ok = 1;
+        if (input_file) {
+            ok = (row_stream_open_file(&stream, input_file, &header, start_row,
+                                       local_n, predict_chunk) == 0);
+        } else {
+            row_stream_open_generator(&stream, d, seed, start_row, local_n, predict_chunk);
+        }
+        int all_ok;
+        MPI_Allreduce(&ok, &all_ok, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+        if (!all_ok || predict_stream(&stream, beta, pred_file, n, &score, MPI_COMM_WORLD) != 0) {
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        row_stream_close(&stream);
+    } else if (use_sparse) {
+        // Rank 0's generated rows go out in nonzero-balanced blocks
+        const csr_matrix_t *csr_X = &sparse_X;
+        const double *csr_y = y;
+        csr_matrix_t scattered_X = {0};
+        double *scattered_y = NULL;
+        if (!data_local) {
+            timing_start("scatter");
+            if (dataset_scatter_csr(&sparse_X, y, d, &scattered_X, &scattered_y, &start_row,
+                                    MPI_COMM_WORLD) != 0) {
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+            timing_stop("scatter");
+            csr_X = &scattered_X;
+            csr_y = scattered_y;
+        }
+        if (use_gd) {
+            gd_parallel_local_csr(csr_X, csr_y, beta, n, gd_iterations, gd_learning_rate,
+                                  MPI_COMM_WORLD);
+        } else if (use_cg) {
+            cg_parallel_local_csr(csr_X, csr_y, beta, gd_iterations, tolerance, &iter_stats,
+                                  MPI_COMM_WORLD);
+        } else if (use_lbfgs) {
+            lbfgs_parallel_local_csr(csr_X, csr_y, beta, gd_iterations, tolerance,
+                                     LBFGS_DEFAULT_MEMORY, &iter_stats, MPI_COMM_WORLD);
+        } else {
+            if (ols_parallel_local_csr(csr_X, csr_y, beta, NULL, MPI_COMM_WORLD) != 0) {
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+        }
+        csr_free(&scattered_X);
+        free(scattered_y);
+    } else if (use_iterative || use_sgd || state_file || ridge_list || cv_folds) {
+        // CG/L-BFGS/SGD, incremental OLS, the ridge path and
+        // cross-validation only work on distributed rows: scatter rank 0's data
+        const double *iter_X = data_X;
+        const double *iter_y = data_y;
+        double *scattered_X = NULL;
+        double *scattered_y = NULL;
+        if (!data_local) {
+            get_row_partition(n, rank, size, &local_n, &start_row);
+            scattered_X = (double *)malloc((size_t)local_n * d * sizeof(double));
+            scattered_y = (double *)malloc(local_n * sizeof(double));
+            timing_start("scatter");
+            dataset_scatter(X, y, n, d, scattered_X, scattered_y, MPI_COMM_WORLD);
+            timing_stop("scatter");
+            iter_X = scattered_X;
+            iter_y = scattered_y;
+        }
+        if (cv_folds) {
+            cv_mse = (double *)malloc(cv_folds * sizeof(double));
+            if (ols_cross_validate_local(iter_X, iter_y, beta, n, local_n, start_row, d,
+                                         cv_folds, cv_mse, &cv_mean, MPI_COMM_WORLD) != 0) {
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+        } else if (ridge_list) {
+            ridge_betas = (double *)malloc((size_t)num_lambdas * d * sizeof(double));
+            ridge_mse = (double *)malloc(num_lambdas * sizeof(double));
+            if (ridge_path_local(iter_X, iter_y, local_n, d, lambdas, num_lambdas,
+                                 ridge_betas, ridge_mse, MPI_COMM_WORLD) != 0) {
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+            // Report the first lambda as "the" solution
+            memcpy(beta, ridge_betas, d * sizeof(double));
+        } else if (state_file) {
+            ols_state_t state;
+            if (ols_state_load(state_file, d, &state, MPI_COMM_WORLD) < 0) {
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+            ols_state_update(&state, iter_X, iter_y, local_n, MPI_COMM_WORLD);
+            if (ols_state_save(state_file, &state, MPI_COMM_WORLD) != 0) {
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+            if (rank == 0) {
+                state_rows = state.n;
+                if (ols_state_solve(&state, beta) != 0) {
+                    MPI_Abort(MPI_COMM_WORLD, 1);
+                }
+            }
+            ols_state_free(&state);
+        } else if (use_sgd) {
+            sgd_config_t config;
+            sgd_default_config(&config);
+            config.batch_size = sgd_batch;
+            config.local_steps = sgd_local_steps;
+            config.steps = gd_iterations;
+            config.learning_rate = gd_learning_rate;
+            config.decay = sgd_decay;
+            config.seed = seed;
+            sgd_parallel_local(iter_X, iter_y, beta, n, local_n, start_row, d,
+                               &config, MPI_COMM_WORLD);
+        } else if (use_cg) {
+            cg_parallel_local(iter_X, iter_y, beta, local_n, d, gd_iterations,
+                              tolerance, &iter_stats, MPI_COMM_WORLD);
+        } else {
+            lbfgs_parallel_local(iter_X, iter_y, beta, local_n, d, gd_iterations,
+                                 tolerance, LBFGS_DEFAULT_MEMORY, &iter_stats, MPI_COMM_WORLD);
+        }
+        free(scattered_X);
+        free(scattered_y);
+    } else if (targets > 1) {
+        // Multi-target: one pass over X serves every response column
+        const double *multi_X = data_X;
+        const double *multi_Y = data_y;
+        double *scattered_X = NULL;
+        double *scattered_Y = NULL;
+        if (!data_local) {
+            get_row_partition(n, rank, size, &local_n, &start_row);
+            scattered_X = (double *)malloc((size_t)local_n * d * sizeof(double));
+            scattered_Y = (double *)malloc((size_t)local_n * targets * sizeof(double));
+            timing_start("scatter");
+            dataset_scatter_multi(X, y, n, d, targets, scattered_X, scattered_Y, MPI_COMM_WORLD);
+            timing_stop("scatter");
+            multi_X = scattered_X;
+            multi_Y = scattered_Y;
+        }
+        if (use_gd) {
+            gd_parallel_local_multi(multi_X, multi_Y, beta, n, local_n, d, targets,
+                                    gd_iterations, gd_learning_rate, MPI_COMM_WORLD);
+        } else {
+            if (ols_parallel_local_multi(multi_X, multi_Y, beta, local_n, d, targets, NULL,
+                                         MPI_COMM_WORLD) != 0) {
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+        }
+        free(scattered_X);
+        free(scattered_Y);
+    } else if (use_single) {
+        // Mixed precision: scatter (if needed) and solve on float32 rows
+        const float *single_X = X32;
+        const double *single_y = data_y;
+        float *scattered_X = NULL;
+        double *scattered_y = NULL;
+        if (!data_local) {
+            get_row_partition(n, rank, size, &local_n, &start_row);
+            scattered_X = (float *)malloc((size_t)local_n * d * sizeof(float));
+            scattered_y = (double *)malloc(local_n * sizeof(double));
+            timing_start("scatter");
+            dataset_scatter_f32(X32, y, n, d, scattered_X, scattered_y, MPI_COMM_WORLD);
+            timing_stop("scatter");
+            single_X = scattered_X;
+            single_y = scattered_y;
+        }
+        if (use_gd) {
+            gd_parallel_local_f32(single_X, single_y, beta, n, local_n, d, gd_iterations,
+                                  gd_learning_rate, MPI_COMM_WORLD);
+        } else {
+            if (ols_parallel_local_f32(single_X, single_y, beta, local_n, d, NULL,
+                                       MPI_COMM_WORLD) != 0) {
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+        }
+        free(scattered_X);
+        free(scattered_y);
+    } else if (use_stream) {
+        row_stream_t stream;
+        int ok = 1;
+        if (input_file) {
+            ok = (row_stream_open_file(&stream, input_file, &header, start_row,
+                                       local_n, chunk_rows) == 0);
+        } else {
+            row_stream_open_generator(&stream, d, seed, start_row, local_n, chunk_rows);
+        }
+        int all_ok;
+        MPI_Allreduce(&ok, &all_ok, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+        if (!all_ok || ols_parallel_stream(&stream, beta, MPI_COMM_WORLD) != 0) {
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        row_stream_close(&stream);
+    } else if (data_local) {
+        if (use_gd) {
+            gd_parallel_local(data_X, data_y, beta, n, local_n, d, gd_iterations, gd_learning_rate, MPI_COMM_WORLD);
+        } else {
+            if (ols_parallel_local(data_X, data_y, beta, local_n, d, MPI_COMM_WORLD) != 0) {
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+        }
     } else {
-        ols_parallel(X, y, beta, n, d, MPI_COMM_WORLD);
+        if (use_gd) {
+            gd_parallel(X, y, beta, n, d, gd_iterations, gd_learning_rate, MPI_COMM_WORLD);
+        } else {
+            if (ols_parallel(X, y, beta, n, d, MPI_COMM_WORLD) != 0) {
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+        }
+    }
+    
+    if (use_standardize) {
+        standardize_unscale_beta(&scaling, beta);
     }
     
+    // Per-rank time before the final barrier, so imbalance stays visible
+    timing_stop("total");
+    
     // Synchronize after computation
     MPI_Barrier(MPI_COMM_WORLD);
     double end_time = MPI_Wtime();
@@ -129,32 +987,98 @@ int main(int argc, char *argv[]) {
     if (rank == 0) {
         printf("\n=== Results ===\n");
         printf("Execution time: %.6f seconds\n", elapsed_time);
+        if (use_iterative) {
+            printf("Iterations: %d (%s)\n", iter_stats.iterations,
+                   iter_stats.converged ? "converged" : "iteration limit reached");
+            printf("Final relative residual: %.6e\n", iter_stats.residual);
+        }
+        if (state_file) {
+            printf("Rows in model state: %lld (%d new)\n", state_rows, n);
+        }
+        if (ridge_list) {
+            printf("\n=== Ridge Path ===\n");
+            printf("lambda,train_mse,beta_norm\n");
+            for (int l = 0; l < num_lambdas; l++) {
+                double norm_sq = 0.0;
+                const double *b = ridge_betas + (size_t)l * d;
+                for (int j = 0; j < d; j++) {
+                    norm_sq += b[j] * b[j];
+                }
+                printf("%g,%.6e,%.6e\n", lambdas[l], ridge_mse[l], sqrt(norm_sq));
+            }
+            printf("\nCoefficients below are for lambda = %g\n", lambdas[0]);
+        }
+        if (use_predict) {
+            printf("\n=== Scores ===\n");
+            printf("Rows scored: %lld\n", score.n);
+            printf("MSE: %.6e (RMSE %.6e)\n", score.mse, score.rmse);
+            printf("R^2: %.6f\n", score.r2);
+            printf("Residual mean: %.6e, std: %.6e, max |r|: %.6e\n",
+                   score.mean_residual, score.residual_std, score.max_abs_residual);
+            if (pred_file) {
+                printf("Predictions written to %s\n", pred_file);
+            }
+        }
+        if (cv_folds) {
+            printf("\n=== Cross-Validation ===\n");
+            printf("fold,test_rows,test_mse\n");
+            for (int f = 0; f < cv_folds; f++) {
+                int fold_n, fold_start;
+                get_row_partition(n, f, cv_folds, &fold_n, &fold_start);
+                printf("%d,%d,%.6e\n", f, fold_n, cv_mse[f]);
+            }
+            printf("Mean validation MSE: %.6e\n", cv_mean);
+            printf("\nCoefficients below are fitted on all rows\n");
+        }
         
         // Print first few beta coefficients
-        printf("\nComputed beta (first 5):\n");
+        printf("\nComputed beta (first 5%s):\n", targets > 1 ? ", target 0" : "");
         int print_d = (d < 5) ? d : 5;
         for (int i = 0; i < print_d; i++) {
-            printf("  beta[%d] = %.6f\n", i, beta[i]);
+            printf("  beta[%d] = %.6f\n", i, beta[(size_t)i * targets]);
         }
         
-        // Compute error against true beta
+        // Compute error against true beta (Frobenius norm for k targets)
         if (beta_true) {
-            double error = vector_diff_norm(beta_true, beta, d);
+            double error = vector_diff_norm(beta_true, beta, d * targets);
             printf("\nError ||beta_true - beta_computed|| = %.6e\n", error);
         }
-        
-        // Output timing data in CSV format for analysis
+    }
+    
+    // Save the model for later predict runs, before the CSV sections
+    if (beta_out) {
+        if (beta_write(beta_out, beta, d, MPI_COMM_WORLD) != 0) {
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        if (rank == 0) printf("\nCoefficients written to %s\n", beta_out);
+    }
+    
+    // Per-phase breakdown across ranks (collective)
+    if (rank == 0) printf("\n=== Phase Timing CSV ===\n");
+    timing_report(stdout, timing_file, MPI_COMM_WORLD);
+    
+    // Output timing data in CSV format for analysis; last, so scripts can
+    // take the result row with tail -1
+    if (rank == 0) {
         printf("\n=== CSV Output ===\n");
-        printf("algorithm,n,d,processes,time_seconds\n");
-        printf("%s,%d,%d,%d,%.6f\n", algorithm, n, d, size, elapsed_time);
-        
-        // Clean up
-        free(X);
-        free(y);
-        free(beta_true);
+        printf("algorithm,n,d,processes,time_seconds,threads\n");
+        printf("%s,%d,%d,%d,%.6f,%d\n", algorithm, n, d, size, elapsed_time, num_threads);
     }
     
+    // Clean up
+    dataset_unmap(&mapping);
+    csr_free(&sparse_X);
+    standardize_free(&scaling);
+    solver_context_free(&scale_ctx);
+    free(X);
+    free(X32);
+    free(y);
+    free(beta_true);
     free(beta);
+    free(lambdas);
+    free(ridge_betas);
+    free(ridge_mse);
+    free(cv_mse);
     
     MPI_Finalize();
     return 0;
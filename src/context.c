@@ -0,0 +1,57 @@
+/*
+ * context.c - Reusable solver context implementation
+ */
+
+#include "context.h"
+#include "dataset.h"
+#include "threads.h"
+#include "utils.h"
+#include <stdio.h>
+#include <string.h>
+
+int solver_context_init(solver_context_t *ctx, int n, int d, MPI_Comm comm) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->comm = comm;
+    ctx->n = n;
+    ctx->d = d;
+    get_row_partition(n, rank, size, &ctx->local_n, &ctx->start_row);
+    
+    // Step 1: One region for X and y
+    size_t row_bytes = (size_t)d * sizeof(double);
+    size_t X_bytes = workspace_bytes((size_t)ctx->local_n * d, sizeof(double));
+    size_t y_bytes = workspace_bytes(ctx->local_n, sizeof(double));
+    int ok = (workspace_reserve(&ctx->data, X_bytes + y_bytes) == 0);
+    int all_ok;
+    MPI_Allreduce(&ok, &all_ok, 1, MPI_INT, MPI_LAND, comm);
+    if (!all_ok) {
+        if (!ok) {
+            fprintf(stderr, "Error: Memory allocation failed on rank %d\n", rank);
+        }
+        workspace_free(&ctx->data);
+        return -1;
+    }
+    ctx->local_X = (double *)workspace_alloc(&ctx->data, X_bytes);
+    ctx->local_y = (double *)workspace_alloc(&ctx->data, y_bytes);
+    
+    // Step 2: Each thread touches the rows it will process, with the
+    // thread count the OLS and GD kernels use for this many rows
+    int num_threads = get_row_threads(ctx->local_n, ROW_MIN_ROWS_PER_THREAD);
+    workspace_first_touch(ctx->local_X, ctx->local_n, row_bytes, num_threads);
+    workspace_first_touch(ctx->local_y, ctx->local_n, sizeof(double), num_threads);
+    return 0;
+}
+
+void solver_context_scatter(solver_context_t *ctx, const double *X, const double *y) {
+    dataset_scatter(X, y, ctx->n, ctx->d, ctx->local_X, ctx->local_y, ctx->comm);
+}
+
+void solver_context_free(solver_context_t *ctx) {
+    workspace_free(&ctx->data);
+    workspace_free(&ctx->scratch);
+    ctx->local_X = NULL;
+    ctx->local_y = NULL;
+}
@@ -0,0 +1,52 @@
+/*
+ * context.h - Reusable solver context
+ * 
+ * Holds one rank's row block and the solvers' scratch in two aligned
+ * workspaces (see workspace.h). The row block is first touched by the
+ * OpenMP threads in the same static partition the kernels use, so each
+ * thread's rows sit on its own NUMA node; scratch grows to its
+ * high-water mark during the first solves, after which repeated solves
+ * (ols_parallel_ctx with the default OLS_SOLVER_ROOT, gd_parallel_ctx)
+ * do no allocator work outside MPI, short of the LDL^T fallback for a
+ * singular XtX.
+ */
+
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include <mpi.h>
+#include "workspace.h"
+
+typedef struct {
+    MPI_Comm comm;
+    int n;                // total number of samples
+    int d;                // number of features
+    int local_n;          // rows owned by this rank
+    int start_row;        // first global row of this rank
+    double *local_X;      // local_n x d row block (in data)
+    double *local_y;      // local_n x 1 responses (in data)
+    workspace_t data;     // row block, sized once
+    workspace_t scratch;  // solver temporaries, reused across calls
+} solver_context_t;
+
+/*
+ * Allocate the context for an n x d problem in the standard row
+ * partition (see get_row_partition); the row block is zeroed
+ * 
+ * Returns (same on every rank):
+ *   0 on success, -1 if allocation fails on any rank
+ */
+int solver_context_init(solver_context_t *ctx, int n, int d, MPI_Comm comm);
+
+/*
+ * Scatter rank 0's full X and y into every rank's row block (collective;
+ * may be called again with new data of the same shape)
+ */
+void solver_context_scatter(solver_context_t *ctx, const double *X, const double *y);
+
+/*
+ * Release both workspaces
+ */
+void solver_context_free(solver_context_t *ctx);
+
+#endif // CONTEXT_H
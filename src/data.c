@@ -4,23 +4,129 @@
 
 #include "data.h"
 #include <stdlib.h>
+#include <stdint.h>
 #include <math.h>
 #include <stdio.h>
+#include <string.h>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
+// Independent RNG streams, one per kind of random draw
+#define STREAM_X_U1  1
+#define STREAM_X_U2  2
+#define STREAM_BETA  3
+#define STREAM_NOISE_U1 4
+#define STREAM_NOISE_U2 5
+#define STREAM_SPARSE_MASK 6
+
+/*
+ * SplitMix64 finaliser: a bijective 64-bit mixing function
+ */
+static uint64_t mix64(uint64_t z) {
+    z += 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+uint64_t counter_random(unsigned int seed, int stream, uint64_t counter) {
+    uint64_t key = mix64(((uint64_t)seed << 8) | (uint64_t)stream);
+    return mix64(key ^ mix64(counter));
+}
+
 /*
- * Generate random number from standard normal distribution
- * Using Box-Muller transform
+ * Counter-based uniform draw in (0, 1]
+ * The value depends only on (seed, stream, counter), never on call order.
  */
-static double randn() {
-    double u1 = (double)rand() / RAND_MAX;
-    double u2 = (double)rand() / RAND_MAX;
+static double counter_uniform(unsigned int seed, int stream, uint64_t counter) {
+    uint64_t bits = counter_random(seed, stream, counter);
+    return ((double)(bits >> 11) + 1.0) * (1.0 / 9007199254740992.0);
+}
+
+/*
+ * Counter-based standard normal draw using Box-Muller transform
+ */
+static double counter_randn(unsigned int seed, int stream_u1, int stream_u2,
+                            uint64_t counter) {
+    double u1 = counter_uniform(seed, stream_u1, counter);
+    double u2 = counter_uniform(seed, stream_u2, counter);
     return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
 }
 
+/*
+ * Counter of element i of target t: target 0 uses the plain index, so
+ * it reproduces the single-target dataset
+ */
+static uint64_t target_counter(int t, uint64_t i) {
+    return ((uint64_t)t << 32) | i;
+}
+
+/*
+ * Generate the true coefficients of target t (d x 1) from uniform
+ * distribution [-5, 5] and return the noise level that goes with them
+ */
+static double generate_beta_target(double *beta_true, int d, int t, unsigned int seed) {
+    double norm_sq = 0.0;
+    for (int j = 0; j < d; j++) {
+        double b = 10.0 * counter_uniform(seed, STREAM_BETA,
+                                          target_counter(t, (uint64_t)j)) - 5.0;
+        if (beta_true) beta_true[j] = b;
+        norm_sq += b * b;
+    }
+    // X has i.i.d. N(0,1) entries, so std(X * beta_true) = ||beta_true||.
+    // Using the exact value instead of a sample estimate keeps the noise
+    // level independent of how the rows are split across processes.
+    return 0.1 * sqrt(norm_sq);
+}
+
+/*
+ * Generate beta_true (d x 1) and its noise level
+ */
+static double generate_beta_true(double *beta_true, int d, unsigned int seed) {
+    return generate_beta_target(beta_true, d, 0, seed);
+}
+
+void generate_synthetic_data_local(
+    double *local_X,
+    double *local_y,
+    double *beta_true,
+    int d,
+    int start_row,
+    int local_n,
+    unsigned int seed
+) {
+    double *beta = (double *)malloc(d * sizeof(double));
+    double noise_level = generate_beta_true(beta, d, seed);
+    
+    for (int i = 0; i < local_n; i++) {
+        uint64_t row = (uint64_t)start_row + (uint64_t)i;
+        double *x_row = local_X + (size_t)i * d;
+        
+        // 1. Generate row of X from standard normal distribution
+        for (int j = 0; j < d; j++) {
+            x_row[j] = counter_randn(seed, STREAM_X_U1, STREAM_X_U2,
+                                     row * (uint64_t)d + (uint64_t)j);
+        }
+        
+        // 2. y = X * beta_true + noise
+        double yi = 0.0;
+        for (int j = 0; j < d; j++) {
+            yi += x_row[j] * beta[j];
+        }
+        local_y[i] = yi + noise_level *
+                     counter_randn(seed, STREAM_NOISE_U1, STREAM_NOISE_U2, row);
+    }
+    
+    if (beta_true) {
+        for (int j = 0; j < d; j++) {
+            beta_true[j] = beta[j];
+        }
+    }
+    free(beta);
+}
+
 void generate_synthetic_data(
     double *X,
     double *y,
@@ -29,56 +135,131 @@ void generate_synthetic_data(
     int d,
     unsigned int seed
 ) {
-    // Set random seed for reproducibility
-    srand(seed);
+    // The full dataset is simply the block covering every row
+    generate_synthetic_data_local(X, y, beta_true, d, 0, n, seed);
+    
+    // Noise level: 0.1 * std(X*beta) for SNR ~= 20dB
+    double noise_level = generate_beta_true(NULL, d, seed);
     
-    // 1. Generate random X matrix (n x d) from standard normal distribution
-    for (int i = 0; i < n; i++) {
+    printf("[Data] Generated synthetic data: n=%d, d=%d, seed=%u\n", n, d, seed);
+    printf("[Data] True beta range: [%.2f, %.2f]\n", 
+           beta_true[0], beta_true[d-1]);
+    printf("[Data] Signal std: %.4f, Noise level: %.4f (SNR ~20dB)\n", 
+           10.0 * noise_level, noise_level);
+}
+
+void generate_synthetic_targets_local(
+    double *local_X,
+    double *local_Y,
+    double *B_true,
+    int d,
+    int k,
+    int start_row,
+    int local_n,
+    unsigned int seed
+) {
+    // Coefficients and noise level of every target, beta stored d x k
+    double *B = (double *)malloc((size_t)d * k * sizeof(double));
+    double *noise_level = (double *)malloc(k * sizeof(double));
+    double *beta = (double *)malloc(d * sizeof(double));
+    for (int t = 0; t < k; t++) {
+        noise_level[t] = generate_beta_target(beta, d, t, seed);
         for (int j = 0; j < d; j++) {
-            X[i * d + j] = randn();
+            B[(size_t)j * k + t] = beta[j];
         }
     }
     
-    // 2. Generate random beta_true (d x 1) from uniform distribution [-5, 5]
-    // This creates a well-conditioned problem with moderate coefficients
-    for (int j = 0; j < d; j++) {
-        beta_true[j] = 10.0 * ((double)rand() / RAND_MAX) - 5.0;
+    for (int i = 0; i < local_n; i++) {
+        uint64_t row = (uint64_t)start_row + (uint64_t)i;
+        double *x_row = local_X + (size_t)i * d;
+        double *y_row = local_Y + (size_t)i * k;
+        
+        // 1. Same X rows as generate_synthetic_data_local
+        for (int j = 0; j < d; j++) {
+            x_row[j] = counter_randn(seed, STREAM_X_U1, STREAM_X_U2,
+                                     row * (uint64_t)d + (uint64_t)j);
+        }
+        
+        // 2. Y = X * B_true + noise, target by target
+        for (int t = 0; t < k; t++) {
+            double yi = 0.0;
+            for (int j = 0; j < d; j++) {
+                yi += x_row[j] * B[(size_t)j * k + t];
+            }
+            y_row[t] = yi + noise_level[t] *
+                       counter_randn(seed, STREAM_NOISE_U1, STREAM_NOISE_U2,
+                                     target_counter(t, row));
+        }
     }
     
-    // 3. Calculate y = X * beta_true (no noise for exact solution testing)
-    for (int i = 0; i < n; i++) {
-        y[i] = 0.0;
+    if (B_true) {
+        memcpy(B_true, B, (size_t)d * k * sizeof(double));
+    }
+    free(B);
+    free(noise_level);
+    free(beta);
+}
+
+int generate_synthetic_sparse_local(
+    csr_matrix_t *local_X,
+    double *local_y,
+    double *beta_true,
+    int d,
+    double density,
+    int start_row,
+    int local_n,
+    unsigned int seed
+) {
+    // 1. Count the nonzeros so the CSR arrays are allocated once; the
+    //    block's int offsets cap them at INT32_MAX
+    long long nnz = 0;
+    for (int i = 0; i < local_n; i++) {
+        uint64_t row = (uint64_t)start_row + (uint64_t)i;
         for (int j = 0; j < d; j++) {
-            y[i] += X[i * d + j] * beta_true[j];
+            nnz += counter_uniform(seed, STREAM_SPARSE_MASK,
+                                   row * (uint64_t)d + (uint64_t)j) <= density;
         }
     }
-    
-    // 4. Add Gaussian noise: y = X * beta + noise
-    // Noise level: 0.1 * std(X*beta) for SNR ~= 20dB
-    double y_mean = 0.0;
-    double y_std = 0.0;
-    
-    // Calculate mean
-    for (int i = 0; i < n; i++) {
-        y_mean += y[i];
+    if (nnz > INT32_MAX) {
+        fprintf(stderr, "Error: Sparse row block has %lld nonzeros (at most %d)\n",
+                nnz, INT32_MAX);
+        return -1;
     }
-    y_mean /= n;
-    
-    // Calculate standard deviation
-    for (int i = 0; i < n; i++) {
-        y_std += (y[i] - y_mean) * (y[i] - y_mean);
+    if (csr_alloc(local_X, local_n, d, (int)nnz) != 0) {
+        return -1;
     }
-    y_std = sqrt(y_std / n);
     
-    // Add noise proportional to signal standard deviation
-    double noise_level = 0.1 * y_std;
-    for (int i = 0; i < n; i++) {
-        y[i] += noise_level * randn();
+    // Only density of the d features contribute to each row on average
+    double *beta = (double *)malloc(d * sizeof(double));
+    double noise_level = generate_beta_true(beta, d, seed) * sqrt(density);
+    
+    int pos = 0;
+    for (int i = 0; i < local_n; i++) {
+        uint64_t row = (uint64_t)start_row + (uint64_t)i;
+        
+        // 2. Nonzeros of the row, in column order
+        double yi = 0.0;
+        for (int j = 0; j < d; j++) {
+            uint64_t counter = row * (uint64_t)d + (uint64_t)j;
+            if (counter_uniform(seed, STREAM_SPARSE_MASK, counter) > density) {
+                continue;
+            }
+            double x = counter_randn(seed, STREAM_X_U1, STREAM_X_U2, counter);
+            local_X->col_idx[pos] = j;
+            local_X->val[pos] = x;
+            pos++;
+            yi += x * beta[j];
+        }
+        local_X->row_ptr[i + 1] = pos;
+        
+        // 3. y = X * beta_true + noise
+        local_y[i] = yi + noise_level *
+                     counter_randn(seed, STREAM_NOISE_U1, STREAM_NOISE_U2, row);
     }
     
-    printf("[Data] Generated synthetic data: n=%d, d=%d, seed=%u\n", n, d, seed);
-    printf("[Data] True beta range: [%.2f, %.2f]\n", 
-           beta_true[0], beta_true[d-1]);
-    printf("[Data] Signal std: %.4f, Noise level: %.4f (SNR ~20dB)\n", 
-           y_std, noise_level);
+    if (beta_true) {
+        memcpy(beta_true, beta, d * sizeof(double));
+    }
+    free(beta);
+    return 0;
 }
@@ -7,6 +7,18 @@
 #ifndef DATA_H
 #define DATA_H
 
+#include <stdint.h>
+#include "sparse.h"
+
+/*
+ * Counter-based random 64-bit value
+ * 
+ * Depends only on (seed, stream, counter), never on call order, so
+ * any rank or thread can draw any element of a sequence directly.
+ * Streams 1-15 are reserved for data generation.
+ */
+uint64_t counter_random(unsigned int seed, int stream, uint64_t counter);
+
 /*
  * Generate synthetic data for linear regression
  * 
@@ -27,4 +39,93 @@ void generate_synthetic_data(
     unsigned int seed
 );
 
+/*
+ * Generate a contiguous row block of the synthetic dataset
+ * 
+ * Every value is drawn from a counter-based RNG keyed by (seed, global
+ * row index, column), so any rank can produce rows [start_row,
+ * start_row + local_n) on its own. The result is bit-identical to the
+ * same rows of generate_synthetic_data, whatever the partition.
+ * 
+ * Parameters:
+ *   local_X - local_n x d row block (output)
+ *   local_y - local_n x 1 response block (output)
+ *   beta_true - d x 1 true parameters (output, may be NULL)
+ *   d - number of features
+ *   start_row - global index of the first row in the block
+ *   local_n - number of rows in the block
+ *   seed - random seed for reproducibility
+ */
+void generate_synthetic_data_local(
+    double *local_X,
+    double *local_y,
+    double *beta_true,
+    int d,
+    int start_row,
+    int local_n,
+    unsigned int seed
+);
+
+/*
+ * Generate a row block of a multi-target dataset: Y = X * B_true + noise
+ * 
+ * X is the same as from generate_synthetic_data_local, and column 0 of
+ * Y equals its y; every further target has its own coefficients and
+ * noise, drawn from the same counter-based streams.
+ * 
+ * Parameters:
+ *   local_X - local_n x d row block (output)
+ *   local_Y - local_n x k row-major response block (output)
+ *   B_true - d x k row-major true coefficients (output, may be NULL)
+ *   d - number of features
+ *   k - number of targets
+ *   start_row - global index of the first row in the block
+ *   local_n - number of rows in the block
+ *   seed - random seed for reproducibility
+ */
+void generate_synthetic_targets_local(
+    double *local_X,
+    double *local_Y,
+    double *B_true,
+    int d,
+    int k,
+    int start_row,
+    int local_n,
+    unsigned int seed
+);
+
+/*
+ * Generate a row block of a sparse synthetic dataset in CSR form
+ * 
+ * Each entry of X is nonzero with probability density, decided by its
+ * own counter-based draw, and then takes the same N(0,1) value as in
+ * generate_synthetic_data_local; y = X * beta_true + noise with the
+ * noise scaled to the sparser signal. Rows are independent of the
+ * partition, like the dense generator.
+ * 
+ * Parameters:
+ *   local_X - local_n x d CSR block (output, allocated; csr_free it)
+ *   local_y - local_n x 1 response block (output)
+ *   beta_true - d x 1 true parameters (output, may be NULL)
+ *   d - number of features
+ *   density - expected fraction of nonzeros, in (0, 1]
+ *   start_row - global index of the first row in the block
+ *   local_n - number of rows in the block
+ *   seed - random seed for reproducibility
+ * 
+ * Returns:
+ *   0 on success, -1 if allocation failed or the block would hold more
+ *   than INT32_MAX nonzeros
+ */
+int generate_synthetic_sparse_local(
+    csr_matrix_t *local_X,
+    double *local_y,
+    double *beta_true,
+    int d,
+    double density,
+    int start_row,
+    int local_n,
+    unsigned int seed
+);
+
 #endif // DATA_H
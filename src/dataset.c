@@ -0,0 +1,822 @@
+/*
+ * dataset.c - Binary dataset file format implementation
+ */
+
+#define _DEFAULT_SOURCE  // mmap/madvise flags under -std=c99
+
+#include "dataset.h"
+#include "utils.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <string.h>
+#include <stdio.h>
+
+static const char DATASET_MAGIC[8] = "PLRDATA";
+
+/*
+ * On-disk header, padded to DATASET_HEADER_SIZE bytes
+ */
+typedef struct {
+    char magic[8];
+    int64_t n;
+    int64_t d;
+    int32_t dtype;
+    int32_t layout;
+    int64_t nnz;
+    char reserved[DATASET_HEADER_SIZE - 40];
+} dataset_file_header_t;
+
+/*
+ * Size in bytes of one X element
+ */
+static size_t x_elem_size(int dtype) {
+    return (dtype == DATASET_DTYPE_FLOAT32) ? sizeof(float) : sizeof(double);
+}
+
+static MPI_Datatype x_mpi_type(int dtype) {
+    return (dtype == DATASET_DTYPE_FLOAT32) ? MPI_FLOAT : MPI_DOUBLE;
+}
+
+/*
+ * Byte offsets of row start_row in the X and y sections
+ */
+static MPI_Offset x_offset(int d, int start_row, int dtype) {
+    return DATASET_HEADER_SIZE + (MPI_Offset)start_row * d * x_elem_size(dtype);
+}
+
+static MPI_Offset y_offset(int n, int d, int start_row, int dtype) {
+    return DATASET_HEADER_SIZE + (MPI_Offset)n * d * x_elem_size(dtype)
+           + (MPI_Offset)start_row * sizeof(double);
+}
+
+/*
+ * Bytes a file with this header must hold: header, X and y (CSR X is
+ * n + 1 int64 offsets, nnz int32 columns and nnz float64 values)
+ */
+static MPI_Offset dataset_file_size(const dataset_file_header_t *header) {
+    MPI_Offset x_bytes;
+    if (header->layout == DATASET_LAYOUT_CSR) {
+        x_bytes = (MPI_Offset)(header->n + 1) * sizeof(int64_t)
+                  + (MPI_Offset)header->nnz * (sizeof(int32_t) + sizeof(double));
+    } else {
+        x_bytes = (MPI_Offset)header->n * header->d * x_elem_size(header->dtype);
+    }
+    return DATASET_HEADER_SIZE + x_bytes + (MPI_Offset)header->n * sizeof(double);
+}
+
+/*
+ * Check that a read completed in full: count elements of type
+ */
+static int read_complete(int err, MPI_Status *status, MPI_Datatype type, int count) {
+    int got = 0;
+    if (err != MPI_SUCCESS || MPI_Get_count(status, type, &got) != MPI_SUCCESS) {
+        return 0;
+    }
+    return got == count;
+}
+
+int dataset_read_header(const char *path, dataset_header_t *header, MPI_Comm comm) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    
+    // Header values plus status, broadcast together
+    long long info[6] = {0, 0, 0, 0, 0, -1};
+    
+    if (rank == 0) {
+        MPI_File fh;
+        if (MPI_File_open(MPI_COMM_SELF, path, MPI_MODE_RDONLY,
+                          MPI_INFO_NULL, &fh) != MPI_SUCCESS) {
+            fprintf(stderr, "Error: Cannot open dataset file '%s'\n", path);
+        } else {
+            dataset_file_header_t fh_header;
+            MPI_Status status;
+            int count = 0;
+            MPI_Offset file_size = 0;
+            MPI_File_read_at(fh, 0, &fh_header, sizeof(fh_header), MPI_BYTE, &status);
+            MPI_Get_count(&status, MPI_BYTE, &count);
+            MPI_File_get_size(fh, &file_size);
+            MPI_File_close(&fh);
+            
+            if (count != (int)sizeof(fh_header) ||
+                memcmp(fh_header.magic, DATASET_MAGIC, sizeof(DATASET_MAGIC)) != 0) {
+                fprintf(stderr, "Error: '%s' is not a dataset file\n", path);
+            } else if (fh_header.n <= 0 || fh_header.n > INT32_MAX ||
+                       fh_header.d <= 0 || fh_header.d > INT32_MAX) {
+                fprintf(stderr, "Error: Invalid dataset size n=%lld, d=%lld\n",
+                        (long long)fh_header.n, (long long)fh_header.d);
+            } else if (fh_header.layout == DATASET_LAYOUT_CSR &&
+                       (fh_header.nnz < 0 || fh_header.nnz > fh_header.n * fh_header.d)) {
+                fprintf(stderr, "Error: Invalid CSR dataset nnz=%lld\n",
+                        (long long)fh_header.nnz);
+            } else if (file_size < dataset_file_size(&fh_header)) {
+                fprintf(stderr, "Error: Dataset file '%s' is truncated (%lld of %lld bytes)\n",
+                        path, (long long)file_size,
+                        (long long)dataset_file_size(&fh_header));
+            } else {
+                info[0] = fh_header.n;
+                info[1] = fh_header.d;
+                info[2] = fh_header.dtype;
+                info[3] = fh_header.layout;
+                info[4] = (fh_header.layout == DATASET_LAYOUT_CSR) ? fh_header.nnz : 0;
+                info[5] = 0;
+            }
+        }
+    }
+    
+    MPI_Bcast(info, 6, MPI_LONG_LONG, 0, comm);
+    header->n = (int)info[0];
+    header->d = (int)info[1];
+    header->dtype = (int)info[2];
+    header->layout = (int)info[3];
+    header->nnz = info[4];
+    return (int)info[5];
+}
+
+/*
+ * Collective read of a row range; X must have the file's element type
+ */
+static int read_local_any(
+    const char *path,
+    const dataset_header_t *header,
+    void *local_X,
+    int x_dtype,
+    double *local_y,
+    int start_row,
+    int local_n,
+    MPI_Comm comm
+) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    
+    if (header->dtype != x_dtype ||
+        header->layout != DATASET_LAYOUT_ROW_MAJOR) {
+        if (rank == 0) {
+            fprintf(stderr, "Error: Unsupported dataset dtype %d / layout %d\n",
+                    header->dtype, header->layout);
+        }
+        return -1;
+    }
+    
+    MPI_File fh;
+    if (MPI_File_open(comm, path, MPI_MODE_RDONLY, MPI_INFO_NULL, &fh) != MPI_SUCCESS) {
+        if (rank == 0) fprintf(stderr, "Error: Cannot open dataset file '%s'\n", path);
+        return -1;
+    }
+    
+    // Read whole rows so the element count stays within int range
+    MPI_Datatype row_type;
+    MPI_Type_contiguous(header->d, x_mpi_type(x_dtype), &row_type);
+    MPI_Type_commit(&row_type);
+    
+    // A short read (file shrunk since the header was checked) is an error
+    MPI_Status status;
+    int err = MPI_File_read_at_all(fh, x_offset(header->d, start_row, x_dtype),
+                                   local_X, local_n, row_type, &status);
+    int local_ok = read_complete(err, &status, row_type, local_n);
+    err = MPI_File_read_at_all(fh, y_offset(header->n, header->d, start_row, x_dtype),
+                               local_y, local_n, MPI_DOUBLE, &status);
+    local_ok = local_ok && read_complete(err, &status, MPI_DOUBLE, local_n);
+    
+    MPI_Type_free(&row_type);
+    MPI_File_close(&fh);
+    
+    int all_ok;
+    MPI_Allreduce(&local_ok, &all_ok, 1, MPI_INT, MPI_LAND, comm);
+    if (!all_ok) {
+        if (rank == 0) fprintf(stderr, "Error: Failed to read dataset file '%s'\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+int dataset_read_local(
+    const char *path,
+    const dataset_header_t *header,
+    double *local_X,
+    double *local_y,
+    int start_row,
+    int local_n,
+    MPI_Comm comm
+) {
+    return read_local_any(path, header, local_X, DATASET_DTYPE_FLOAT64,
+                          local_y, start_row, local_n, comm);
+}
+
+int dataset_read_local_f32(
+    const char *path,
+    const dataset_header_t *header,
+    float *local_X,
+    double *local_y,
+    int start_row,
+    int local_n,
+    MPI_Comm comm
+) {
+    return read_local_any(path, header, local_X, DATASET_DTYPE_FLOAT32,
+                          local_y, start_row, local_n, comm);
+}
+
+/*
+ * Collective write of per-rank row blocks with X of type x_dtype
+ */
+static int write_local_any(
+    const char *path,
+    int n,
+    int d,
+    const void *local_X,
+    int x_dtype,
+    const double *local_y,
+    int start_row,
+    int local_n,
+    MPI_Comm comm
+) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    
+    MPI_File fh;
+    if (MPI_File_open(comm, path, MPI_MODE_CREATE | MPI_MODE_WRONLY,
+                      MPI_INFO_NULL, &fh) != MPI_SUCCESS) {
+        if (rank == 0) fprintf(stderr, "Error: Cannot create dataset file '%s'\n", path);
+        return -1;
+    }
+    
+    // Drop any previous contents so the file size matches the new dataset
+    MPI_File_set_size(fh, 0);
+    
+    int err = MPI_SUCCESS;
+    if (rank == 0) {
+        dataset_file_header_t fh_header;
+        memset(&fh_header, 0, sizeof(fh_header));
+        memcpy(fh_header.magic, DATASET_MAGIC, sizeof(DATASET_MAGIC));
+        fh_header.n = n;
+        fh_header.d = d;
+        fh_header.dtype = x_dtype;
+        fh_header.layout = DATASET_LAYOUT_ROW_MAJOR;
+        err |= MPI_File_write_at(fh, 0, &fh_header, sizeof(fh_header),
+                                 MPI_BYTE, MPI_STATUS_IGNORE);
+    }
+    
+    MPI_Datatype row_type;
+    MPI_Type_contiguous(d, x_mpi_type(x_dtype), &row_type);
+    MPI_Type_commit(&row_type);
+    
+    err |= MPI_File_write_at_all(fh, x_offset(d, start_row, x_dtype),
+                                 local_X, local_n, row_type, MPI_STATUS_IGNORE);
+    err |= MPI_File_write_at_all(fh, y_offset(n, d, start_row, x_dtype),
+                                 local_y, local_n, MPI_DOUBLE, MPI_STATUS_IGNORE);
+    
+    MPI_Type_free(&row_type);
+    MPI_File_close(&fh);
+    
+    int local_ok = (err == MPI_SUCCESS);
+    int all_ok;
+    MPI_Allreduce(&local_ok, &all_ok, 1, MPI_INT, MPI_LAND, comm);
+    if (!all_ok) {
+        if (rank == 0) fprintf(stderr, "Error: Failed to write dataset file '%s'\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+int dataset_write_local(
+    const char *path,
+    int n,
+    int d,
+    const double *local_X,
+    const double *local_y,
+    int start_row,
+    int local_n,
+    MPI_Comm comm
+) {
+    return write_local_any(path, n, d, local_X, DATASET_DTYPE_FLOAT64,
+                           local_y, start_row, local_n, comm);
+}
+
+int dataset_write_local_f32(
+    const char *path,
+    int n,
+    int d,
+    const float *local_X,
+    const double *local_y,
+    int start_row,
+    int local_n,
+    MPI_Comm comm
+) {
+    return write_local_any(path, n, d, local_X, DATASET_DTYPE_FLOAT32,
+                           local_y, start_row, local_n, comm);
+}
+
+/*
+ * Scatter rank 0's rows with X of type x_dtype
+ */
+static void scatter_any(
+    const void *X,
+    int x_dtype,
+    const double *y,
+    int n,
+    int d,
+    int k,
+    void *local_X,
+    double *local_y,
+    MPI_Comm comm
+) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    
+    int local_n, start_row;
+    get_row_partition(n, rank, size, &local_n, &start_row);
+    
+    // Counts are in rows, so n * d may exceed INT_MAX
+    int *counts = NULL;
+    int *displs = NULL;
+    if (rank == 0) {
+        counts = (int *)malloc(size * sizeof(int));
+        displs = (int *)malloc(size * sizeof(int));
+        for (int p = 0; p < size; p++) {
+            get_row_partition(n, p, size, &counts[p], &displs[p]);
+        }
+    }
+    
+    MPI_Datatype row_type, y_type;
+    MPI_Type_contiguous(d, x_mpi_type(x_dtype), &row_type);
+    MPI_Type_commit(&row_type);
+    MPI_Type_contiguous(k, MPI_DOUBLE, &y_type);
+    MPI_Type_commit(&y_type);
+    
+    MPI_Scatterv(X, counts, displs, row_type,
+                 local_X, local_n, row_type, 0, comm);
+    MPI_Scatterv(y, counts, displs, y_type,
+                 local_y, local_n, y_type, 0, comm);
+    
+    MPI_Type_free(&row_type);
+    MPI_Type_free(&y_type);
+    free(counts);
+    free(displs);
+}
+
+void dataset_scatter(
+    const double *X,
+    const double *y,
+    int n,
+    int d,
+    double *local_X,
+    double *local_y,
+    MPI_Comm comm
+) {
+    scatter_any(X, DATASET_DTYPE_FLOAT64, y, n, d, 1, local_X, local_y, comm);
+}
+
+void dataset_scatter_f32(
+    const float *X,
+    const double *y,
+    int n,
+    int d,
+    float *local_X,
+    double *local_y,
+    MPI_Comm comm
+) {
+    scatter_any(X, DATASET_DTYPE_FLOAT32, y, n, d, 1, local_X, local_y, comm);
+}
+
+void dataset_scatter_multi(
+    const double *X,
+    const double *Y,
+    int n,
+    int d,
+    int k,
+    double *local_X,
+    double *local_Y,
+    MPI_Comm comm
+) {
+    scatter_any(X, DATASET_DTYPE_FLOAT64, Y, n, d, k, local_X, local_Y, comm);
+}
+
+/*
+ * Byte offsets of the CSR sections: row offset of row, nonzero nz of
+ * col_idx and val, response of row
+ */
+static MPI_Offset csr_row_ptr_offset(int row) {
+    return DATASET_HEADER_SIZE + (MPI_Offset)row * sizeof(int64_t);
+}
+
+static MPI_Offset csr_col_offset(int n, long long nz) {
+    return csr_row_ptr_offset(n + 1) + (MPI_Offset)nz * sizeof(int32_t);
+}
+
+static MPI_Offset csr_val_offset(int n, long long nnz, long long nz) {
+    return csr_col_offset(n, nnz) + (MPI_Offset)nz * sizeof(double);
+}
+
+static MPI_Offset csr_y_offset(int n, long long nnz, int row) {
+    return csr_val_offset(n, nnz, nnz) + (MPI_Offset)row * sizeof(double);
+}
+
+/*
+ * Check that every row has strictly increasing columns in [0, d)
+ */
+static int csr_columns_valid(const csr_matrix_t *X) {
+    for (int i = 0; i < X->rows; i++) {
+        int prev = -1;
+        for (int p = X->row_ptr[i]; p < X->row_ptr[i + 1]; p++) {
+            if (X->col_idx[p] <= prev || X->col_idx[p] >= X->d) {
+                return 0;
+            }
+            prev = X->col_idx[p];
+        }
+    }
+    return 1;
+}
+
+int dataset_scatter_csr(
+    const csr_matrix_t *X,
+    const double *y,
+    int d,
+    csr_matrix_t *local_X,
+    double **local_y,
+    int *start_row,
+    MPI_Comm comm
+) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    
+    // Step 1: rank 0 splits the rows by nonzeros; every rank gets its
+    // {first row, rows, first nonzero, nonzeros}
+    int *blocks = NULL;
+    if (rank == 0) {
+        blocks = (int *)malloc(4 * size * sizeof(int));
+        for (int p = 0; p < size; p++) {
+            int p_rows, p_start;
+            csr_row_partition(X->row_ptr, X->rows, p, size, &p_rows, &p_start);
+            blocks[4 * p] = p_start;
+            blocks[4 * p + 1] = p_rows;
+            blocks[4 * p + 2] = X->row_ptr[p_start];
+            blocks[4 * p + 3] = X->row_ptr[p_start + p_rows] - X->row_ptr[p_start];
+        }
+    }
+    int mine[4];
+    MPI_Scatter(blocks, 4, MPI_INT, mine, 4, MPI_INT, 0, comm);
+    *start_row = mine[0];
+    int local_n = mine[1];
+    int local_nnz = mine[3];
+    
+    // Step 2: allocate the local block
+    int local_ok = (csr_alloc(local_X, local_n, d, local_nnz) == 0);
+    *local_y = (double *)malloc((local_n > 0 ? (size_t)local_n : 1) * sizeof(double));
+    local_ok = local_ok && *local_y;
+    int all_ok;
+    MPI_Allreduce(&local_ok, &all_ok, 1, MPI_INT, MPI_LAND, comm);
+    if (!all_ok) {
+        if (rank == 0) fprintf(stderr, "Error: Memory allocation failed in CSR scatter\n");
+        csr_free(local_X);
+        free(*local_y);
+        *local_y = NULL;
+        free(blocks);
+        return -1;
+    }
+    
+    // Step 3: scatter offsets and responses by rows, indices and values
+    // by nonzeros
+    int *row_counts = NULL;
+    int *row_displs = NULL;
+    int *nz_counts = NULL;
+    int *nz_displs = NULL;
+    if (rank == 0) {
+        row_counts = (int *)malloc(size * sizeof(int));
+        row_displs = (int *)malloc(size * sizeof(int));
+        nz_counts = (int *)malloc(size * sizeof(int));
+        nz_displs = (int *)malloc(size * sizeof(int));
+        for (int p = 0; p < size; p++) {
+            row_displs[p] = blocks[4 * p];
+            row_counts[p] = blocks[4 * p + 1];
+            nz_displs[p] = blocks[4 * p + 2];
+            nz_counts[p] = blocks[4 * p + 3];
+        }
+    }
+    MPI_Scatterv(rank == 0 ? X->row_ptr : NULL, row_counts, row_displs, MPI_INT,
+                 local_X->row_ptr, local_n, MPI_INT, 0, comm);
+    MPI_Scatterv(rank == 0 ? X->col_idx : NULL, nz_counts, nz_displs, MPI_INT,
+                 local_X->col_idx, local_nnz, MPI_INT, 0, comm);
+    MPI_Scatterv(rank == 0 ? X->val : NULL, nz_counts, nz_displs, MPI_DOUBLE,
+                 local_X->val, local_nnz, MPI_DOUBLE, 0, comm);
+    MPI_Scatterv(y, row_counts, row_displs, MPI_DOUBLE,
+                 *local_y, local_n, MPI_DOUBLE, 0, comm);
+    
+    // Step 4: offsets relative to the local nonzeros
+    for (int i = 0; i < local_n; i++) {
+        local_X->row_ptr[i] -= mine[2];
+    }
+    local_X->row_ptr[local_n] = local_nnz;
+    
+    free(blocks);
+    free(row_counts);
+    free(row_displs);
+    free(nz_counts);
+    free(nz_displs);
+    return 0;
+}
+
+int dataset_read_csr_local(
+    const char *path,
+    const dataset_header_t *header,
+    csr_matrix_t *local_X,
+    double **local_y,
+    int *start_row,
+    MPI_Comm comm
+) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    memset(local_X, 0, sizeof(*local_X));
+    *local_y = NULL;
+    
+    if (header->dtype != DATASET_DTYPE_FLOAT64 ||
+        header->layout != DATASET_LAYOUT_CSR) {
+        if (rank == 0) {
+            fprintf(stderr, "Error: Unsupported dataset dtype %d / layout %d\n",
+                    header->dtype, header->layout);
+        }
+        return -1;
+    }
+    int n = header->n;
+    int d = header->d;
+    long long nnz = header->nnz;
+    
+    MPI_File fh;
+    if (MPI_File_open(comm, path, MPI_MODE_RDONLY, MPI_INFO_NULL, &fh) != MPI_SUCCESS) {
+        if (rank == 0) fprintf(stderr, "Error: Cannot open dataset file '%s'\n", path);
+        return -1;
+    }
+    
+    // Step 1: rank 0 reads and checks all row offsets, then picks every
+    // rank's nonzero-balanced row range; each range must fit the int
+    // offsets of a csr_matrix_t
+    int *blocks = NULL;
+    int valid = 0;
+    if (rank == 0) {
+        int64_t *offsets = (int64_t *)malloc(((size_t)n + 1) * sizeof(int64_t));
+        blocks = (int *)malloc(2 * size * sizeof(int));
+        MPI_Status status;
+        if (offsets && blocks &&
+            read_complete(MPI_File_read_at(fh, csr_row_ptr_offset(0), offsets, n + 1,
+                                           MPI_INT64_T, &status),
+                          &status, MPI_INT64_T, n + 1)) {
+            valid = (offsets[0] == 0 && offsets[n] == nnz);
+            for (int i = 0; i < n && valid; i++) {
+                valid = (offsets[i + 1] >= offsets[i]);
+            }
+        }
+        if (valid) {
+            for (int p = 0; p < size && valid; p++) {
+                csr_row_partition64(offsets, n, p, size, &blocks[2 * p + 1], &blocks[2 * p]);
+                int64_t block_nnz = offsets[blocks[2 * p] + blocks[2 * p + 1]] -
+                                    offsets[blocks[2 * p]];
+                if (block_nnz > INT32_MAX) {
+                    fprintf(stderr, "Error: Rank %d would hold %lld nonzeros of '%s' "
+                                    "(at most %d per rank)\n",
+                            p, (long long)block_nnz, path, INT32_MAX);
+                    valid = 0;
+                }
+            }
+        } else {
+            fprintf(stderr, "Error: Invalid CSR row offsets in '%s'\n", path);
+        }
+        free(offsets);
+    }
+    MPI_Bcast(&valid, 1, MPI_INT, 0, comm);
+    if (!valid) {
+        free(blocks);
+        MPI_File_close(&fh);
+        return -1;
+    }
+    int mine[2];
+    MPI_Scatter(blocks, 2, MPI_INT, mine, 2, MPI_INT, 0, comm);
+    free(blocks);
+    *start_row = mine[0];
+    int local_n = mine[1];
+    
+    // Step 2: each rank reads its own offsets, then its nonzeros and
+    // responses (counts drop to 0 on a failed allocation, so every rank
+    // still joins the collective reads)
+    int64_t *offsets = (int64_t *)malloc(((size_t)local_n + 1) * sizeof(int64_t));
+    MPI_Status status;
+    int err = MPI_File_read_at_all(fh, csr_row_ptr_offset(*start_row), offsets,
+                                   offsets ? local_n + 1 : 0, MPI_INT64_T, &status);
+    int local_ok = (offsets != NULL) &&
+                   read_complete(err, &status, MPI_INT64_T, local_n + 1);
+    int64_t first = local_ok ? offsets[0] : 0;
+    int local_nnz = local_ok ? (int)(offsets[local_n] - first) : 0;
+    local_ok = local_ok && csr_alloc(local_X, local_n, d, local_nnz) == 0;
+    *local_y = (double *)malloc((local_n > 0 ? (size_t)local_n : 1) * sizeof(double));
+    local_ok = local_ok && *local_y;
+    if (!local_ok) {
+        local_n = 0;
+        local_nnz = 0;
+    }
+    
+    int reads_ok = 1;
+    err = MPI_File_read_at_all(fh, csr_col_offset(n, first), local_X->col_idx,
+                               local_nnz, MPI_INT, &status);
+    reads_ok = reads_ok && read_complete(err, &status, MPI_INT, local_nnz);
+    err = MPI_File_read_at_all(fh, csr_val_offset(n, nnz, first), local_X->val,
+                               local_nnz, MPI_DOUBLE, &status);
+    reads_ok = reads_ok && read_complete(err, &status, MPI_DOUBLE, local_nnz);
+    err = MPI_File_read_at_all(fh, csr_y_offset(n, nnz, *start_row), *local_y,
+                               local_n, MPI_DOUBLE, &status);
+    reads_ok = reads_ok && read_complete(err, &status, MPI_DOUBLE, local_n);
+    MPI_File_close(&fh);
+    
+    if (local_ok) {
+        for (int i = 0; i <= local_n; i++) {
+            local_X->row_ptr[i] = (int)(offsets[i] - first);
+        }
+        local_ok = reads_ok && csr_columns_valid(local_X);
+    }
+    free(offsets);
+    
+    int all_ok;
+    MPI_Allreduce(&local_ok, &all_ok, 1, MPI_INT, MPI_LAND, comm);
+    if (!all_ok) {
+        if (rank == 0) fprintf(stderr, "Error: Failed to read CSR dataset file '%s'\n", path);
+        csr_free(local_X);
+        free(*local_y);
+        *local_y = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+int dataset_write_csr_local(
+    const char *path,
+    int n,
+    int d,
+    const csr_matrix_t *local_X,
+    const double *local_y,
+    int start_row,
+    MPI_Comm comm
+) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    
+    // Blocks are in rank order, so a rank's first nonzero is the number
+    // held by the ranks before it
+    int local_n = local_X->rows;
+    long long local_nnz = csr_nnz(local_X);
+    long long nz_before = 0;
+    long long nnz = 0;
+    MPI_Exscan(&local_nnz, &nz_before, 1, MPI_LONG_LONG, MPI_SUM, comm);
+    if (rank == 0) {
+        nz_before = 0;
+    }
+    MPI_Allreduce(&local_nnz, &nnz, 1, MPI_LONG_LONG, MPI_SUM, comm);
+    
+    MPI_File fh;
+    if (MPI_File_open(comm, path, MPI_MODE_CREATE | MPI_MODE_WRONLY,
+                      MPI_INFO_NULL, &fh) != MPI_SUCCESS) {
+        if (rank == 0) fprintf(stderr, "Error: Cannot create dataset file '%s'\n", path);
+        return -1;
+    }
+    
+    // Drop any previous contents so the file size matches the new dataset
+    MPI_File_set_size(fh, 0);
+    
+    int err = MPI_SUCCESS;
+    if (rank == 0) {
+        dataset_file_header_t fh_header;
+        memset(&fh_header, 0, sizeof(fh_header));
+        memcpy(fh_header.magic, DATASET_MAGIC, sizeof(DATASET_MAGIC));
+        fh_header.n = n;
+        fh_header.d = d;
+        fh_header.dtype = DATASET_DTYPE_FLOAT64;
+        fh_header.layout = DATASET_LAYOUT_CSR;
+        fh_header.nnz = nnz;
+        err |= MPI_File_write_at(fh, 0, &fh_header, sizeof(fh_header),
+                                 MPI_BYTE, MPI_STATUS_IGNORE);
+        
+        // Closing offset of the last row
+        int64_t end = nnz;
+        err |= MPI_File_write_at(fh, csr_row_ptr_offset(n), &end, 1, MPI_INT64_T,
+                                 MPI_STATUS_IGNORE);
+    }
+    
+    // Global offsets of this block's rows
+    int64_t *offsets = (int64_t *)malloc((local_n > 0 ? (size_t)local_n : 1) * sizeof(int64_t));
+    int first = local_X->row_ptr ? local_X->row_ptr[0] : 0;
+    for (int i = 0; i < local_n; i++) {
+        offsets[i] = nz_before + (local_X->row_ptr[i] - first);
+    }
+    
+    err |= MPI_File_write_at_all(fh, csr_row_ptr_offset(start_row), offsets, local_n,
+                                 MPI_INT64_T, MPI_STATUS_IGNORE);
+    err |= MPI_File_write_at_all(fh, csr_col_offset(n, nz_before),
+                                 local_X->col_idx ? local_X->col_idx + first : NULL,
+                                 (int)local_nnz, MPI_INT, MPI_STATUS_IGNORE);
+    err |= MPI_File_write_at_all(fh, csr_val_offset(n, nnz, nz_before),
+                                 local_X->val ? local_X->val + first : NULL,
+                                 (int)local_nnz, MPI_DOUBLE, MPI_STATUS_IGNORE);
+    err |= MPI_File_write_at_all(fh, csr_y_offset(n, nnz, start_row), local_y, local_n,
+                                 MPI_DOUBLE, MPI_STATUS_IGNORE);
+    
+    free(offsets);
+    MPI_File_close(&fh);
+    
+    int local_ok = (err == MPI_SUCCESS);
+    int all_ok;
+    MPI_Allreduce(&local_ok, &all_ok, 1, MPI_INT, MPI_LAND, comm);
+    if (!all_ok) {
+        if (rank == 0) fprintf(stderr, "Error: Failed to write dataset file '%s'\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * Map byte range [offset, offset + len) of fd, rounding the start down
+ * to a page boundary. Returns a pointer to offset inside the mapping.
+ */
+static const void *map_range(int fd, off_t offset, size_t len,
+                             void **base, size_t *map_len) {
+    long page = sysconf(_SC_PAGESIZE);
+    off_t aligned = offset - offset % page;
+    size_t lead = (size_t)(offset - aligned);
+    
+    void *addr = mmap(NULL, len + lead, PROT_READ, MAP_SHARED, fd, aligned);
+    if (addr == MAP_FAILED) {
+        return NULL;
+    }
+    
+    // The kernels stream rows front to back
+    madvise(addr, len + lead, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+    madvise(addr, len + lead, MADV_HUGEPAGE);
+#endif
+    
+    *base = addr;
+    *map_len = len + lead;
+    return (const char *)addr + lead;
+}
+
+int dataset_map_local(
+    const char *path,
+    const dataset_header_t *header,
+    int start_row,
+    int local_n,
+    dataset_mapping_t *mapping
+) {
+    memset(mapping, 0, sizeof(*mapping));
+    
+    if (header->dtype != DATASET_DTYPE_FLOAT64 ||
+        header->layout != DATASET_LAYOUT_ROW_MAJOR) {
+        fprintf(stderr, "Error: Unsupported dataset dtype %d / layout %d\n",
+                header->dtype, header->layout);
+        return -1;
+    }
+    if (local_n == 0) {
+        return 0;
+    }
+    
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Error: Cannot open dataset file '%s'\n", path);
+        return -1;
+    }
+    
+    // Touching a mapped page past the end of the file raises SIGBUS, so
+    // the file must cover this rank's rows of y (the last section)
+    struct stat st;
+    off_t needed = (off_t)y_offset(header->n, header->d, start_row + local_n, header->dtype);
+    if (fstat(fd, &st) != 0 || st.st_size < needed) {
+        fprintf(stderr, "Error: Dataset file '%s' is truncated\n", path);
+        close(fd);
+        return -1;
+    }
+    
+    mapping->X = (const double *)map_range(
+        fd, (off_t)x_offset(header->d, start_row, header->dtype),
+        (size_t)local_n * header->d * sizeof(double),
+        &mapping->x_base, &mapping->x_len);
+    mapping->y = (const double *)map_range(
+        fd, (off_t)y_offset(header->n, header->d, start_row, header->dtype),
+        (size_t)local_n * sizeof(double),
+        &mapping->y_base, &mapping->y_len);
+    
+    // The mappings keep the file referenced
+    close(fd);
+    
+    if (!mapping->X || !mapping->y) {
+        fprintf(stderr, "Error: Failed to map dataset file '%s'\n", path);
+        dataset_unmap(mapping);
+        return -1;
+    }
+    return 0;
+}
+
+void dataset_unmap(dataset_mapping_t *mapping) {
+    if (mapping->x_base) munmap(mapping->x_base, mapping->x_len);
+    if (mapping->y_base) munmap(mapping->y_base, mapping->y_len);
+    memset(mapping, 0, sizeof(*mapping));
+}
@@ -0,0 +1,295 @@
+/*
+ * dataset.h - Binary dataset file format
+ * 
+ * Layout on disk (native byte order):
+ *   header (64 bytes): magic "PLRDATA\0", int64 n, int64 d,
+ *                      int32 dtype, int32 layout, int64 nnz,
+ *                      24 reserved bytes
+ *   X: n x d values, row-major, float64 or float32 (dtype)
+ *   y: n float64 values
+ * 
+ * CSR files (layout DATASET_LAYOUT_CSR, dtype float64) store X as
+ *   row_ptr: n + 1 int64 offsets, col_idx: nnz int32, val: nnz float64
+ * followed by y as above. nnz may exceed INT32_MAX, but each rank's
+ * row block is held as a csr_matrix_t with int offsets relative to the
+ * block, so no rank may get more than INT32_MAX nonzeros.
+ * 
+ * Files are read and written collectively with MPI-IO; each rank only
+ * touches its own row range.
+ */
+
+#ifndef DATASET_H
+#define DATASET_H
+
+#include <stddef.h>
+#include <mpi.h>
+#include "sparse.h"
+
+#define DATASET_HEADER_SIZE 64
+
+// Element type of X (y is always float64)
+#define DATASET_DTYPE_FLOAT64 0
+#define DATASET_DTYPE_FLOAT32 1
+
+// Storage order of X
+#define DATASET_LAYOUT_ROW_MAJOR 0
+#define DATASET_LAYOUT_CSR       1
+
+typedef struct {
+    int n;          // number of samples
+    int d;          // number of features
+    int dtype;      // DATASET_DTYPE_*
+    int layout;     // DATASET_LAYOUT_*
+    long long nnz;  // nonzeros of X (DATASET_LAYOUT_CSR only)
+} dataset_header_t;
+
+/*
+ * Read-only memory mapping of one rank's row range
+ * 
+ * X and y point straight into the page cache; they stay valid until
+ * dataset_unmap is called.
+ */
+typedef struct {
+    const double *X;   // local_n x d row block
+    const double *y;   // local_n x 1 response block
+    void *x_base;      // page-aligned start of the X mapping
+    size_t x_len;
+    void *y_base;      // page-aligned start of the y mapping
+    size_t y_len;
+} dataset_mapping_t;
+
+/*
+ * Read and validate the header of a dataset file
+ * 
+ * Rank 0 reads the header and broadcasts it, so every rank in comm
+ * receives the same header and the same return value.
+ * 
+ * Returns:
+ *   0 on success, -1 if the file cannot be opened, is not a dataset
+ *   or is shorter than its header implies
+ */
+int dataset_read_header(const char *path, dataset_header_t *header, MPI_Comm comm);
+
+/*
+ * Collectively read rows [start_row, start_row + local_n) of X and y
+ * 
+ * Parameters:
+ *   path - dataset file
+ *   header - header returned by dataset_read_header
+ *   local_X - local_n x d row block (output)
+ *   local_y - local_n x 1 response block (output)
+ *   start_row - global index of the first row to read
+ *   local_n - number of rows to read (may be 0)
+ *   comm - MPI communicator (all ranks must call)
+ * 
+ * Returns:
+ *   0 on success, -1 on I/O error (including a short read) or
+ *   unsupported dtype/layout
+ */
+int dataset_read_local(
+    const char *path,
+    const dataset_header_t *header,
+    double *local_X,
+    double *local_y,
+    int start_row,
+    int local_n,
+    MPI_Comm comm
+);
+
+/*
+ * dataset_read_local for float32 files (DATASET_DTYPE_FLOAT32)
+ */
+int dataset_read_local_f32(
+    const char *path,
+    const dataset_header_t *header,
+    float *local_X,
+    double *local_y,
+    int start_row,
+    int local_n,
+    MPI_Comm comm
+);
+
+/*
+ * Collectively write a dataset of n rows from per-rank row blocks
+ * 
+ * Each rank writes rows [start_row, start_row + local_n); together the
+ * blocks must cover all n rows. A rank holding the full data can pass
+ * local_n = n while the others pass local_n = 0.
+ * 
+ * Returns:
+ *   0 on success, -1 on I/O error
+ */
+int dataset_write_local(
+    const char *path,
+    int n,
+    int d,
+    const double *local_X,
+    const double *local_y,
+    int start_row,
+    int local_n,
+    MPI_Comm comm
+);
+
+/*
+ * dataset_write_local with X stored as float32 (half the file size)
+ */
+int dataset_write_local_f32(
+    const char *path,
+    int n,
+    int d,
+    const float *local_X,
+    const double *local_y,
+    int start_row,
+    int local_n,
+    MPI_Comm comm
+);
+
+/*
+ * Scatter an in-memory dataset held by rank 0 in the standard row
+ * partition (see get_row_partition)
+ * 
+ * Parameters:
+ *   X - n x d data matrix (only on rank 0)
+ *   y - n x 1 response vector (only on rank 0)
+ *   n - total number of samples
+ *   d - number of features
+ *   local_X - local_n x d row block (output)
+ *   local_y - local_n x 1 response block (output)
+ *   comm - MPI communicator (all ranks must call)
+ */
+void dataset_scatter(
+    const double *X,
+    const double *y,
+    int n,
+    int d,
+    double *local_X,
+    double *local_y,
+    MPI_Comm comm
+);
+
+/*
+ * dataset_scatter for float32 X (half the scatter volume)
+ */
+void dataset_scatter_f32(
+    const float *X,
+    const double *y,
+    int n,
+    int d,
+    float *local_X,
+    double *local_y,
+    MPI_Comm comm
+);
+
+/*
+ * dataset_scatter for k response columns (Y is n x k row-major)
+ */
+void dataset_scatter_multi(
+    const double *X,
+    const double *Y,
+    int n,
+    int d,
+    int k,
+    double *local_X,
+    double *local_Y,
+    MPI_Comm comm
+);
+
+/*
+ * Scatter a CSR dataset held by rank 0 in nonzero-balanced row blocks
+ * (see csr_row_partition)
+ * 
+ * Parameters:
+ *   X - n x d CSR matrix (only on rank 0)
+ *   y - n x 1 response vector (only on rank 0)
+ *   d - number of features
+ *   local_X - this rank's row block (output, allocated; csr_free it)
+ *   local_y - local_X->rows x 1 response block (output, malloc'd)
+ *   start_row - global index of the block's first row (output)
+ *   comm - MPI communicator (all ranks must call)
+ * 
+ * Returns:
+ *   0 on success, -1 if allocation failed on any rank
+ */
+int dataset_scatter_csr(
+    const csr_matrix_t *X,
+    const double *y,
+    int d,
+    csr_matrix_t *local_X,
+    double **local_y,
+    int *start_row,
+    MPI_Comm comm
+);
+
+/*
+ * Collectively read a nonzero-balanced row block of a CSR dataset
+ * 
+ * Rank 0 reads the row offsets and picks every rank's row range (see
+ * csr_row_partition); each rank then reads only its own nonzeros and
+ * responses. Column indices are validated.
+ * 
+ * Parameters:
+ *   path - dataset file (DATASET_LAYOUT_CSR)
+ *   header - header returned by dataset_read_header
+ *   local_X - this rank's row block (output, allocated; csr_free it)
+ *   local_y - local_X->rows x 1 response block (output, malloc'd)
+ *   start_row - global index of the block's first row (output)
+ *   comm - MPI communicator (all ranks must call)
+ * 
+ * Returns:
+ *   0 on success, -1 on I/O error or invalid file (same on every rank)
+ */
+int dataset_read_csr_local(
+    const char *path,
+    const dataset_header_t *header,
+    csr_matrix_t *local_X,
+    double **local_y,
+    int *start_row,
+    MPI_Comm comm
+);
+
+/*
+ * Collectively write a CSR dataset of n rows from per-rank row blocks
+ * 
+ * The blocks must be contiguous and in rank order (rank 0's rows
+ * first); a rank holding everything can pass all rows while the others
+ * pass empty blocks.
+ * 
+ * Returns:
+ *   0 on success, -1 on I/O error
+ */
+int dataset_write_csr_local(
+    const char *path,
+    int n,
+    int d,
+    const csr_matrix_t *local_X,
+    const double *local_y,
+    int start_row,
+    MPI_Comm comm
+);
+
+/*
+ * Map rows [start_row, start_row + local_n) of X and y read-only
+ * 
+ * No data is copied: the kernels read the file pages directly, and ranks
+ * on the same node share one copy in the page cache. The mapping is
+ * advised for sequential access and, where supported, huge pages.
+ * This call is local (not collective).
+ * 
+ * Returns:
+ *   0 on success, -1 on error (including a file too short for the
+ *   requested rows) or unsupported dtype/layout
+ */
+int dataset_map_local(
+    const char *path,
+    const dataset_header_t *header,
+    int start_row,
+    int local_n,
+    dataset_mapping_t *mapping
+);
+
+/*
+ * Release a mapping created by dataset_map_local
+ */
+void dataset_unmap(dataset_mapping_t *mapping);
+
+#endif // DATASET_H
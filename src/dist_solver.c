@@ -0,0 +1,239 @@
+/*
+ * dist_solver.c - Distributed Cholesky solver implementation
+ * 
+ * Column block k (columns k*nb .. k*nb+nb-1) lives on rank k % size.
+ * Each rank stores its columns column-major with full length d, of
+ * which only the rows on or below the diagonal are used.
+ */
+
+#include "dist_solver.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdio.h>
+
+#define DIST_NB_MIN 8
+#define DIST_NB_MAX 64
+
+// Relative tolerance for treating a pivot as zero (as in linear_solver.c)
+#define PIVOT_RTOL 1e-13
+
+/*
+ * Block size giving each rank a few column blocks
+ */
+static int dist_block_size(int d, int size) {
+    int nb = (d + 4 * size - 1) / (4 * size);
+    if (nb < DIST_NB_MIN) nb = DIST_NB_MIN;
+    if (nb > DIST_NB_MAX) nb = DIST_NB_MAX;
+    return nb;
+}
+
+int dist_cholesky_solve(
+    const double *local_XtX,
+    const double *local_Xty,
+    double *beta,
+    int d,
+    MPI_Comm comm
+) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    
+    int nb = dist_block_size(d, size);
+    int num_blocks = (d + nb - 1) / nb;
+    
+    // Allocate everything up front (sendbuf alone is d(d+1)/2 doubles)
+    // and fail on every rank together, before the first collective
+    size_t total = (size_t)d * (d + 1) / 2;
+    size_t own = 0;
+    size_t ncols = 0;
+    for (int g = 0; g < d; g++) {
+        if ((g / nb) % size == rank) {
+            own += d - g;
+            ncols++;
+        }
+    }
+    int *local_col = (int *)malloc(d * sizeof(int));
+    int *recvcounts = (int *)calloc(size, sizeof(int));
+    double *sendbuf = (double *)malloc(total * sizeof(double));
+    double *recvbuf = (double *)malloc((own > 0 ? own : 1) * sizeof(double));
+    double *A = (double *)malloc((ncols * d > 0 ? ncols * d : 1) * sizeof(double));
+    double *b = (double *)malloc(d * sizeof(double));
+    double *panel = (double *)malloc(((size_t)nb * d + 1) * sizeof(double));
+    int ok = local_col && recvcounts && sendbuf && recvbuf && A && b && panel;
+    int all_ok;
+    MPI_Allreduce(&ok, &all_ok, 1, MPI_INT, MPI_LAND, comm);
+    if (!all_ok) {
+        if (!ok) {
+            fprintf(stderr, "Error: Memory allocation failed in dist_cholesky_solve\n");
+        }
+        free(local_col);
+        free(recvcounts);
+        free(sendbuf);
+        free(recvbuf);
+        free(A);
+        free(b);
+        free(panel);
+        return -1;
+    }
+    
+    // Local column index of every owned global column
+    int next_col = 0;
+    for (int g = 0; g < d; g++) {
+        local_col[g] = ((g / nb) % size == rank) ? next_col++ : -1;
+    }
+    
+    // Step 1: Pack lower-triangle columns grouped by owner and
+    // reduce-scatter them, so each rank receives only its columns
+    for (int g = 0; g < d; g++) {
+        recvcounts[(g / nb) % size] += d - g;
+    }
+    size_t pos = 0;
+    for (int r = 0; r < size; r++) {
+        for (int k = r; k < num_blocks; k += size) {
+            int k1 = (k * nb + nb < d) ? k * nb + nb : d;
+            for (int g = k * nb; g < k1; g++) {
+                for (int i = g; i < d; i++) {
+                    sendbuf[pos++] = local_XtX[(size_t)i * d + g];
+                }
+            }
+        }
+    }
+    
+    MPI_Reduce_scatter(sendbuf, recvbuf, recvcounts, MPI_DOUBLE, MPI_SUM, comm);
+    free(sendbuf);
+    
+    pos = 0;
+    for (int g = 0; g < d; g++) {
+        if (local_col[g] < 0) continue;
+        double *col = A + (size_t)local_col[g] * d;
+        for (int i = g; i < d; i++) {
+            col[i] = recvbuf[pos++];
+        }
+    }
+    free(recvbuf);
+    
+    // Right-hand side, replicated
+    MPI_Allreduce(local_Xty, b, d, MPI_DOUBLE, MPI_SUM, comm);
+    
+    // Pivot tolerance from the global diagonal
+    double max_diag = 0.0;
+    for (int g = 0; g < d; g++) {
+        if (local_col[g] >= 0) {
+            double v = fabs(A[(size_t)local_col[g] * d + g]);
+            if (v > max_diag) max_diag = v;
+        }
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &max_diag, 1, MPI_DOUBLE, MPI_MAX, comm);
+    double tol = PIVOT_RTOL * d * max_diag;
+    
+    // Step 2: Distributed right-looking Cholesky
+    // The factored panel is broadcast transposed: row p holds column
+    // k0 + p from row k0 down, plus one trailing status slot
+    int status = 0;
+    
+    for (int k = 0; k < num_blocks && status == 0; k++) {
+        int owner = k % size;
+        int k0 = k * nb;
+        int kb = (k0 + nb < d) ? nb : d - k0;
+        int m = d - k0;
+        
+        if (rank == owner) {
+            // Factor diagonal block and panel, column by column
+            int factored = 1;
+            for (int p = 0; p < kb && factored; p++) {
+                int g = k0 + p;
+                double *col_g = A + (size_t)local_col[g] * d;
+                for (int q = 0; q < p; q++) {
+                    const double *col_q = A + (size_t)local_col[k0 + q] * d;
+                    double l = col_q[g];
+                    for (int i = g; i < d; i++) {
+                        col_g[i] -= l * col_q[i];
+                    }
+                }
+                if (!(col_g[g] > tol)) {
+                    factored = 0;
+                    break;
+                }
+                double s = sqrt(col_g[g]);
+                col_g[g] = s;
+                for (int i = g + 1; i < d; i++) {
+                    col_g[i] /= s;
+                }
+            }
+            for (int p = 0; p < kb; p++) {
+                memcpy(panel + (size_t)p * m, A + (size_t)local_col[k0 + p] * d + k0,
+                       m * sizeof(double));
+            }
+            panel[(size_t)kb * m] = factored ? 0.0 : 1.0;
+        }
+        
+        MPI_Bcast(panel, kb * m + 1, MPI_DOUBLE, owner, comm);
+        if (panel[(size_t)kb * m] != 0.0) {
+            status = -1;
+            break;
+        }
+        
+        // Update owned trailing columns: A22 -= L21 * L21^T
+        for (int g = k0 + kb; g < d; g++) {
+            if (local_col[g] < 0) continue;
+            double *col = A + (size_t)local_col[g] * d;
+            for (int p = 0; p < kb; p++) {
+                const double *lp = panel + (size_t)p * m - k0;
+                double l = lp[g];
+                for (int i = g; i < d; i++) {
+                    col[i] -= l * lp[i];
+                }
+            }
+        }
+    }
+    free(panel);
+    
+    if (status == 0) {
+        // Step 3: Forward substitution L * z = b; the owner of each
+        // block updates b below it and broadcasts the new values
+        for (int k = 0; k < num_blocks; k++) {
+            int owner = k % size;
+            int k0 = k * nb;
+            int k1 = (k0 + nb < d) ? k0 + nb : d;
+            if (rank == owner) {
+                for (int g = k0; g < k1; g++) {
+                    const double *col = A + (size_t)local_col[g] * d;
+                    b[g] /= col[g];
+                    double zg = b[g];
+                    for (int i = g + 1; i < d; i++) {
+                        b[i] -= col[i] * zg;
+                    }
+                }
+            }
+            MPI_Bcast(b + k0, d - k0, MPI_DOUBLE, owner, comm);
+        }
+        
+        // Step 4: Back substitution L^T * x = z, last block first; the
+        // owner holds every L entry it needs for its block
+        for (int k = num_blocks - 1; k >= 0; k--) {
+            int owner = k % size;
+            int k0 = k * nb;
+            int k1 = (k0 + nb < d) ? k0 + nb : d;
+            if (rank == owner) {
+                for (int g = k1 - 1; g >= k0; g--) {
+                    const double *col = A + (size_t)local_col[g] * d;
+                    double s = b[g];
+                    for (int i = g + 1; i < d; i++) {
+                        s -= col[i] * b[i];
+                    }
+                    b[g] = s / col[g];
+                }
+            }
+            MPI_Bcast(b + k0, k1 - k0, MPI_DOUBLE, owner, comm);
+        }
+        
+        memcpy(beta, b, d * sizeof(double));
+    }
+    
+    free(A);
+    free(b);
+    free(local_col);
+    free(recvcounts);
+    return status;
+}
@@ -0,0 +1,37 @@
+/*
+ * dist_solver.h - Distributed solve of the normal equations
+ * 
+ * XtX is reduce-scattered into a 1D block-cyclic column distribution,
+ * factorised with a distributed right-looking Cholesky, and solved with
+ * distributed triangular solves, so no rank ever holds the reduced
+ * d x d matrix.
+ */
+
+#ifndef DIST_SOLVER_H
+#define DIST_SOLVER_H
+
+#include <mpi.h>
+
+/*
+ * Solve (sum of local_XtX) * beta = (sum of local_Xty) across ranks
+ * 
+ * Parameters:
+ *   local_XtX - d x d partial XtX of this rank (lower triangle used)
+ *   local_Xty - d x 1 partial Xty of this rank
+ *   beta - d x 1 output parameters (valid on every rank)
+ *   d - number of features
+ *   comm - MPI communicator
+ * 
+ * Returns:
+ *   0 on success, -1 (on every rank) if allocation failed on any rank
+ *   or the reduced matrix is not numerically positive definite
+ */
+int dist_cholesky_solve(
+    const double *local_XtX,
+    const double *local_Xty,
+    double *beta,
+    int d,
+    MPI_Comm comm
+);
+
+#endif // DIST_SOLVER_H
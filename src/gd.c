@@ -3,51 +3,444 @@
  */
 
 #include "gd.h"
+#include "ols.h"
+#include "kernels.h"
+#include "threads.h"
+#include "timing.h"
+#include "utils.h"
+#include "sparse.h"
+#include "workspace.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
-void gd_serial(
-    const double *X,
-    const double *y,
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Message tag of the gradient sum (see sum_gradients_ordered)
+#define GD_SUM_TAG 17
+
+// How gradients are combined across ranks (see gd_set_comm_mode)
+static int gd_comm_mode = GD_COMM_ROOT;
+
+// Where the iterations run (see gd_set_mode)
+static int gd_mode = GD_MODE_AUTO;
+
+void gd_set_comm_mode(int mode) {
+    gd_comm_mode = mode;
+}
+
+void gd_set_mode(int mode) {
+    gd_mode = mode;
+}
+
+int gd_uses_gram_multi(int n, int d, int k, int iterations) {
+    if (gd_mode != GD_MODE_AUTO) {
+        return gd_mode == GD_MODE_GRAM;
+    }
+    // Multiply-add counts: each data-space iteration is one fused pass
+    // over X doing 2k per element (X * B and X^T * R, 2ndk); the Gram
+    // path pays one SYRK (the symmetric half, nd(d+1)/2) plus X^T * Y
+    // (ndk) and then d^2k per iteration
+    double data_cost = 2.0 * n * d * (double)k * iterations;
+    double gram_cost = (double)n * d * (d + 1) / 2.0 + (double)n * d * k +
+                       (double)d * d * k * iterations;
+    return gram_cost < data_cost;
+}
+
+int gd_uses_gram(int n, int d, int iterations) {
+    return gd_uses_gram_multi(n, d, 1, iterations);
+}
+
+/*
+ * gd_uses_gram for CSR row blocks (collective: the cost model needs the
+ * global nonzero counts, and every rank must make the same choice)
+ */
+static int gd_uses_gram_csr(const csr_matrix_t *local_X, int iterations, MPI_Comm comm) {
+    if (gd_mode != GD_MODE_AUTO) {
+        return gd_mode == GD_MODE_GRAM;
+    }
+    // Nonzeros and nonzero pairs (the sparse SYRK work) over all rows
+    double counts[2] = {0.0, 0.0};
+    for (int i = 0; i < local_X->rows; i++) {
+        double row_nnz = local_X->row_ptr[i + 1] - local_X->row_ptr[i];
+        counts[0] += row_nnz;
+        counts[1] += row_nnz * (row_nnz + 1.0) / 2.0;
+    }
+    MPI_Allreduce(MPI_IN_PLACE, counts, 2, MPI_DOUBLE, MPI_SUM, comm);
+    
+    // Multiply-adds: a data-space iteration is one fused pass doing 2 per
+    // nonzero; the Gram path pays the pairs and X^T * y once and then
+    // d^2 per iteration
+    int d = local_X->d;
+    double data_cost = 2.0 * counts[0] * iterations;
+    double gram_cost = counts[1] + counts[0] + (double)d * d * iterations;
+    return gram_cost < data_cost;
+}
+
+/*
+ * Run GD in d-space: gradient = XtX * beta - Xty
+ * 
+ * Same update rule and step size as the data-space loop, at O(d^2 k)
+ * per iteration with no access to X.
+ * 
+ * Parameters:
+ *   XtX - d x d matrix X^T * X (full, symmetric)
+ *   Xty - d x k matrix X^T * Y
+ *   beta - d x k output parameters
+ *   n - number of samples (scales the step)
+ *   d - number of features
+ *   k - number of targets
+ *   iterations - number of iterations
+ *   learning_rate - step size for gradient descent
+ *   scratch - workspace for the gradient, or NULL for a one-off one
+ */
+static void gd_gram_iterate(
+    const double *XtX,
+    const double *Xty,
     double *beta,
     int n,
     int d,
+    int k,
     int iterations,
-    double learning_rate
+    double learning_rate,
+    workspace_t *scratch
 ) {
-    // Temporary arrays
-    double *y_pred = (double *)malloc(n * sizeof(double));
-    double *error = (double *)malloc(n * sizeof(double));
-    double *gradient = (double *)malloc(d * sizeof(double));
+    size_t dk = (size_t)d * k;
+    workspace_t temp;
+    size_t mark;
+    workspace_t *ws = workspace_begin(scratch, &temp, workspace_bytes(dk, sizeof(double)), &mark);
+    workspace_require(ws, "gd_gram_iterate");
+    double *gradient = (double *)workspace_alloc(ws, dk * sizeof(double));
     
     // Initialize beta = 0
-    for (int j = 0; j < d; j++) {
+    for (size_t j = 0; j < dk; j++) {
         beta[j] = 0.0;
     }
     
-    // Iterative optimization
+    double step = learning_rate / n;
     for (int iter = 0; iter < iterations; iter++) {
-        // 1. Compute predictions: y_pred = X * beta
-        for (int i = 0; i < n; i++) {
-            y_pred[i] = 0.0;
-            for (int j = 0; j < d; j++) {
-                y_pred[i] += X[i * d + j] * beta[j];
+        // 1. gradient = XtX * beta - Xty
+        if (k == 1) {
+            for (int i = 0; i < d; i++) {
+                const double *row = XtX + (size_t)i * d;
+                double sum = 0.0;
+                for (int j = 0; j < d; j++) {
+                    sum += row[j] * beta[j];
+                }
+                gradient[i] = sum - Xty[i];
+            }
+        } else {
+            for (int i = 0; i < d; i++) {
+                const double *row = XtX + (size_t)i * d;
+                double *g = gradient + (size_t)i * k;
+                for (int c = 0; c < k; c++) {
+                    g[c] = -Xty[(size_t)i * k + c];
+                }
+                for (int j = 0; j < d; j++) {
+                    const double *b = beta + (size_t)j * k;
+                    for (int c = 0; c < k; c++) {
+                        g[c] += row[j] * b[c];
+                    }
+                }
             }
         }
         
-        // 2. Compute error: error = y_pred - y
-        for (int i = 0; i < n; i++) {
-            error[i] = y_pred[i] - y[i];
+        // 2. Update parameters: beta = beta - (learning_rate / n) * gradient
+        for (size_t j = 0; j < dk; j++) {
+            beta[j] -= step * gradient[j];
         }
-        
-        // 3. Compute gradient: gradient = X^T * error
+    }
+    
+    workspace_end(ws, &temp, mark);
+}
+
+/*
+ * Sum the per-rank gradients over a fixed pairwise tree
+ * 
+ * Ranks past the largest power of two p2 <= size first fold into
+ * rank - p2; the remaining ranks then add partial sums with their
+ * partner at distance 1, 2, 4, ... (to rank 0 only, or exchanging both
+ * ways when to_all is set, after which the folded ranks get the sum
+ * back). The tree depends only on the process count and addition is
+ * commutative, so both modes produce bit-identical sums, which
+ * MPI_Reduce and MPI_Allreduce do not guarantee. Each rank sends and
+ * receives O(d log p) values per call.
+ * 
+ * Parameters:
+ *   gradient - d x 1 local gradient, replaced by the global sum
+ *   partner - d x 1 scratch buffer for the partner's partial sum
+ *   d - number of features
+ *   to_all - 0: only rank 0 gets the sum, 1: every rank does
+ *   comm - MPI communicator
+ */
+static void sum_gradients_ordered(double *gradient, double *partner, int d,
+                                  int to_all, MPI_Comm comm) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    if (size == 1) {
+        return;
+    }
+    int p2 = 1;
+    while (2 * p2 <= size) {
+        p2 *= 2;
+    }
+    
+    // 1. Fold the ranks past p2
+    if (rank >= p2) {
+        MPI_Send(gradient, d, MPI_DOUBLE, rank - p2, GD_SUM_TAG, comm);
+        if (to_all) {
+            MPI_Recv(gradient, d, MPI_DOUBLE, rank - p2, GD_SUM_TAG, comm, MPI_STATUS_IGNORE);
+        }
+        return;
+    }
+    if (rank + p2 < size) {
+        MPI_Recv(partner, d, MPI_DOUBLE, rank + p2, GD_SUM_TAG, comm, MPI_STATUS_IGNORE);
         for (int j = 0; j < d; j++) {
-            gradient[j] = 0.0;
-            for (int i = 0; i < n; i++) {
-                gradient[j] += X[i * d + j] * error[i];
-            }
+            gradient[j] += partner[j];
+        }
+    }
+    
+    // 2. Pairwise sums at distance 1, 2, 4, ...
+    for (int s = 1; s < p2; s *= 2) {
+        int peer = rank ^ s;
+        if (to_all) {
+            MPI_Sendrecv(gradient, d, MPI_DOUBLE, peer, GD_SUM_TAG,
+                         partner, d, MPI_DOUBLE, peer, GD_SUM_TAG, comm, MPI_STATUS_IGNORE);
+        } else if (rank & s) {
+            MPI_Send(gradient, d, MPI_DOUBLE, peer, GD_SUM_TAG, comm);
+            return;
+        } else {
+            MPI_Recv(partner, d, MPI_DOUBLE, peer, GD_SUM_TAG, comm, MPI_STATUS_IGNORE);
         }
+        for (int j = 0; j < d; j++) {
+            gradient[j] += partner[j];
+        }
+    }
+    
+    // 3. Hand the sum back to the folded rank
+    if (to_all && rank + p2 < size) {
+        MPI_Send(gradient, d, MPI_DOUBLE, rank + p2, GD_SUM_TAG, comm);
+    }
+}
+
+/*
+ * Number of threads used for a gradient over the given number of rows
+ */
+static int gradient_threads(int rows) {
+    return get_row_threads(rows, ROW_MIN_ROWS_PER_THREAD);
+}
+
+/*
+ * Doubles of per-thread kernel scratch gradient_block needs for X
+ * (widened float32 rows, or one row's residuals for k > 1 targets),
+ * 0 if none
+ */
+static size_t gradient_scratch_len(x_kind_t x_kind, int d, int k) {
+    if (k > 1) {
+        return k;
+    }
+    return (x_kind == X_DENSE_F32) ? gd_gradient_fused_f32_scratch(d) : 0;
+}
+
+/*
+ * Scratch bytes taken by gradient_buffers
+ */
+static size_t gradient_buffers_bytes(int num_threads, size_t len, size_t scratch_len) {
+    size_t bytes = workspace_bytes(2 * (size_t)num_threads, sizeof(double *)) +
+                   (num_threads - 1) * workspace_bytes(len, sizeof(double));
+    if (scratch_len > 0) {
+        bytes += num_threads * workspace_bytes(scratch_len, sizeof(double));
+    }
+    return bytes;
+}
+
+/*
+ * Per-thread gradient buffers carved from ws: bufs[0] is the result,
+ * the others are private to their threads (64-byte aligned, so never
+ * sharing a cache line) and first touched by them in compute_gradient.
+ * bufs[num_threads + t] is thread t's kernel scratch of scratch_len
+ * doubles (NULL if scratch_len is 0).
+ */
+static double **gradient_buffers(workspace_t *ws, double *gradient, int num_threads,
+                                 size_t len, size_t scratch_len) {
+    double **bufs = (double **)workspace_alloc(ws, 2 * (size_t)num_threads * sizeof(double *));
+    bufs[0] = gradient;
+    for (int t = 1; t < num_threads; t++) {
+        bufs[t] = (double *)workspace_alloc(ws, len * sizeof(double));
+    }
+    for (int t = 0; t < num_threads; t++) {
+        bufs[num_threads + t] = (scratch_len > 0) ?
+            (double *)workspace_alloc(ws, scratch_len * sizeof(double)) : NULL;
+    }
+    return bufs;
+}
+
+/*
+ * grad += gradient of rows [start, start + rows) of a float64 or
+ * float32 (X_DENSE_F64/X_DENSE_F32) block or a CSR matrix (X_CSR);
+ * k > 1 targets need dense float64 X. scratch holds
+ * gradient_scratch_len doubles.
+ */
+static void gradient_block(
+    const void *X,
+    x_kind_t x_kind,
+    const double *y,
+    const double *beta,
+    int start,
+    int rows,
+    int d,
+    int k,
+    double *grad,
+    double *scratch
+) {
+    const double *y_block = y ? y + (size_t)start * k : NULL;
+    if (x_kind == X_CSR) {
+        const csr_matrix_t *Xs = (const csr_matrix_t *)X;
+        csr_gradient_fused(Xs->row_ptr + start, Xs->col_idx, Xs->val, y_block,
+                           beta, rows, grad);
+    } else if (k > 1) {
+        gd_gradient_fused_multi((const double *)X + (size_t)start * d, y_block,
+                                beta, rows, d, k, grad, scratch);
+    } else if (x_kind == X_DENSE_F32) {
+        gd_gradient_fused_f32((const float *)X + (size_t)start * d, y_block,
+                              beta, rows, d, grad, scratch);
+    } else {
+        gd_gradient_fused((const double *)X + (size_t)start * d, y_block,
+                          beta, rows, d, grad);
+    }
+}
+
+/*
+ * bufs[0] = X^T * (X * beta - y), with the rows split across threads
+ * and the per-thread partial gradients tree-reduced (d x k values);
+ * bufs comes from gradient_buffers for num_threads, of which the
+ * granted team uses the first omp_get_num_threads()
+ */
+static void compute_gradient(
+    const void *X,
+    x_kind_t x_kind,
+    const double *y,
+    const double *beta,
+    int rows,
+    int d,
+    int k,
+    double **bufs,
+    int num_threads
+) {
+    size_t dk = (size_t)d * k;
+    if (num_threads == 1) {
+        memset(bufs[0], 0, dk * sizeof(double));
+        gradient_block(X, x_kind, y, beta, 0, rows, d, k, bufs[0], bufs[num_threads]);
+        return;
+    }
+    
+#ifdef _OPENMP
+    #pragma omp parallel num_threads(num_threads)
+    {
+        // The team may be smaller than requested (e.g. OMP_THREAD_LIMIT):
+        // split the rows over the threads actually granted
+        int tid = omp_get_thread_num();
+        int nt = omp_get_num_threads();
+        int block_n, block_start;
+        if (x_kind == X_CSR) {
+            csr_row_partition(((const csr_matrix_t *)X)->row_ptr, rows, tid, nt,
+                              &block_n, &block_start);
+        } else {
+            get_row_partition(rows, tid, nt, &block_n, &block_start);
+        }
+        
+        memset(bufs[tid], 0, dk * sizeof(double));
+        gradient_block(X, x_kind, y, beta, block_start, block_n, d, k, bufs[tid],
+                       bufs[num_threads + tid]);
+        thread_tree_reduce(bufs, nt, dk);
+    }
+#endif
+}
+
+void gd_local_gradient(
+    const double *X,
+    const double *y,
+    const double *beta,
+    int rows,
+    int d,
+    double *gradient,
+    workspace_t *scratch
+) {
+    int num_threads = gradient_threads(rows);
+    workspace_t temp;
+    size_t mark;
+    workspace_t *ws = workspace_begin(scratch, &temp, gradient_buffers_bytes(num_threads, d, 0),
+                                      &mark);
+    workspace_require(ws, "gd_local_gradient");
+    double **grad_bufs = gradient_buffers(ws, gradient, num_threads, d, 0);
+    compute_gradient(X, X_DENSE_F64, y, beta, rows, d, 1, grad_bufs, num_threads);
+    workspace_end(ws, &temp, mark);
+}
+
+void gd_local_gradient_csr(
+    const csr_matrix_t *X,
+    const double *y,
+    const double *beta,
+    double *gradient,
+    workspace_t *scratch
+) {
+    int num_threads = gradient_threads(X->rows);
+    workspace_t temp;
+    size_t mark;
+    workspace_t *ws = workspace_begin(scratch, &temp, gradient_buffers_bytes(num_threads, X->d, 0),
+                                      &mark);
+    workspace_require(ws, "gd_local_gradient_csr");
+    double **grad_bufs = gradient_buffers(ws, gradient, num_threads, X->d, 0);
+    compute_gradient(X, X_CSR, y, beta, X->rows, X->d, 1, grad_bufs, num_threads);
+    workspace_end(ws, &temp, mark);
+}
+
+void gd_serial(
+    const double *X,
+    const double *y,
+    double *beta,
+    int n,
+    int d,
+    int iterations,
+    double learning_rate
+) {
+    // n >> d and many iterations: one pass to form XtX/Xty, then d-space
+    workspace_t temp;
+    size_t mark;
+    if (gd_uses_gram(n, d, iterations)) {
+        // XtX, Xty and the d-space gradient of gd_gram_iterate
+        workspace_t *ws = workspace_begin(NULL, &temp,
+                                          workspace_bytes((size_t)d * d, sizeof(double)) +
+                                          2 * workspace_bytes(d, sizeof(double)), &mark);
+        workspace_require(ws, "gd_serial");
+        double *XtX = (double *)workspace_alloc(ws, (size_t)d * d * sizeof(double));
+        double *Xty = (double *)workspace_alloc(ws, d * sizeof(double));
+        ols_normal_equations(X, y, n, d, XtX, Xty);
+        gd_gram_iterate(XtX, Xty, beta, n, d, 1, iterations, learning_rate, ws);
+        workspace_end(ws, &temp, mark);
+        return;
+    }
+    
+    // Temporary array (plus per-thread partial gradients)
+    int num_threads = gradient_threads(n);
+    workspace_t *ws = workspace_begin(NULL, &temp, workspace_bytes(d, sizeof(double)) +
+                                      gradient_buffers_bytes(num_threads, d, 0), &mark);
+    workspace_require(ws, "gd_serial");
+    double *gradient = (double *)workspace_alloc(ws, d * sizeof(double));
+    double **grad_bufs = gradient_buffers(ws, gradient, num_threads, d, 0);
+    
+    // Initialize beta = 0
+    for (int j = 0; j < d; j++) {
+        beta[j] = 0.0;
+    }
+    
+    // Iterative optimization
+    for (int iter = 0; iter < iterations; iter++) {
+        // 1-3. Compute gradient = X^T * (X * beta - y) in one pass over X
+        compute_gradient(X, X_DENSE_F64, y, beta, n, d, 1, grad_bufs, num_threads);
         
         // 4. Update parameters: beta = beta - (learning_rate / n) * gradient
         double step = learning_rate / n;
@@ -56,9 +449,7 @@ void gd_serial(
         }
     }
     
-    free(y_pred);
-    free(error);
-    free(gradient);
+    workspace_end(ws, &temp, mark);
 }
 
 void gd_parallel(
@@ -71,125 +462,219 @@ void gd_parallel(
     double learning_rate,
     MPI_Comm comm
 ) {
-    int rank, size;
-    MPI_Comm_rank(comm, &rank);
-    MPI_Comm_size(comm, &size);
+    // Aligned row block, first-touched by the gradient threads
+    solver_context_t ctx;
+    if (solver_context_init(&ctx, n, d, comm) != 0) {
+        MPI_Abort(comm, 1);
+    }
+    
+    // Distribute data
+    timing_start("gd.scatter");
+    solver_context_scatter(&ctx, X, y);
+    timing_stop("gd.scatter");
     
-    // Calculate data distribution for load balancing
-    int local_n = n / size + (rank < n % size ? 1 : 0);
-    int *sendcounts = NULL;
-    int *displs = NULL;
+    gd_parallel_ctx(&ctx, beta, iterations, learning_rate);
     
-    if (rank == 0) {
-        sendcounts = (int *)malloc(size * sizeof(int));
-        displs = (int *)malloc(size * sizeof(int));
-        int offset = 0;
-        for (int p = 0; p < size; p++) {
-            sendcounts[p] = (n / size + (p < n % size ? 1 : 0)) * d;
-            displs[p] = offset;
-            offset += sendcounts[p];
+    // Clean up
+    solver_context_free(&ctx);
+}
+
+/*
+ * Parallel GD on a float64 or float32 (X_DENSE_F64/X_DENSE_F32) row
+ * block or a CSR block (X_CSR) with k targets (local_y is local_n x k,
+ * beta d x k; k > 1 needs dense float64). With a solver context (whose
+ * rows local_X must be) every temporary is carved from its scratch;
+ * otherwise from one workspace allocated for this call.
+ */
+static void gd_parallel_any(
+    const void *local_X,
+    x_kind_t x_kind,
+    const double *local_y,
+    double *beta,
+    int n,
+    int local_n,
+    int d,
+    int k,
+    int iterations,
+    double learning_rate,
+    solver_context_t *ctx,
+    MPI_Comm comm
+) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    
+    // n >> d and many iterations: a single reduction of XtX/Xty, then
+    // rank 0 iterates in d-space with no further communication
+    int use_gram = (x_kind == X_CSR) ?
+                   gd_uses_gram_csr(local_X, iterations, comm) :
+                   gd_uses_gram_multi(n, d, k, iterations);
+    workspace_t *scratch = ctx ? &ctx->scratch : NULL;
+    workspace_t temp;
+    size_t mark;
+    if (use_gram) {
+        size_t dk_bytes = workspace_bytes((size_t)d * k, sizeof(double));
+        workspace_t *ws = workspace_begin(scratch, &temp,
+                                          workspace_bytes((size_t)d * d, sizeof(double)) +
+                                          2 * dk_bytes, &mark);
+        workspace_require(ws, "gd_parallel_any");
+        double *XtX = NULL;
+        double *Xty = NULL;
+        if (rank == 0) {
+            XtX = (double *)workspace_alloc(ws, (size_t)d * d * sizeof(double));
+            Xty = (double *)workspace_alloc(ws, (size_t)d * k * sizeof(double));
+        }
+        timing_start("gd.gram_setup");
+        if (ctx) {
+            ols_normal_equations_ctx(ctx, XtX, Xty);
+        } else if (x_kind == X_CSR) {
+            ols_normal_equations_local_csr(local_X, local_y, XtX, Xty, comm);
+        } else if (k > 1) {
+            ols_normal_equations_local_multi(local_X, local_y, local_n, d, k, XtX, Xty, comm);
+        } else if (x_kind == X_DENSE_F32) {
+            ols_normal_equations_local_f32(local_X, local_y, local_n, d, XtX, Xty, comm);
+        } else {
+            ols_normal_equations_local(local_X, local_y, local_n, d, XtX, Xty, comm);
         }
+        timing_stop("gd.gram_setup");
+        if (rank == 0) {
+            timing_start("gd.gram_iterate");
+            gd_gram_iterate(XtX, Xty, beta, n, d, k, iterations, learning_rate, ws);
+            timing_stop("gd.gram_iterate");
+        }
+        workspace_end(ws, &temp, mark);
+        return;
     }
     
-    // Allocate local data
-    double *local_X = (double *)malloc(local_n * d * sizeof(double));
-    double *local_y = (double *)malloc(local_n * sizeof(double));
-    double *local_y_pred = (double *)malloc(local_n * sizeof(double));
-    double *local_error = (double *)malloc(local_n * sizeof(double));
-    double *local_gradient = (double *)malloc(d * sizeof(double));
-    double *global_beta = (double *)malloc(d * sizeof(double));
+    int use_allreduce = (gd_comm_mode == GD_COMM_ALLREDUCE);
+    int dk = d * k;
     
-    // Initialize beta = 0
-    for (int j = 0; j < d; j++) {
-        global_beta[j] = 0.0;
-    }
+    // Carve the work arrays: no allocator calls once scratch is warm
+    int num_threads = gradient_threads(local_n);
+    size_t scratch_len = gradient_scratch_len(x_kind, d, k);
+    size_t bytes = 3 * workspace_bytes(dk, sizeof(double)) +
+                   gradient_buffers_bytes(num_threads, dk, scratch_len);
+    workspace_t *ws = workspace_begin(scratch, &temp, bytes, &mark);
+    workspace_require(ws, "gd_parallel_any");
+    double *local_gradient = (double *)workspace_alloc(ws, dk * sizeof(double));
+    double *global_beta = (double *)workspace_alloc(ws, dk * sizeof(double));
+    double **grad_bufs = gradient_buffers(ws, local_gradient, num_threads, dk, scratch_len);
     
-    // Distribute data
-    MPI_Scatterv(X, sendcounts, displs, MPI_DOUBLE,
-                 local_X, local_n * d, MPI_DOUBLE,
-                 0, comm);
+    // Partner's partial sum in the gradient reduction tree
+    double *partner = (double *)workspace_alloc(ws, dk * sizeof(double));
     
-    // Distribute y (needs separate counts and displs)
-    int *y_sendcounts = NULL;
-    int *y_displs = NULL;
-    if (rank == 0) {
-        y_sendcounts = (int *)malloc(size * sizeof(int));
-        y_displs = (int *)malloc(size * sizeof(int));
-        int offset = 0;
-        for (int p = 0; p < size; p++) {
-            y_sendcounts[p] = n / size + (p < n % size ? 1 : 0);
-            y_displs[p] = offset;
-            offset += y_sendcounts[p];
-        }
+    // Initialize beta = 0
+    for (int j = 0; j < dk; j++) {
+        global_beta[j] = 0.0;
     }
     
-    MPI_Scatterv(y, y_sendcounts, y_displs, MPI_DOUBLE,
-                 local_y, local_n, MPI_DOUBLE,
-                 0, comm);
-    
     // Gradient descent iterations
+    double step = learning_rate / n;
     for (int iter = 0; iter < iterations; iter++) {
-        // 1. Broadcast current beta
-        MPI_Bcast(global_beta, d, MPI_DOUBLE, 0, comm);
-        
-        // 2. Compute local predictions: local_y_pred = local_X * beta
-        for (int i = 0; i < local_n; i++) {
-            local_y_pred[i] = 0.0;
-            for (int j = 0; j < d; j++) {
-                local_y_pred[i] += local_X[i * d + j] * global_beta[j];
-            }
+        // 1. Broadcast current beta (allreduce mode: every rank already
+        //    holds the same beta)
+        if (!use_allreduce) {
+            timing_start("gd.bcast");
+            MPI_Bcast(global_beta, dk, MPI_DOUBLE, 0, comm);
+            timing_stop("gd.bcast");
         }
         
-        // 3. Compute local error: local_error = local_y_pred - local_y
-        for (int i = 0; i < local_n; i++) {
-            local_error[i] = local_y_pred[i] - local_y[i];
-        }
+        // 2-4. Compute local gradient = local_X^T * (local_X * beta - local_y)
+        // Fused kernel: one pass over local_X, no per-row temporaries
+        timing_start("gd.compute");
+        compute_gradient(local_X, x_kind, local_y, global_beta, local_n, d, k,
+                         grad_bufs, num_threads);
+        timing_stop("gd.compute");
         
-        // 4. Compute local gradient: local_gradient = local_X^T * local_error (row-major traversal)
-        for (int j = 0; j < d; j++) {
-            local_gradient[j] = 0.0;
-        }
-        for (int i = 0; i < local_n; i++) {
-            for (int j = 0; j < d; j++) {
-                local_gradient[j] += local_X[i * d + j] * local_error[i];
-            }
-        }
-        
-        // 5. Reduce gradient to rank 0
-        if (rank == 0) {
-            MPI_Reduce(MPI_IN_PLACE, local_gradient, d, MPI_DOUBLE, MPI_SUM, 0, comm);
-        } else {
-            MPI_Reduce(local_gradient, NULL, d, MPI_DOUBLE, MPI_SUM, 0, comm);
-        }
+        // 5. Sum gradients on rank 0, or on every rank in allreduce mode
+        timing_start("gd.reduce");
+        sum_gradients_ordered(local_gradient, partner, dk, use_allreduce, comm);
+        timing_stop("gd.reduce");
         
-        // 6. Rank 0 updates parameters
-        if (rank == 0) {
-            double step = learning_rate / n;
-            for (int j = 0; j < d; j++) {
+        // 6. Update parameters: rank 0 only, or every rank identically
+        if (use_allreduce || rank == 0) {
+            timing_start("gd.update");
+            for (int j = 0; j < dk; j++) {
                 global_beta[j] -= step * local_gradient[j];
             }
+            timing_stop("gd.update");
         }
     }
     
     // Return result
     if (rank == 0) {
-        for (int j = 0; j < d; j++) {
+        for (int j = 0; j < dk; j++) {
             beta[j] = global_beta[j];
         }
     }
     
-    // Clean up
-    free(local_X);
-    free(local_y);
-    free(local_y_pred);
-    free(local_error);
-    free(local_gradient);
-    free(global_beta);
-    
-    if (rank == 0) {
-        free(sendcounts);
-        free(displs);
-        free(y_sendcounts);
-        free(y_displs);
-    }
+    workspace_end(ws, &temp, mark);
+}
+
+void gd_parallel_local(
+    const double *local_X,
+    const double *local_y,
+    double *beta,
+    int n,
+    int local_n,
+    int d,
+    int iterations,
+    double learning_rate,
+    MPI_Comm comm
+) {
+    gd_parallel_any(local_X, X_DENSE_F64, local_y, beta, n, local_n, d, 1,
+                    iterations, learning_rate, NULL, comm);
+}
+
+void gd_parallel_local_f32(
+    const float *local_X,
+    const double *local_y,
+    double *beta,
+    int n,
+    int local_n,
+    int d,
+    int iterations,
+    double learning_rate,
+    MPI_Comm comm
+) {
+    gd_parallel_any(local_X, X_DENSE_F32, local_y, beta, n, local_n, d, 1,
+                    iterations, learning_rate, NULL, comm);
+}
+
+void gd_parallel_local_multi(
+    const double *local_X,
+    const double *local_Y,
+    double *B,
+    int n,
+    int local_n,
+    int d,
+    int k,
+    int iterations,
+    double learning_rate,
+    MPI_Comm comm
+) {
+    gd_parallel_any(local_X, X_DENSE_F64, local_Y, B, n, local_n, d, k,
+                    iterations, learning_rate, NULL, comm);
+}
+
+void gd_parallel_local_csr(
+    const csr_matrix_t *local_X,
+    const double *local_y,
+    double *beta,
+    int n,
+    int iterations,
+    double learning_rate,
+    MPI_Comm comm
+) {
+    gd_parallel_any(local_X, X_CSR, local_y, beta, n, local_X->rows,
+                    local_X->d, 1, iterations, learning_rate, NULL, comm);
+}
+
+void gd_parallel_ctx(
+    solver_context_t *ctx,
+    double *beta,
+    int iterations,
+    double learning_rate
+) {
+    gd_parallel_any(ctx->local_X, X_DENSE_F64, ctx->local_y, beta, ctx->n,
+                    ctx->local_n, ctx->d, 1, iterations, learning_rate, ctx, ctx->comm);
 }
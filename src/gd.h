@@ -8,6 +8,86 @@
 #define GD_H
 
 #include <mpi.h>
+#include "sparse.h"
+#include "context.h"
+
+// How per-rank gradients are combined each iteration
+#define GD_COMM_ROOT      0  // sum on rank 0, rank 0 updates, Bcast beta
+#define GD_COMM_ALLREDUCE 1  // every rank sums and applies the same update
+
+/*
+ * Select the communication pattern of the parallel GD variants
+ * 
+ * Both modes add the per-rank gradients over the same fixed pairwise
+ * tree (O(d log p) traffic per rank), so they give bit-identical
+ * results; GD_COMM_ALLREDUCE skips the beta broadcast of each iteration
+ * and has no rank-0 update on the critical path.
+ */
+void gd_set_comm_mode(int mode);
+
+// Where the GD iterations run
+#define GD_MODE_AUTO 0  // pick by cost model (see gd_uses_gram)
+#define GD_MODE_DATA 1  // every iteration passes over X
+#define GD_MODE_GRAM 2  // form XtX/Xty once, then iterate in d-space
+
+/*
+ * Select between data-space and Gram-matrix (d-space) iterations
+ * 
+ * Since X^T(X * beta - y) = XtX * beta - Xty, GD can run on the d x d
+ * normal equations after one pass over X. This trades O(n*d) work and
+ * a collective per iteration for O(d^2) work and no communication.
+ */
+void gd_set_mode(int mode);
+
+/*
+ * Whether GD on an n x d problem will run in d-space
+ * 
+ * In GD_MODE_AUTO this compares the multiply-add counts of both
+ * paths; the answer depends only on global sizes, so every rank agrees.
+ */
+int gd_uses_gram(int n, int d, int iterations);
+
+/*
+ * gd_uses_gram for k targets (the choice of gd_parallel_local_multi);
+ * more targets make each data-space pass dearer, so this can pick the
+ * Gram path where gd_uses_gram does not
+ */
+int gd_uses_gram_multi(int n, int d, int k, int iterations);
+
+/*
+ * Least-squares gradient over a block of rows (OpenMP-threaded)
+ * 
+ * Parameters:
+ *   X - rows x d row-major block
+ *   y - rows x 1 responses, or NULL for gradient = X^T * X * beta
+ *   beta - d x 1 current parameters
+ *   rows - number of rows in the block
+ *   d - number of features
+ *   gradient - d x 1 output: X^T * (X * beta - y)
+ *   scratch - workspace for the per-thread buffers, or NULL for a
+ *             one-off one; pass the same workspace on every call of a
+ *             loop so it stops allocating after the first
+ */
+void gd_local_gradient(
+    const double *X,
+    const double *y,
+    const double *beta,
+    int rows,
+    int d,
+    double *gradient,
+    workspace_t *scratch
+);
+
+/*
+ * gd_local_gradient for a CSR row block (X->rows x X->d)
+ */
+void gd_local_gradient_csr(
+    const csr_matrix_t *X,
+    const double *y,
+    const double *beta,
+    double *gradient,
+    workspace_t *scratch
+);
 
 /*
  * Serial GD implementation
@@ -55,4 +135,107 @@ void gd_parallel(
     MPI_Comm comm
 );
 
+/*
+ * Parallel GD on pre-distributed data
+ * 
+ * Parameters:
+ *   local_X - local_n x d row block owned by this rank
+ *   local_y - local_n x 1 response block owned by this rank
+ *   beta - output parameters (computed on rank 0)
+ *   n - total number of samples (sets the gradient scaling)
+ *   local_n - number of rows owned by this rank
+ *   d - number of features
+ *   iterations - number of iterations
+ *   learning_rate - step size
+ *   comm - MPI communicator
+ */
+void gd_parallel_local(
+    const double *local_X,
+    const double *local_y,
+    double *beta,
+    int n,
+    int local_n,
+    int d,
+    int iterations,
+    double learning_rate,
+    MPI_Comm comm
+);
+
+/*
+ * Parallel GD on a solver context's row block (see context.h)
+ * 
+ * Same result as gd_parallel_local; the gradient, per-thread partial
+ * gradients and gather buffer (or XtX/Xty on the Gram path) are carved
+ * from the context's scratch, so repeated fits do not allocate.
+ * 
+ * Parameters:
+ *   ctx - initialised context holding this rank's rows
+ *   beta - output parameters (computed on rank 0)
+ *   iterations - number of iterations
+ *   learning_rate - step size
+ */
+void gd_parallel_ctx(
+    solver_context_t *ctx,
+    double *beta,
+    int iterations,
+    double learning_rate
+);
+
+/*
+ * Parallel GD on pre-distributed float32 row blocks
+ * 
+ * Mixed precision: X is stored (and read) as float32, halving memory
+ * footprint and per-iteration traffic; predictions, gradients and beta
+ * stay in float64. Parameters as for gd_parallel_local.
+ */
+void gd_parallel_local_f32(
+    const float *local_X,
+    const double *local_y,
+    double *beta,
+    int n,
+    int local_n,
+    int d,
+    int iterations,
+    double learning_rate,
+    MPI_Comm comm
+);
+
+/*
+ * Multi-target parallel GD on pre-distributed data: X * B = Y
+ * 
+ * All k targets share each pass over local_X (or the single XtX when
+ * the Gram path is chosen). Parameters as for gd_parallel_local, with
+ * local_Y local_n x k and B d x k (row-major, valid on rank 0).
+ */
+void gd_parallel_local_multi(
+    const double *local_X,
+    const double *local_Y,
+    double *B,
+    int n,
+    int local_n,
+    int d,
+    int k,
+    int iterations,
+    double learning_rate,
+    MPI_Comm comm
+);
+
+/*
+ * Parallel GD on pre-distributed CSR row blocks
+ * 
+ * Each gradient pass costs O(nnz): a fused SpMV / SpMV^T per row. In
+ * GD_MODE_AUTO the Gram path is chosen from the global nonzero counts
+ * (one extra small Allreduce). Parameters as for gd_parallel_local,
+ * with local_n and d taken from local_X.
+ */
+void gd_parallel_local_csr(
+    const csr_matrix_t *local_X,
+    const double *local_y,
+    double *beta,
+    int n,
+    int iterations,
+    double learning_rate,
+    MPI_Comm comm
+);
+
 #endif // GD_H
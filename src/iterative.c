@@ -0,0 +1,314 @@
+/*
+ * iterative.c - CG and L-BFGS implementation
+ */
+
+#include "iterative.h"
+#include "gd.h"
+#include "timing.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+static double dot(const double *a, const double *b, int d) {
+    double sum = 0.0;
+    for (int j = 0; j < d; j++) {
+        sum += a[j] * b[j];
+    }
+    return sum;
+}
+
+/*
+ * out = X^T * (X * v - y) summed over all ranks (y may be NULL); X is
+ * a dense float64 block (X_DENSE_F64) or a csr_matrix_t (X_CSR).
+ * scratch is the solve's workspace, so only the first call allocates
+ * the thread buffers.
+ */
+static void global_gradient(
+    const void *local_X,
+    x_kind_t x_kind,
+    const double *local_y,
+    const double *v,
+    int local_n,
+    int d,
+    double *out,
+    workspace_t *scratch,
+    MPI_Comm comm
+) {
+    timing_start("iter.compute");
+    if (x_kind == X_CSR) {
+        gd_local_gradient_csr(local_X, local_y, v, out, scratch);
+    } else {
+        gd_local_gradient(local_X, local_y, v, local_n, d, out, scratch);
+    }
+    timing_stop("iter.compute");
+    timing_start("iter.allreduce");
+    MPI_Allreduce(MPI_IN_PLACE, out, d, MPI_DOUBLE, MPI_SUM, comm);
+    timing_stop("iter.allreduce");
+}
+
+/*
+ * Fill in stats with the true (not recursively updated) residual
+ */
+static void finish_stats(
+    const void *local_X,
+    x_kind_t x_kind,
+    const double *local_y,
+    const double *beta,
+    int local_n,
+    int d,
+    int iterations,
+    double b_norm,
+    double tol,
+    iter_stats_t *stats,
+    workspace_t *scratch,
+    MPI_Comm comm
+) {
+    if (!stats) {
+        return;
+    }
+    double *g = (double *)malloc(d * sizeof(double));
+    global_gradient(local_X, x_kind, local_y, beta, local_n, d, g, scratch, comm);
+    stats->iterations = iterations;
+    stats->residual = (b_norm > 0.0) ? sqrt(dot(g, g, d)) / b_norm : 0.0;
+    stats->converged = (stats->residual <= tol);
+    free(g);
+}
+
+/*
+ * cg_parallel_local on a dense or CSR block (see global_gradient)
+ */
+static void cg_any(
+    const void *local_X,
+    x_kind_t x_kind,
+    const double *local_y,
+    double *beta,
+    int local_n,
+    int d,
+    int max_iter,
+    double tol,
+    iter_stats_t *stats,
+    MPI_Comm comm
+) {
+    double *r = (double *)malloc(d * sizeof(double));
+    double *p = (double *)malloc(d * sizeof(double));
+    double *q = (double *)malloc(d * sizeof(double));
+    workspace_t scratch = {0};  // gradient thread buffers, reused every iteration
+    
+    // Step 1: beta = 0, so r = Xty = -X^T * (X * 0 - y)
+    for (int j = 0; j < d; j++) {
+        beta[j] = 0.0;
+    }
+    global_gradient(local_X, x_kind, local_y, beta, local_n, d, r, &scratch, comm);
+    for (int j = 0; j < d; j++) {
+        r[j] = -r[j];
+        p[j] = r[j];
+    }
+    double rr = dot(r, r, d);
+    double b_norm = sqrt(rr);
+    
+    // Step 2: CG iterations, one Allreduce each
+    int iter = 0;
+    while (iter < max_iter && sqrt(rr) > tol * b_norm) {
+        // q = XtX * p in one pass over the local rows
+        global_gradient(local_X, x_kind, NULL, p, local_n, d, q, &scratch, comm);
+        double pq = dot(p, q, d);
+        if (pq <= 0.0) {
+            break;  // XtX singular along p: no further progress possible
+        }
+        
+        double alpha = rr / pq;
+        for (int j = 0; j < d; j++) {
+            beta[j] += alpha * p[j];
+            r[j] -= alpha * q[j];
+        }
+        
+        double rr_new = dot(r, r, d);
+        double ratio = rr_new / rr;
+        for (int j = 0; j < d; j++) {
+            p[j] = r[j] + ratio * p[j];
+        }
+        rr = rr_new;
+        iter++;
+    }
+    
+    finish_stats(local_X, x_kind, local_y, beta, local_n, d, iter, b_norm, tol, stats,
+                 &scratch, comm);
+    
+    free(r);
+    free(p);
+    free(q);
+    workspace_free(&scratch);
+}
+
+/*
+ * lbfgs_parallel_local on a dense or CSR block (see global_gradient)
+ */
+static void lbfgs_any(
+    const void *local_X,
+    x_kind_t x_kind,
+    const double *local_y,
+    double *beta,
+    int local_n,
+    int d,
+    int max_iter,
+    double tol,
+    int memory,
+    iter_stats_t *stats,
+    MPI_Comm comm
+) {
+    if (memory < 1) {
+        memory = 1;
+    }
+    
+    // Correction pairs s_k = beta_{k+1} - beta_k, y_k = g_{k+1} - g_k,
+    // stored in a ring buffer
+    double *S = (double *)malloc((size_t)memory * d * sizeof(double));
+    double *Y = (double *)malloc((size_t)memory * d * sizeof(double));
+    double *rho = (double *)malloc(memory * sizeof(double));
+    double *alpha_hist = (double *)malloc(memory * sizeof(double));
+    double *g = (double *)malloc(d * sizeof(double));
+    double *p = (double *)malloc(d * sizeof(double));
+    double *Ap = (double *)malloc(d * sizeof(double));
+    workspace_t scratch = {0};  // gradient thread buffers, reused every iteration
+    int count = 0;
+    int newest = -1;
+    
+    // Step 1: beta = 0, g = X^T * (X * 0 - y) = -Xty
+    for (int j = 0; j < d; j++) {
+        beta[j] = 0.0;
+    }
+    global_gradient(local_X, x_kind, local_y, beta, local_n, d, g, &scratch, comm);
+    double g_norm = sqrt(dot(g, g, d));
+    double b_norm = g_norm;
+    
+    // Step 2: L-BFGS iterations, one Allreduce each
+    int iter = 0;
+    while (iter < max_iter && g_norm > tol * b_norm) {
+        // Two-loop recursion: p = -H * g
+        memcpy(p, g, d * sizeof(double));
+        for (int k = 0; k < count; k++) {
+            int idx = (newest - k + memory) % memory;
+            alpha_hist[idx] = rho[idx] * dot(S + (size_t)idx * d, p, d);
+            const double *yk = Y + (size_t)idx * d;
+            for (int j = 0; j < d; j++) {
+                p[j] -= alpha_hist[idx] * yk[j];
+            }
+        }
+        if (count > 0) {
+            // Initial Hessian scaling gamma = s^T y / y^T y
+            const double *yk = Y + (size_t)newest * d;
+            double gamma = 1.0 / (rho[newest] * dot(yk, yk, d));
+            for (int j = 0; j < d; j++) {
+                p[j] *= gamma;
+            }
+        }
+        for (int k = count - 1; k >= 0; k--) {
+            int idx = (newest - k + memory) % memory;
+            double b = rho[idx] * dot(Y + (size_t)idx * d, p, d);
+            const double *sk = S + (size_t)idx * d;
+            for (int j = 0; j < d; j++) {
+                p[j] += (alpha_hist[idx] - b) * sk[j];
+            }
+        }
+        for (int j = 0; j < d; j++) {
+            p[j] = -p[j];
+        }
+        
+        // Exact line search on the quadratic: Ap = XtX * p
+        global_gradient(local_X, x_kind, NULL, p, local_n, d, Ap, &scratch, comm);
+        double pAp = dot(p, Ap, d);
+        double gp = dot(g, p, d);
+        if (pAp <= 0.0 || gp >= 0.0) {
+            break;  // no descent possible along p
+        }
+        double step = -gp / pAp;
+        
+        // Update beta and g, and store the new correction pair
+        newest = (newest + 1) % memory;
+        double *sk = S + (size_t)newest * d;
+        double *yk = Y + (size_t)newest * d;
+        for (int j = 0; j < d; j++) {
+            sk[j] = step * p[j];
+            yk[j] = step * Ap[j];
+            beta[j] += sk[j];
+            g[j] += yk[j];
+        }
+        rho[newest] = 1.0 / dot(sk, yk, d);  // s^T y = step^2 * pAp > 0
+        if (count < memory) {
+            count++;
+        }
+        
+        g_norm = sqrt(dot(g, g, d));
+        iter++;
+    }
+    
+    finish_stats(local_X, x_kind, local_y, beta, local_n, d, iter, b_norm, tol, stats,
+                 &scratch, comm);
+    
+    free(S);
+    free(Y);
+    free(rho);
+    free(alpha_hist);
+    free(g);
+    free(p);
+    free(Ap);
+    workspace_free(&scratch);
+}
+
+void cg_parallel_local(
+    const double *local_X,
+    const double *local_y,
+    double *beta,
+    int local_n,
+    int d,
+    int max_iter,
+    double tol,
+    iter_stats_t *stats,
+    MPI_Comm comm
+) {
+    cg_any(local_X, X_DENSE_F64, local_y, beta, local_n, d, max_iter, tol,
+           stats, comm);
+}
+
+void cg_parallel_local_csr(
+    const csr_matrix_t *local_X,
+    const double *local_y,
+    double *beta,
+    int max_iter,
+    double tol,
+    iter_stats_t *stats,
+    MPI_Comm comm
+) {
+    cg_any(local_X, X_CSR, local_y, beta, local_X->rows, local_X->d,
+           max_iter, tol, stats, comm);
+}
+
+void lbfgs_parallel_local(
+    const double *local_X,
+    const double *local_y,
+    double *beta,
+    int local_n,
+    int d,
+    int max_iter,
+    double tol,
+    int memory,
+    iter_stats_t *stats,
+    MPI_Comm comm
+) {
+    lbfgs_any(local_X, X_DENSE_F64, local_y, beta, local_n, d, max_iter, tol,
+              memory, stats, comm);
+}
+
+void lbfgs_parallel_local_csr(
+    const csr_matrix_t *local_X,
+    const double *local_y,
+    double *beta,
+    int max_iter,
+    double tol,
+    int memory,
+    iter_stats_t *stats,
+    MPI_Comm comm
+) {
+    lbfgs_any(local_X, X_CSR, local_y, beta, local_X->rows, local_X->d,
+              max_iter, tol, memory, stats, comm);
+}
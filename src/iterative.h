@@ -0,0 +1,117 @@
+/*
+ * iterative.h - Convergence-controlled iterative solvers
+ * 
+ * Conjugate gradient on the normal equations and L-BFGS for the
+ * least-squares objective 0.5 * ||X * beta - y||^2, on pre-distributed
+ * row blocks (same row partition as the other parallel solvers).
+ * Each iteration makes one pass over the local rows and a single
+ * d-length MPI_Allreduce; all d-vectors are replicated on every rank.
+ */
+
+#ifndef ITERATIVE_H
+#define ITERATIVE_H
+
+#include <mpi.h>
+#include "sparse.h"
+
+// Correction pairs kept by L-BFGS
+#define LBFGS_DEFAULT_MEMORY 10
+
+typedef struct {
+    int iterations;   // iterations performed
+    double residual;  // final ||X^T(X * beta - y)|| / ||X^T y||
+    int converged;    // 1 if residual reached the tolerance
+} iter_stats_t;
+
+/*
+ * Conjugate gradient on XtX * beta = Xty
+ * 
+ * XtX is never formed: each iteration computes X^T * (X * p) in one
+ * pass over the local rows. Stops when the recursively updated
+ * residual satisfies ||r|| <= tol * ||X^T y||, or after max_iter.
+ * 
+ * Parameters:
+ *   local_X - local_n x d row block owned by this rank
+ *   local_y - local_n x 1 response block owned by this rank
+ *   beta - d x 1 output parameters (on every rank)
+ *   local_n - number of rows owned by this rank
+ *   d - number of features
+ *   max_iter - iteration limit
+ *   tol - relative residual tolerance
+ *   stats - iteration count and final residual (may be NULL)
+ *   comm - MPI communicator
+ */
+void cg_parallel_local(
+    const double *local_X,
+    const double *local_y,
+    double *beta,
+    int local_n,
+    int d,
+    int max_iter,
+    double tol,
+    iter_stats_t *stats,
+    MPI_Comm comm
+);
+
+/*
+ * L-BFGS on 0.5 * ||X * beta - y||^2
+ * 
+ * The objective is quadratic, so the step length along the search
+ * direction p is found exactly from X^T * X * p, and the new gradient
+ * follows from linearity (g += alpha * X^T * X * p) without a second
+ * pass. Stops when ||g|| <= tol * ||X^T y||, or after max_iter.
+ * 
+ * Parameters:
+ *   local_X - local_n x d row block owned by this rank
+ *   local_y - local_n x 1 response block owned by this rank
+ *   beta - d x 1 output parameters (on every rank)
+ *   local_n - number of rows owned by this rank
+ *   d - number of features
+ *   max_iter - iteration limit
+ *   tol - relative gradient tolerance
+ *   memory - number of correction pairs kept (e.g. LBFGS_DEFAULT_MEMORY)
+ *   stats - iteration count and final residual (may be NULL)
+ *   comm - MPI communicator
+ */
+void lbfgs_parallel_local(
+    const double *local_X,
+    const double *local_y,
+    double *beta,
+    int local_n,
+    int d,
+    int max_iter,
+    double tol,
+    int memory,
+    iter_stats_t *stats,
+    MPI_Comm comm
+);
+
+/*
+ * CG and L-BFGS on pre-distributed CSR row blocks
+ * 
+ * Each X^T * (X * v) is a fused SpMV / SpMV^T pass over the local
+ * nonzeros. Parameters as for the dense versions, with local_n and d
+ * taken from local_X.
+ */
+void cg_parallel_local_csr(
+    const csr_matrix_t *local_X,
+    const double *local_y,
+    double *beta,
+    int max_iter,
+    double tol,
+    iter_stats_t *stats,
+    MPI_Comm comm
+);
+
+void lbfgs_parallel_local_csr(
+    const csr_matrix_t *local_X,
+    const double *local_y,
+    double *beta,
+    int max_iter,
+    double tol,
+    int memory,
+    iter_stats_t *stats,
+    MPI_Comm comm
+);
+
+#endif // ITERATIVE_H
@@ -0,0 +1,783 @@
+/*
+ * kernels.c - Vectorised compute kernels implementation
+ */
+
+#include "kernels.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+// Register tile of C: SYRK_MR rows x (up to) SYRK_NR_MAX columns
+#define SYRK_MR 4
+#define SYRK_NR_MAX 16
+
+// Row panels are sized so one panel stays resident in L2
+#define PANEL_BYTES (256 * 1024)
+
+// float32 rows are widened in blocks of this size (L1-resident)
+#define WIDEN_BLOCK_BYTES (16 * 1024)
+#define PANEL_MIN_ROWS 16
+#define PANEL_MAX_ROWS 512
+
+static int selected_isa = -1;
+
+static int detect_isa(void) {
+    int best = KERNEL_ISA_SCALAR;
+#ifdef KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        best = KERNEL_ISA_AVX2;
+    }
+    if (__builtin_cpu_supports("avx512f")) {
+        best = KERNEL_ISA_AVX512;
+    }
+#endif
+    
+    // Optional override, clamped to what the CPU supports
+    const char *env = getenv("PLR_KERNEL_ISA");
+    if (env) {
+        int requested = best;
+        if (strcmp(env, "scalar") == 0) requested = KERNEL_ISA_SCALAR;
+        else if (strcmp(env, "avx2") == 0) requested = KERNEL_ISA_AVX2;
+        else if (strcmp(env, "avx512") == 0) requested = KERNEL_ISA_AVX512;
+        if (requested < best) best = requested;
+    }
+    return best;
+}
+
+int kernel_isa(void) {
+    // The first call may come from inside a parallel region: threads
+    // that race here all detect the same ISA, and the atomic accesses
+    // keep the shared cache free of data races
+    int isa;
+#ifdef _OPENMP
+    #pragma omp atomic read
+#endif
+    isa = selected_isa;
+    if (isa < 0) {
+        isa = detect_isa();
+#ifdef _OPENMP
+        #pragma omp atomic write
+#endif
+        selected_isa = isa;
+    }
+    return isa;
+}
+
+const char *kernel_isa_name(void) {
+    switch (kernel_isa()) {
+        case KERNEL_ISA_AVX512: return "avx512";
+        case KERNEL_ISA_AVX2:   return "avx2";
+        default:                return "scalar";
+    }
+}
+
+static int panel_rows(int d) {
+    int rows = PANEL_BYTES / ((int)sizeof(double) * (d > 0 ? d : 1));
+    if (rows < PANEL_MIN_ROWS) rows = PANEL_MIN_ROWS;
+    if (rows > PANEL_MAX_ROWS) rows = PANEL_MAX_ROWS;
+    return rows;
+}
+
+/*
+ * Add an mr x nr tile of accumulators to C, keeping only j <= i
+ */
+static void add_tile_lower(const double *acc, int ld_acc, int i0, int mr,
+                           int j0, int nr, int d, double *C) {
+    for (int r = 0; r < mr; r++) {
+        int i = i0 + r;
+        int cols = i - j0 + 1;
+        if (cols > nr) cols = nr;
+        for (int c = 0; c < cols; c++) {
+            C[(size_t)i * d + j0 + c] += acc[r * ld_acc + c];
+        }
+    }
+}
+
+/*
+ * Generic tile: rows i0..i0+mr-1, columns j0..j0+nr-1 of C,
+ * summed over X rows [k0, k1)
+ */
+static void syrk_tile_scalar(const double *X, int d, int k0, int k1,
+                             int i0, int mr, int j0, int nr, double *C) {
+    double acc[SYRK_MR * SYRK_NR_MAX] = {0};
+    for (int k = k0; k < k1; k++) {
+        const double *x = X + (size_t)k * d;
+        for (int r = 0; r < mr; r++) {
+            double xi = x[i0 + r];
+            for (int c = 0; c < nr; c++) {
+                acc[r * SYRK_NR_MAX + c] += xi * x[j0 + c];
+            }
+        }
+    }
+    add_tile_lower(acc, SYRK_NR_MAX, i0, mr, j0, nr, d, C);
+}
+
+#ifdef KERNELS_X86
+/*
+ * 4 x 8 tile with eight AVX2 accumulators
+ */
+__attribute__((target("avx2,fma")))
+static void syrk_tile_avx2(const double *X, int d, int k0, int k1,
+                           int i0, int j0, double *C) {
+    __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+    __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+    __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+    __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+    
+    for (int k = k0; k < k1; k++) {
+        const double *x = X + (size_t)k * d;
+        __m256d b0 = _mm256_loadu_pd(x + j0);
+        __m256d b1 = _mm256_loadu_pd(x + j0 + 4);
+        __m256d a;
+        a = _mm256_broadcast_sd(x + i0);
+        c00 = _mm256_fmadd_pd(a, b0, c00); c01 = _mm256_fmadd_pd(a, b1, c01);
+        a = _mm256_broadcast_sd(x + i0 + 1);
+        c10 = _mm256_fmadd_pd(a, b0, c10); c11 = _mm256_fmadd_pd(a, b1, c11);
+        a = _mm256_broadcast_sd(x + i0 + 2);
+        c20 = _mm256_fmadd_pd(a, b0, c20); c21 = _mm256_fmadd_pd(a, b1, c21);
+        a = _mm256_broadcast_sd(x + i0 + 3);
+        c30 = _mm256_fmadd_pd(a, b0, c30); c31 = _mm256_fmadd_pd(a, b1, c31);
+    }
+    
+    if (j0 + 8 <= i0 + 1) {
+        // Tile lies entirely in the lower triangle
+        double *c = C + (size_t)i0 * d + j0;
+        _mm256_storeu_pd(c, _mm256_add_pd(_mm256_loadu_pd(c), c00));
+        _mm256_storeu_pd(c + 4, _mm256_add_pd(_mm256_loadu_pd(c + 4), c01));
+        c += d;
+        _mm256_storeu_pd(c, _mm256_add_pd(_mm256_loadu_pd(c), c10));
+        _mm256_storeu_pd(c + 4, _mm256_add_pd(_mm256_loadu_pd(c + 4), c11));
+        c += d;
+        _mm256_storeu_pd(c, _mm256_add_pd(_mm256_loadu_pd(c), c20));
+        _mm256_storeu_pd(c + 4, _mm256_add_pd(_mm256_loadu_pd(c + 4), c21));
+        c += d;
+        _mm256_storeu_pd(c, _mm256_add_pd(_mm256_loadu_pd(c), c30));
+        _mm256_storeu_pd(c + 4, _mm256_add_pd(_mm256_loadu_pd(c + 4), c31));
+    } else {
+        // Diagonal tile: drop the entries above the diagonal
+        double acc[SYRK_MR * 8];
+        _mm256_storeu_pd(acc, c00);      _mm256_storeu_pd(acc + 4, c01);
+        _mm256_storeu_pd(acc + 8, c10);  _mm256_storeu_pd(acc + 12, c11);
+        _mm256_storeu_pd(acc + 16, c20); _mm256_storeu_pd(acc + 20, c21);
+        _mm256_storeu_pd(acc + 24, c30); _mm256_storeu_pd(acc + 28, c31);
+        add_tile_lower(acc, 8, i0, SYRK_MR, j0, 8, d, C);
+    }
+}
+
+/*
+ * 4 x 16 tile with eight AVX-512 accumulators
+ */
+__attribute__((target("avx512f")))
+static void syrk_tile_avx512(const double *X, int d, int k0, int k1,
+                             int i0, int j0, double *C) {
+    __m512d c00 = _mm512_setzero_pd(), c01 = _mm512_setzero_pd();
+    __m512d c10 = _mm512_setzero_pd(), c11 = _mm512_setzero_pd();
+    __m512d c20 = _mm512_setzero_pd(), c21 = _mm512_setzero_pd();
+    __m512d c30 = _mm512_setzero_pd(), c31 = _mm512_setzero_pd();
+    
+    for (int k = k0; k < k1; k++) {
+        const double *x = X + (size_t)k * d;
+        __m512d b0 = _mm512_loadu_pd(x + j0);
+        __m512d b1 = _mm512_loadu_pd(x + j0 + 8);
+        __m512d a;
+        a = _mm512_set1_pd(x[i0]);
+        c00 = _mm512_fmadd_pd(a, b0, c00); c01 = _mm512_fmadd_pd(a, b1, c01);
+        a = _mm512_set1_pd(x[i0 + 1]);
+        c10 = _mm512_fmadd_pd(a, b0, c10); c11 = _mm512_fmadd_pd(a, b1, c11);
+        a = _mm512_set1_pd(x[i0 + 2]);
+        c20 = _mm512_fmadd_pd(a, b0, c20); c21 = _mm512_fmadd_pd(a, b1, c21);
+        a = _mm512_set1_pd(x[i0 + 3]);
+        c30 = _mm512_fmadd_pd(a, b0, c30); c31 = _mm512_fmadd_pd(a, b1, c31);
+    }
+    
+    if (j0 + 16 <= i0 + 1) {
+        // Tile lies entirely in the lower triangle
+        double *c = C + (size_t)i0 * d + j0;
+        _mm512_storeu_pd(c, _mm512_add_pd(_mm512_loadu_pd(c), c00));
+        _mm512_storeu_pd(c + 8, _mm512_add_pd(_mm512_loadu_pd(c + 8), c01));
+        c += d;
+        _mm512_storeu_pd(c, _mm512_add_pd(_mm512_loadu_pd(c), c10));
+        _mm512_storeu_pd(c + 8, _mm512_add_pd(_mm512_loadu_pd(c + 8), c11));
+        c += d;
+        _mm512_storeu_pd(c, _mm512_add_pd(_mm512_loadu_pd(c), c20));
+        _mm512_storeu_pd(c + 8, _mm512_add_pd(_mm512_loadu_pd(c + 8), c21));
+        c += d;
+        _mm512_storeu_pd(c, _mm512_add_pd(_mm512_loadu_pd(c), c30));
+        _mm512_storeu_pd(c + 8, _mm512_add_pd(_mm512_loadu_pd(c + 8), c31));
+    } else {
+        // Diagonal tile: drop the entries above the diagonal
+        double acc[SYRK_MR * 16];
+        _mm512_storeu_pd(acc, c00);      _mm512_storeu_pd(acc + 8, c01);
+        _mm512_storeu_pd(acc + 16, c10); _mm512_storeu_pd(acc + 24, c11);
+        _mm512_storeu_pd(acc + 32, c20); _mm512_storeu_pd(acc + 40, c21);
+        _mm512_storeu_pd(acc + 48, c30); _mm512_storeu_pd(acc + 56, c31);
+        add_tile_lower(acc, 16, i0, SYRK_MR, j0, 16, d, C);
+    }
+}
+#endif
+
+void syrk_lower(const double *X, int rows, int d, double *C) {
+    int isa = kernel_isa();
+    if (isa == KERNEL_ISA_AVX512 && d < 16) {
+        // Too narrow for a full 16-column tile
+        isa = KERNEL_ISA_AVX2;
+    }
+    int nr = (isa == KERNEL_ISA_AVX512) ? 16 : 8;
+    int kc = panel_rows(d);
+    
+    // Row panels outermost: each panel is read from L2 by every tile
+    for (int k0 = 0; k0 < rows; k0 += kc) {
+        int k1 = (k0 + kc < rows) ? k0 + kc : rows;
+        
+        for (int i0 = 0; i0 < d; i0 += SYRK_MR) {
+            int mr = (d - i0 < SYRK_MR) ? d - i0 : SYRK_MR;
+            
+            // Column tiles up to and including the diagonal
+            for (int j0 = 0; j0 < i0 + mr; j0 += nr) {
+                int jn = (d - j0 < nr) ? d - j0 : nr;
+#ifdef KERNELS_X86
+                if (mr == SYRK_MR && jn == nr) {
+                    if (isa == KERNEL_ISA_AVX512) {
+                        syrk_tile_avx512(X, d, k0, k1, i0, j0, C);
+                        continue;
+                    } else if (isa == KERNEL_ISA_AVX2) {
+                        syrk_tile_avx2(X, d, k0, k1, i0, j0, C);
+                        continue;
+                    }
+                }
+#endif
+                syrk_tile_scalar(X, d, k0, k1, i0, mr, j0, jn, C);
+            }
+        }
+    }
+}
+
+void syrk_mirror(double *C, int d) {
+    for (int i = 0; i < d; i++) {
+        for (int j = 0; j < i; j++) {
+            C[(size_t)j * d + i] = C[(size_t)i * d + j];
+        }
+    }
+}
+
+// Register tile of the X^T * Y kernel: GEMM_MR features x GEMM_NR targets
+#define GEMM_MR 4
+#define GEMM_NR 8
+
+/*
+ * Generic tile: C[i0..i0+mr-1][c0..c0+nr-1] += X^T * Y over rows [k0, k1)
+ */
+static void gemm_tn_tile_scalar(const double *X, const double *Y, int d, int k,
+                                int k0, int k1, int i0, int mr, int c0, int nr,
+                                double *C) {
+    double acc[GEMM_MR * GEMM_NR] = {0};
+    for (int r = k0; r < k1; r++) {
+        const double *x = X + (size_t)r * d + i0;
+        const double *yr = Y + (size_t)r * k + c0;
+        for (int a = 0; a < mr; a++) {
+            for (int c = 0; c < nr; c++) {
+                acc[a * GEMM_NR + c] += x[a] * yr[c];
+            }
+        }
+    }
+    for (int a = 0; a < mr; a++) {
+        for (int c = 0; c < nr; c++) {
+            C[(size_t)(i0 + a) * k + c0 + c] += acc[a * GEMM_NR + c];
+        }
+    }
+}
+
+#ifdef KERNELS_X86
+/*
+ * 4 x 8 tile with eight AVX2 accumulators
+ */
+__attribute__((target("avx2,fma")))
+static void gemm_tn_tile_avx2(const double *X, const double *Y, int d, int k,
+                              int k0, int k1, int i0, int c0, double *C) {
+    __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+    __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+    __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+    __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+    
+    for (int r = k0; r < k1; r++) {
+        const double *x = X + (size_t)r * d + i0;
+        const double *yr = Y + (size_t)r * k + c0;
+        __m256d b0 = _mm256_loadu_pd(yr);
+        __m256d b1 = _mm256_loadu_pd(yr + 4);
+        __m256d a;
+        a = _mm256_broadcast_sd(x);
+        c00 = _mm256_fmadd_pd(a, b0, c00); c01 = _mm256_fmadd_pd(a, b1, c01);
+        a = _mm256_broadcast_sd(x + 1);
+        c10 = _mm256_fmadd_pd(a, b0, c10); c11 = _mm256_fmadd_pd(a, b1, c11);
+        a = _mm256_broadcast_sd(x + 2);
+        c20 = _mm256_fmadd_pd(a, b0, c20); c21 = _mm256_fmadd_pd(a, b1, c21);
+        a = _mm256_broadcast_sd(x + 3);
+        c30 = _mm256_fmadd_pd(a, b0, c30); c31 = _mm256_fmadd_pd(a, b1, c31);
+    }
+    
+    double *c = C + (size_t)i0 * k + c0;
+    _mm256_storeu_pd(c, _mm256_add_pd(_mm256_loadu_pd(c), c00));
+    _mm256_storeu_pd(c + 4, _mm256_add_pd(_mm256_loadu_pd(c + 4), c01));
+    c += k;
+    _mm256_storeu_pd(c, _mm256_add_pd(_mm256_loadu_pd(c), c10));
+    _mm256_storeu_pd(c + 4, _mm256_add_pd(_mm256_loadu_pd(c + 4), c11));
+    c += k;
+    _mm256_storeu_pd(c, _mm256_add_pd(_mm256_loadu_pd(c), c20));
+    _mm256_storeu_pd(c + 4, _mm256_add_pd(_mm256_loadu_pd(c + 4), c21));
+    c += k;
+    _mm256_storeu_pd(c, _mm256_add_pd(_mm256_loadu_pd(c), c30));
+    _mm256_storeu_pd(c + 4, _mm256_add_pd(_mm256_loadu_pd(c + 4), c31));
+}
+#endif
+
+void gemm_tn(const double *X, const double *Y, int rows, int d, int k, double *C) {
+    // AVX-512 machines also take the AVX2 tile: k is usually small
+    int isa = kernel_isa();
+    int kc = panel_rows(d + k);
+    
+    for (int k0 = 0; k0 < rows; k0 += kc) {
+        int k1 = (k0 + kc < rows) ? k0 + kc : rows;
+        
+        for (int i0 = 0; i0 < d; i0 += GEMM_MR) {
+            int mr = (d - i0 < GEMM_MR) ? d - i0 : GEMM_MR;
+            for (int c0 = 0; c0 < k; c0 += GEMM_NR) {
+                int nr = (k - c0 < GEMM_NR) ? k - c0 : GEMM_NR;
+#ifdef KERNELS_X86
+                if (mr == GEMM_MR && nr == GEMM_NR && isa >= KERNEL_ISA_AVX2) {
+                    gemm_tn_tile_avx2(X, Y, d, k, k0, k1, i0, c0, C);
+                    continue;
+                }
+#endif
+                (void)isa;
+                gemm_tn_tile_scalar(X, Y, d, k, k0, k1, i0, mr, c0, nr, C);
+            }
+        }
+    }
+}
+
+void gd_gradient_fused_multi(
+    const double *X,
+    const double *Y,
+    const double *B,
+    int rows,
+    int d,
+    int k,
+    double *G,
+    double *r
+) {
+    // The inner loops run over the k contiguous targets and vectorise
+    for (int i = 0; i < rows; i++) {
+        const double *x = X + (size_t)i * d;
+        
+        // r = x * B - y_i
+        if (Y) {
+            const double *yi = Y + (size_t)i * k;
+            for (int c = 0; c < k; c++) {
+                r[c] = -yi[c];
+            }
+        } else {
+            memset(r, 0, k * sizeof(double));
+        }
+        for (int j = 0; j < d; j++) {
+            const double *b = B + (size_t)j * k;
+            double xj = x[j];
+            for (int c = 0; c < k; c++) {
+                r[c] += xj * b[c];
+            }
+        }
+        
+        // G += x^T * r
+        for (int j = 0; j < d; j++) {
+            double *g = G + (size_t)j * k;
+            double xj = x[j];
+            for (int c = 0; c < k; c++) {
+                g[c] += xj * r[c];
+            }
+        }
+    }
+}
+
+// Rows handled together by the fused gradient kernel
+#define GD_ROWS 4
+
+static void gd_gradient_scalar(const double *X, const double *y, const double *beta,
+                               int rows, int d, double *grad) {
+    for (int i = 0; i < rows; i++) {
+        const double *x = X + (size_t)i * d;
+        double pred = 0.0;
+        for (int j = 0; j < d; j++) {
+            pred += x[j] * beta[j];
+        }
+        double r = y ? pred - y[i] : pred;
+        for (int j = 0; j < d; j++) {
+            grad[j] += r * x[j];
+        }
+    }
+}
+
+#ifdef KERNELS_X86
+__attribute__((target("avx2,fma")))
+static double hsum_avx2(__m256d v) {
+    __m128d lo = _mm256_castpd256_pd128(v);
+    __m128d hi = _mm256_extractf128_pd(v, 1);
+    lo = _mm_add_pd(lo, hi);
+    return _mm_cvtsd_f64(lo) + _mm_cvtsd_f64(_mm_unpackhi_pd(lo, lo));
+}
+
+__attribute__((target("avx2,fma")))
+static void gd_gradient_avx2(const double *X, const double *y, const double *beta,
+                             int rows, int d, double *grad) {
+    int d4 = d & ~3;
+    int i = 0;
+    for (; i + GD_ROWS <= rows; i += GD_ROWS) {
+        const double *x0 = X + (size_t)i * d;
+        const double *x1 = x0 + d;
+        const double *x2 = x1 + d;
+        const double *x3 = x2 + d;
+        
+        // Predictions for four rows at once
+        __m256d p0 = _mm256_setzero_pd(), p1 = _mm256_setzero_pd();
+        __m256d p2 = _mm256_setzero_pd(), p3 = _mm256_setzero_pd();
+        for (int j = 0; j < d4; j += 4) {
+            __m256d b = _mm256_loadu_pd(beta + j);
+            p0 = _mm256_fmadd_pd(_mm256_loadu_pd(x0 + j), b, p0);
+            p1 = _mm256_fmadd_pd(_mm256_loadu_pd(x1 + j), b, p1);
+            p2 = _mm256_fmadd_pd(_mm256_loadu_pd(x2 + j), b, p2);
+            p3 = _mm256_fmadd_pd(_mm256_loadu_pd(x3 + j), b, p3);
+        }
+        double r0 = hsum_avx2(p0), r1 = hsum_avx2(p1);
+        double r2 = hsum_avx2(p2), r3 = hsum_avx2(p3);
+        for (int j = d4; j < d; j++) {
+            r0 += x0[j] * beta[j]; r1 += x1[j] * beta[j];
+            r2 += x2[j] * beta[j]; r3 += x3[j] * beta[j];
+        }
+        if (y) {
+            r0 -= y[i]; r1 -= y[i + 1]; r2 -= y[i + 2]; r3 -= y[i + 3];
+        }
+        
+        // Scatter the residuals while the rows are still in L1
+        __m256d v0 = _mm256_set1_pd(r0), v1 = _mm256_set1_pd(r1);
+        __m256d v2 = _mm256_set1_pd(r2), v3 = _mm256_set1_pd(r3);
+        for (int j = 0; j < d4; j += 4) {
+            __m256d g = _mm256_loadu_pd(grad + j);
+            g = _mm256_fmadd_pd(v0, _mm256_loadu_pd(x0 + j), g);
+            g = _mm256_fmadd_pd(v1, _mm256_loadu_pd(x1 + j), g);
+            g = _mm256_fmadd_pd(v2, _mm256_loadu_pd(x2 + j), g);
+            g = _mm256_fmadd_pd(v3, _mm256_loadu_pd(x3 + j), g);
+            _mm256_storeu_pd(grad + j, g);
+        }
+        for (int j = d4; j < d; j++) {
+            grad[j] += r0 * x0[j] + r1 * x1[j] + r2 * x2[j] + r3 * x3[j];
+        }
+    }
+    gd_gradient_scalar(X + (size_t)i * d, y ? y + i : NULL, beta, rows - i, d, grad);
+}
+
+__attribute__((target("avx512f")))
+static void gd_gradient_avx512(const double *X, const double *y, const double *beta,
+                               int rows, int d, double *grad) {
+    int d8 = d & ~7;
+    int i = 0;
+    for (; i + GD_ROWS <= rows; i += GD_ROWS) {
+        const double *x0 = X + (size_t)i * d;
+        const double *x1 = x0 + d;
+        const double *x2 = x1 + d;
+        const double *x3 = x2 + d;
+        
+        // Predictions for four rows at once
+        __m512d p0 = _mm512_setzero_pd(), p1 = _mm512_setzero_pd();
+        __m512d p2 = _mm512_setzero_pd(), p3 = _mm512_setzero_pd();
+        for (int j = 0; j < d8; j += 8) {
+            __m512d b = _mm512_loadu_pd(beta + j);
+            p0 = _mm512_fmadd_pd(_mm512_loadu_pd(x0 + j), b, p0);
+            p1 = _mm512_fmadd_pd(_mm512_loadu_pd(x1 + j), b, p1);
+            p2 = _mm512_fmadd_pd(_mm512_loadu_pd(x2 + j), b, p2);
+            p3 = _mm512_fmadd_pd(_mm512_loadu_pd(x3 + j), b, p3);
+        }
+        double r0 = _mm512_reduce_add_pd(p0), r1 = _mm512_reduce_add_pd(p1);
+        double r2 = _mm512_reduce_add_pd(p2), r3 = _mm512_reduce_add_pd(p3);
+        for (int j = d8; j < d; j++) {
+            r0 += x0[j] * beta[j]; r1 += x1[j] * beta[j];
+            r2 += x2[j] * beta[j]; r3 += x3[j] * beta[j];
+        }
+        if (y) {
+            r0 -= y[i]; r1 -= y[i + 1]; r2 -= y[i + 2]; r3 -= y[i + 3];
+        }
+        
+        // Scatter the residuals while the rows are still in L1
+        __m512d v0 = _mm512_set1_pd(r0), v1 = _mm512_set1_pd(r1);
+        __m512d v2 = _mm512_set1_pd(r2), v3 = _mm512_set1_pd(r3);
+        for (int j = 0; j < d8; j += 8) {
+            __m512d g = _mm512_loadu_pd(grad + j);
+            g = _mm512_fmadd_pd(v0, _mm512_loadu_pd(x0 + j), g);
+            g = _mm512_fmadd_pd(v1, _mm512_loadu_pd(x1 + j), g);
+            g = _mm512_fmadd_pd(v2, _mm512_loadu_pd(x2 + j), g);
+            g = _mm512_fmadd_pd(v3, _mm512_loadu_pd(x3 + j), g);
+            _mm512_storeu_pd(grad + j, g);
+        }
+        for (int j = d8; j < d; j++) {
+            grad[j] += r0 * x0[j] + r1 * x1[j] + r2 * x2[j] + r3 * x3[j];
+        }
+    }
+    gd_gradient_scalar(X + (size_t)i * d, y ? y + i : NULL, beta, rows - i, d, grad);
+}
+
+/*
+ * Vectorised precision conversions; each returns the number of
+ * elements handled, the caller finishes the tail
+ */
+__attribute__((target("avx2")))
+static size_t convert_f64_to_f32_avx2(const double *src, float *dst, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128 lo = _mm256_cvtpd_ps(_mm256_loadu_pd(src + i));
+        __m128 hi = _mm256_cvtpd_ps(_mm256_loadu_pd(src + i + 4));
+        _mm_storeu_ps(dst + i, lo);
+        _mm_storeu_ps(dst + i + 4, hi);
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static size_t convert_f32_to_f64_avx2(const float *src, double *dst, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_pd(dst + i, _mm256_cvtps_pd(_mm_loadu_ps(src + i)));
+        _mm256_storeu_pd(dst + i + 4, _mm256_cvtps_pd(_mm_loadu_ps(src + i + 4)));
+    }
+    return i;
+}
+
+__attribute__((target("avx512f")))
+static size_t convert_f32_to_f64_avx512(const float *src, double *dst, size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        _mm512_storeu_pd(dst + i, _mm512_cvtps_pd(_mm256_loadu_ps(src + i)));
+        _mm512_storeu_pd(dst + i + 8, _mm512_cvtps_pd(_mm256_loadu_ps(src + i + 8)));
+    }
+    return i;
+}
+#endif
+
+static void predict_rows_scalar(const double *X, const double *beta, int rows, int d,
+                                double *pred) {
+    for (int i = 0; i < rows; i++) {
+        const double *x = X + (size_t)i * d;
+        double p = 0.0;
+        for (int j = 0; j < d; j++) {
+            p += x[j] * beta[j];
+        }
+        pred[i] = p;
+    }
+}
+
+#ifdef KERNELS_X86
+__attribute__((target("avx2,fma")))
+static void predict_rows_avx2(const double *X, const double *beta, int rows, int d,
+                              double *pred) {
+    int d4 = d & ~3;
+    int i = 0;
+    for (; i + GD_ROWS <= rows; i += GD_ROWS) {
+        const double *x0 = X + (size_t)i * d;
+        const double *x1 = x0 + d;
+        const double *x2 = x1 + d;
+        const double *x3 = x2 + d;
+        __m256d p0 = _mm256_setzero_pd(), p1 = _mm256_setzero_pd();
+        __m256d p2 = _mm256_setzero_pd(), p3 = _mm256_setzero_pd();
+        for (int j = 0; j < d4; j += 4) {
+            __m256d b = _mm256_loadu_pd(beta + j);
+            p0 = _mm256_fmadd_pd(_mm256_loadu_pd(x0 + j), b, p0);
+            p1 = _mm256_fmadd_pd(_mm256_loadu_pd(x1 + j), b, p1);
+            p2 = _mm256_fmadd_pd(_mm256_loadu_pd(x2 + j), b, p2);
+            p3 = _mm256_fmadd_pd(_mm256_loadu_pd(x3 + j), b, p3);
+        }
+        double r0 = hsum_avx2(p0), r1 = hsum_avx2(p1);
+        double r2 = hsum_avx2(p2), r3 = hsum_avx2(p3);
+        for (int j = d4; j < d; j++) {
+            r0 += x0[j] * beta[j];
+            r1 += x1[j] * beta[j];
+            r2 += x2[j] * beta[j];
+            r3 += x3[j] * beta[j];
+        }
+        pred[i] = r0;
+        pred[i + 1] = r1;
+        pred[i + 2] = r2;
+        pred[i + 3] = r3;
+    }
+    predict_rows_scalar(X + (size_t)i * d, beta, rows - i, d, pred + i);
+}
+#endif
+
+void predict_rows(const double *X, const double *beta, int rows, int d, double *pred) {
+#ifdef KERNELS_X86
+    // Memory bound: AVX-512 machines take the AVX2 path
+    if (kernel_isa() >= KERNEL_ISA_AVX2 && d >= 4) {
+        predict_rows_avx2(X, beta, rows, d, pred);
+        return;
+    }
+#endif
+    predict_rows_scalar(X, beta, rows, d, pred);
+}
+
+void gd_gradient_fused(
+    const double *X,
+    const double *y,
+    const double *beta,
+    int rows,
+    int d,
+    double *grad
+) {
+#ifdef KERNELS_X86
+    int isa = kernel_isa();
+    if (isa == KERNEL_ISA_AVX512 && d >= 8) {
+        gd_gradient_avx512(X, y, beta, rows, d, grad);
+        return;
+    }
+    if (isa >= KERNEL_ISA_AVX2 && d >= 4) {
+        gd_gradient_avx2(X, y, beta, rows, d, grad);
+        return;
+    }
+#endif
+    gd_gradient_scalar(X, y, beta, rows, d, grad);
+}
+
+void convert_f64_to_f32(const double *src, float *dst, size_t count) {
+    size_t i = 0;
+#ifdef KERNELS_X86
+    if (kernel_isa() >= KERNEL_ISA_AVX2) {
+        i = convert_f64_to_f32_avx2(src, dst, count);
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = (float)src[i];
+    }
+}
+
+void convert_f32_to_f64(const float *src, double *dst, size_t count) {
+    size_t i = 0;
+#ifdef KERNELS_X86
+    int isa = kernel_isa();
+    if (isa == KERNEL_ISA_AVX512) {
+        i = convert_f32_to_f64_avx512(src, dst, count);
+    } else if (isa == KERNEL_ISA_AVX2) {
+        i = convert_f32_to_f64_avx2(src, dst, count);
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = (double)src[i];
+    }
+}
+
+/*
+ * Rows widened at a time by gd_gradient_fused_f32: small enough to stay
+ * in L1, and a multiple of GD_ROWS so only the last block has a scalar
+ * tail
+ */
+static int widen_block_rows(int d) {
+    int block = WIDEN_BLOCK_BYTES / ((int)sizeof(double) * (d > 0 ? d : 1));
+    block -= block % GD_ROWS;
+    if (block < GD_ROWS) block = GD_ROWS;
+    return block;
+}
+
+size_t syrk_lower_f32_scratch(int d) {
+    return (size_t)panel_rows(d) * d;
+}
+
+void syrk_lower_f32(const float *X, int rows, int d, double *C, double *scratch) {
+    // Widen one L2 panel at a time, so X crosses the memory bus as float32
+    int kc = panel_rows(d);
+    for (int k0 = 0; k0 < rows; k0 += kc) {
+        int kn = (rows - k0 < kc) ? rows - k0 : kc;
+        convert_f32_to_f64(X + (size_t)k0 * d, scratch, (size_t)kn * d);
+        syrk_lower(scratch, kn, d, C);
+    }
+}
+
+size_t gd_gradient_fused_f32_scratch(int d) {
+    return (size_t)widen_block_rows(d) * d;
+}
+
+void gd_gradient_fused_f32(
+    const float *X,
+    const double *y,
+    const double *beta,
+    int rows,
+    int d,
+    double *grad,
+    double *scratch
+) {
+    // Widen row blocks and run the float64 kernel on them
+    int block = widen_block_rows(d);
+    for (int k0 = 0; k0 < rows; k0 += block) {
+        int kn = (rows - k0 < block) ? rows - k0 : block;
+        convert_f32_to_f64(X + (size_t)k0 * d, scratch, (size_t)kn * d);
+        gd_gradient_fused(scratch, y ? y + k0 : NULL, beta, kn, d, grad);
+    }
+}
+
+void csr_syrk_lower(
+    const int *row_ptr,
+    const int *col_idx,
+    const double *val,
+    int rows,
+    int d,
+    double *C
+) {
+    for (int i = 0; i < rows; i++) {
+        int first = row_ptr[i];
+        int end = row_ptr[i + 1];
+        // Columns increase along the row, so b <= a gives col[b] <= col[a]
+        for (int a = first; a < end; a++) {
+            double *c_row = C + (size_t)col_idx[a] * d;
+            double va = val[a];
+            for (int b = first; b <= a; b++) {
+                c_row[col_idx[b]] += va * val[b];
+            }
+        }
+    }
+}
+
+void csr_spmv_t(
+    const int *row_ptr,
+    const int *col_idx,
+    const double *val,
+    int rows,
+    const double *v,
+    double *out
+) {
+    for (int i = 0; i < rows; i++) {
+        double vi = v[i];
+        for (int p = row_ptr[i]; p < row_ptr[i + 1]; p++) {
+            out[col_idx[p]] += val[p] * vi;
+        }
+    }
+}
+
+void csr_gradient_fused(
+    const int *row_ptr,
+    const int *col_idx,
+    const double *val,
+    const double *y,
+    const double *beta,
+    int rows,
+    double *grad
+) {
+    for (int i = 0; i < rows; i++) {
+        int first = row_ptr[i];
+        int end = row_ptr[i + 1];
+        double pred = 0.0;
+        for (int p = first; p < end; p++) {
+            pred += val[p] * beta[col_idx[p]];
+        }
+        double r = y ? pred - y[i] : pred;
+        for (int p = first; p < end; p++) {
+            grad[col_idx[p]] += r * val[p];
+        }
+    }
+}
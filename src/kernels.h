@@ -0,0 +1,217 @@
+/*
+ * kernels.h - Vectorised compute kernels
+ * 
+ * Cache-blocked kernels for the hot loops of the solvers, with AVX2 and
+ * AVX-512 code paths selected at runtime and a portable scalar fallback.
+ * Set PLR_KERNEL_ISA=scalar|avx2|avx512 to force a path (never above
+ * what the CPU supports).
+ */
+
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <stddef.h>
+
+#define KERNEL_ISA_SCALAR 0
+#define KERNEL_ISA_AVX2   1
+#define KERNEL_ISA_AVX512 2
+
+/*
+ * Instruction set used by the kernels (detected on first call)
+ */
+int kernel_isa(void);
+
+/*
+ * Printable name of kernel_isa()
+ */
+const char *kernel_isa_name(void);
+
+/*
+ * Symmetric rank-k update, lower triangle only: C += X^T * X
+ * 
+ * Only entries C[i][j] with j <= i are updated; the strict upper
+ * triangle is left untouched. Call syrk_mirror once all updates (and
+ * reductions) are done to obtain the full matrix.
+ * 
+ * Parameters:
+ *   X - rows x d row-major block
+ *   rows - number of rows in the block
+ *   d - number of features
+ *   C - d x d row-major accumulator
+ */
+void syrk_lower(const double *X, int rows, int d, double *C);
+
+/*
+ * Copy the lower triangle of C into the upper triangle
+ */
+void syrk_mirror(double *C, int d);
+
+/*
+ * Fused least-squares gradient: grad += X^T * (X * beta - y)
+ * 
+ * Each row's residual is formed and immediately scattered back into
+ * the gradient while the row is still in L1, so X is read from memory
+ * once and no n-length temporaries are needed.
+ * 
+ * Parameters:
+ *   X - rows x d row-major block
+ *   y - rows x 1 responses, or NULL for grad += X^T * X * beta
+ *   beta - d x 1 current parameters
+ *   rows - number of rows in the block
+ *   d - number of features
+ *   grad - d x 1 accumulator
+ */
+void gd_gradient_fused(
+    const double *X,
+    const double *y,
+    const double *beta,
+    int rows,
+    int d,
+    double *grad
+);
+
+/*
+ * General product with X transposed: C += X^T * Y
+ * 
+ * Used for the multi-target right-hand sides X^T * Y. Rows are
+ * processed in L2-sized panels and C is updated in 4 x 8 register
+ * tiles, so each panel of X and Y is loaded once per tile.
+ * 
+ * Parameters:
+ *   X - rows x d row-major block
+ *   Y - rows x k row-major block
+ *   rows - number of rows in the block
+ *   d - number of features
+ *   k - number of targets
+ *   C - d x k row-major accumulator
+ */
+void gemm_tn(const double *X, const double *Y, int rows, int d, int k, double *C);
+
+/*
+ * Multi-target fused gradient: G += X^T * (X * B - Y)
+ * 
+ * gd_gradient_fused with a d x k parameter matrix; each row's k
+ * residuals are formed once and scattered back while the row is in L1.
+ * 
+ * Parameters:
+ *   X - rows x d row-major block
+ *   Y - rows x k responses, or NULL for G += X^T * X * B
+ *   B - d x k current parameters
+ *   rows - number of rows in the block
+ *   d - number of features
+ *   k - number of targets
+ *   G - d x k accumulator
+ *   r - k doubles of caller scratch for one row's residuals
+ */
+void gd_gradient_fused_multi(
+    const double *X,
+    const double *Y,
+    const double *B,
+    int rows,
+    int d,
+    int k,
+    double *G,
+    double *r
+);
+
+/*
+ * Row-wise predictions: pred = X * beta
+ * 
+ * Four rows share each load of beta, with one vector accumulator per
+ * row, so the kernel streams X at memory bandwidth.
+ * 
+ * Parameters:
+ *   X - rows x d row-major block
+ *   beta - d x 1 parameters
+ *   rows - number of rows in the block
+ *   d - number of features
+ *   pred - rows x 1 predictions (output)
+ */
+void predict_rows(const double *X, const double *beta, int rows, int d, double *pred);
+
+/*
+ * Sparse (CSR) kernels
+ * 
+ * Rows are given by rows + 1 offsets row_ptr into col_idx/val, with
+ * strictly increasing columns within a row (see sparse.h). The work is
+ * proportional to the nonzeros, never to rows x d; scalar code, since
+ * the column gathers dominate.
+ */
+
+/*
+ * Sparse SYRK, lower triangle only: C += X^T * X
+ * 
+ * Each row adds its nonzero pairs (a, b) with col[b] <= col[a], i.e.
+ * nnz_row * (nnz_row + 1) / 2 updates. Finish with syrk_mirror.
+ */
+void csr_syrk_lower(
+    const int *row_ptr,
+    const int *col_idx,
+    const double *val,
+    int rows,
+    int d,
+    double *C
+);
+
+/*
+ * Transposed sparse matrix-vector product: out += X^T * v
+ * (out is d x 1, v is rows x 1)
+ */
+void csr_spmv_t(
+    const int *row_ptr,
+    const int *col_idx,
+    const double *val,
+    int rows,
+    const double *v,
+    double *out
+);
+
+/*
+ * Fused sparse gradient: grad += X^T * (X * beta - y)
+ * 
+ * Row by row, the SpMV dot product with beta is followed at once by
+ * the SpMV^T scatter of the residual into the row's columns, so each
+ * row's nonzeros are read once. y may be NULL (grad += X^T * X * beta).
+ */
+void csr_gradient_fused(
+    const int *row_ptr,
+    const int *col_idx,
+    const double *val,
+    const double *y,
+    const double *beta,
+    int rows,
+    double *grad
+);
+
+/*
+ * Mixed precision: X stored as float32, all sums in float64
+ * 
+ * Same results as the float64 kernels applied to the widened rows.
+ * Rows are converted block by block into a cache-resident buffer, so X
+ * is read from memory at half the bytes. The buffer is caller scratch
+ * of *_scratch(d) doubles (one per thread), so the kernels never
+ * allocate.
+ */
+size_t syrk_lower_f32_scratch(int d);
+
+void syrk_lower_f32(const float *X, int rows, int d, double *C, double *scratch);
+
+size_t gd_gradient_fused_f32_scratch(int d);
+
+void gd_gradient_fused_f32(
+    const float *X,
+    const double *y,
+    const double *beta,
+    int rows,
+    int d,
+    double *grad,
+    double *scratch
+);
+
+/*
+ * Vectorised precision conversion of count elements
+ */
+void convert_f64_to_f32(const double *src, float *dst, size_t count);
+void convert_f32_to_f64(const float *src, double *dst, size_t count);
+
+#endif // KERNELS_H
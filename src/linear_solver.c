@@ -1,10 +1,13 @@
 /*
- * linear_solver.c - Gaussian elimination implementation
+ * linear_solver.c - Gaussian elimination and Cholesky implementation
  */
 
 #include "linear_solver.h"
+#include "workspace.h"
 #include <stdio.h>
 #include <math.h>
+#include <stdlib.h>
+#include <string.h>
 
 int solve_linear_system(double *A, double *b, double *x, int n) {
     const double EPSILON = 1e-12;
@@ -61,3 +64,623 @@ int solve_linear_system(double *A, double *b, double *x, int n) {
     
     return 0; // Success
 }
+
+// Block size of the right-looking Cholesky
+#define CHOL_NB 64
+
+// Column block of the trailing update, sized so the packed panel
+// (CHOL_NB x CHOL_JB) stays in L2
+#define CHOL_JB 256
+
+// Relative tolerance for treating a pivot as zero
+#define PIVOT_RTOL 1e-13
+
+// Ridge jitter retries: delta = JITTER_START * mean(diag(A)) * 10^k
+#define JITTER_START 1e-10
+#define JITTER_TRIES 4
+
+/*
+ * Unblocked Cholesky of the kb x kb diagonal block starting at (k0, k0)
+ */
+static int cholesky_diag_block(double *A, int n, int k0, int kb, double tol) {
+    for (int j = k0; j < k0 + kb; j++) {
+        double *row_j = A + (size_t)j * n;
+        double sum = row_j[j];
+        for (int p = k0; p < j; p++) {
+            sum -= row_j[p] * row_j[p];
+        }
+        if (!(sum > tol)) {
+            return -1;
+        }
+        row_j[j] = sqrt(sum);
+        
+        for (int i = j + 1; i < k0 + kb; i++) {
+            double *row_i = A + (size_t)i * n;
+            double s = row_i[j];
+            for (int p = k0; p < j; p++) {
+                s -= row_i[p] * row_j[p];
+            }
+            row_i[j] = s / row_j[j];
+        }
+    }
+    return 0;
+}
+
+/*
+ * Blocked right-looking Cholesky factorisation A = L * L^T
+ * 
+ * Only the lower triangle of A is read; on success it is overwritten
+ * with L (the strict upper triangle is left untouched). panel_t is the
+ * caller's CHOL_NB x n buffer for the transposed panel. Returns 0, or
+ * -1 if A is not (numerically) positive definite.
+ */
+static int cholesky_factor_panel(double *A, int n, double *panel_t) {
+    // Pivots this small relative to the diagonal mean rank deficiency
+    double max_diag = 0.0;
+    for (int i = 0; i < n; i++) {
+        if (fabs(A[(size_t)i * n + i]) > max_diag) max_diag = fabs(A[(size_t)i * n + i]);
+    }
+    double tol = PIVOT_RTOL * n * max_diag;
+    
+    for (int k0 = 0; k0 < n; k0 += CHOL_NB) {
+        int kb = (n - k0 < CHOL_NB) ? n - k0 : CHOL_NB;
+        int k1 = k0 + kb;
+        
+        // 1. Factor the diagonal block: A11 = L11 * L11^T
+        if (cholesky_diag_block(A, n, k0, kb, tol) != 0) {
+            return -1;
+        }
+        
+        // 2. Panel below the diagonal block: L21 = A21 * L11^{-T}
+        for (int i = k1; i < n; i++) {
+            double *row_i = A + (size_t)i * n;
+            for (int j = k0; j < k1; j++) {
+                const double *row_j = A + (size_t)j * n;
+                double s = row_i[j];
+                for (int p = k0; p < j; p++) {
+                    s -= row_i[p] * row_j[p];
+                }
+                row_i[j] = s / row_j[j];
+            }
+            for (int p = 0; p < kb; p++) {
+                panel_t[(size_t)p * n + i] = row_i[k0 + p];
+            }
+        }
+        
+        // 3. Trailing update (lower triangle): A22 -= L21 * L21^T
+        // Inner loop is a contiguous axpy over row i, so it vectorises
+        for (int jb = k1; jb < n; jb += CHOL_JB) {
+            int je = (jb + CHOL_JB < n) ? jb + CHOL_JB : n;
+            for (int i = jb; i < n; i++) {
+                double *row_i = A + (size_t)i * n;
+                int j_end = (i + 1 < je) ? i + 1 : je;
+                for (int p = 0; p < kb; p++) {
+                    double a = row_i[k0 + p];
+                    const double *pt = panel_t + (size_t)p * n;
+                    for (int j = jb; j < j_end; j++) {
+                        row_i[j] -= a * pt[j];
+                    }
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+void cholesky_solve(const double *L, double *b, int n) {
+    // Forward substitution: L * z = b
+    for (int i = 0; i < n; i++) {
+        const double *row_i = L + (size_t)i * n;
+        double s = b[i];
+        for (int j = 0; j < i; j++) {
+            s -= row_i[j] * b[j];
+        }
+        b[i] = s / row_i[i];
+    }
+    
+    // Back substitution: L^T * x = z (column sweep keeps rows contiguous)
+    for (int i = n - 1; i >= 0; i--) {
+        const double *row_i = L + (size_t)i * n;
+        b[i] /= row_i[i];
+        double xi = b[i];
+        for (int j = 0; j < i; j++) {
+            b[j] -= row_i[j] * xi;
+        }
+    }
+}
+
+void cholesky_solve_multi(const double *L, double *B, int n, int k) {
+    // Same sweeps as cholesky_solve, with whole rows of B as the unknowns
+    for (int i = 0; i < n; i++) {
+        const double *row_i = L + (size_t)i * n;
+        double *b_i = B + (size_t)i * k;
+        for (int j = 0; j < i; j++) {
+            const double *b_j = B + (size_t)j * k;
+            double l = row_i[j];
+            for (int c = 0; c < k; c++) {
+                b_i[c] -= l * b_j[c];
+            }
+        }
+        for (int c = 0; c < k; c++) {
+            b_i[c] /= row_i[i];
+        }
+    }
+    
+    for (int i = n - 1; i >= 0; i--) {
+        const double *row_i = L + (size_t)i * n;
+        double *b_i = B + (size_t)i * k;
+        for (int c = 0; c < k; c++) {
+            b_i[c] /= row_i[i];
+        }
+        for (int j = 0; j < i; j++) {
+            double *b_j = B + (size_t)j * k;
+            double l = row_i[j];
+            for (int c = 0; c < k; c++) {
+                b_j[c] -= l * b_i[c];
+            }
+        }
+    }
+}
+
+/*
+ * LDL^T with symmetric diagonal pivoting (largest remaining diagonal)
+ * 
+ * Stops when the remaining diagonal is negligible and returns the basic
+ * solution with the trailing (dependent) unknowns set to zero.
+ * 
+ * Returns:
+ *   rank on success, -1 if a significantly negative pivot is found
+ */
+static int ldlt_pivoted_solve(double *A, double *b, double *x, int n) {
+    int *perm = (int *)malloc(n * sizeof(int));
+    double *col = (double *)malloc(n * sizeof(double));
+    for (int i = 0; i < n; i++) perm[i] = i;
+    
+    // Mirror to a full symmetric matrix so row/column swaps are simple
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < i; j++) {
+            A[(size_t)j * n + i] = A[(size_t)i * n + j];
+        }
+    }
+    
+    double max_diag = 0.0;
+    for (int i = 0; i < n; i++) {
+        if (fabs(A[(size_t)i * n + i]) > max_diag) max_diag = fabs(A[(size_t)i * n + i]);
+    }
+    double tol = PIVOT_RTOL * n * max_diag;
+    
+    int rank = n;
+    for (int k = 0; k < n; k++) {
+        // Pick the largest remaining diagonal entry
+        int piv = k;
+        for (int i = k + 1; i < n; i++) {
+            if (A[(size_t)i * n + i] > A[(size_t)piv * n + piv]) piv = i;
+        }
+        double dk = A[(size_t)piv * n + piv];
+        // Negative, or NaN from non-finite data: not semidefinite
+        if (!(dk >= -tol)) {
+            free(perm);
+            free(col);
+            return -1;
+        }
+        if (dk <= tol) {
+            rank = k;
+            break;
+        }
+        
+        // Symmetric swap of rows/columns k and piv
+        if (piv != k) {
+            for (int j = 0; j < n; j++) {
+                double t = A[(size_t)k * n + j];
+                A[(size_t)k * n + j] = A[(size_t)piv * n + j];
+                A[(size_t)piv * n + j] = t;
+            }
+            for (int i = 0; i < n; i++) {
+                double t = A[(size_t)i * n + k];
+                A[(size_t)i * n + k] = A[(size_t)i * n + piv];
+                A[(size_t)i * n + piv] = t;
+            }
+            double t = b[k]; b[k] = b[piv]; b[piv] = t;
+            int tp = perm[k]; perm[k] = perm[piv]; perm[piv] = tp;
+        }
+        
+        // Trailing update A22 -= c * c^T / dk (kept symmetric), then
+        // store column k of L below the diagonal
+        for (int i = k + 1; i < n; i++) {
+            col[i] = A[(size_t)i * n + k];
+        }
+        for (int i = k + 1; i < n; i++) {
+            double ci = col[i] / dk;
+            double *row_i = A + (size_t)i * n;
+            for (int j = k + 1; j <= i; j++) {
+                row_i[j] -= ci * col[j];
+                A[(size_t)j * n + i] = row_i[j];
+            }
+            row_i[k] = ci;
+        }
+    }
+    
+    // Solve the leading rank x rank system: L * D * L^T * z = b
+    double *z = (double *)calloc(n, sizeof(double));
+    for (int i = 0; i < rank; i++) {
+        double s = b[i];
+        for (int j = 0; j < i; j++) {
+            s -= A[(size_t)i * n + j] * z[j];
+        }
+        z[i] = s;
+    }
+    for (int i = 0; i < rank; i++) {
+        z[i] /= A[(size_t)i * n + i];
+    }
+    for (int i = rank - 1; i >= 0; i--) {
+        double s = z[i];
+        for (int j = i + 1; j < rank; j++) {
+            s -= A[(size_t)j * n + i] * z[j];
+        }
+        z[i] = s;
+    }
+    
+    // Undo the permutation; dependent unknowns stay zero
+    for (int i = 0; i < n; i++) {
+        x[perm[i]] = z[i];
+    }
+    
+    free(z);
+    free(col);
+    free(perm);
+    return rank;
+}
+
+/*
+ * solve_spd_system with the Cholesky panel and the copies of A and b
+ * carved from scratch (or a one-off workspace if NULL); only the
+ * LDL^T fallback allocates
+ */
+static int solve_spd_system_scratch(double *A, double *b, double *x, int n,
+                                    workspace_t *scratch) {
+    size_t A_bytes = workspace_bytes((size_t)n * n, sizeof(double));
+    size_t b_bytes = workspace_bytes(n, sizeof(double));
+    size_t panel_bytes = workspace_bytes((size_t)CHOL_NB * n, sizeof(double));
+    workspace_t temp;
+    size_t mark;
+    workspace_t *ws = workspace_begin(scratch, &temp, A_bytes + b_bytes + panel_bytes, &mark);
+    if (!ws) {
+        fprintf(stderr, "Error: Memory allocation failed in solve_spd_system\n");
+        return -1;
+    }
+    double *panel_t = (double *)workspace_alloc(ws, panel_bytes);
+    
+    // Keep the original lower triangle and b for the fallbacks
+    double *A_orig = (double *)workspace_alloc(ws, A_bytes);
+    double *b_orig = (double *)workspace_alloc(ws, b_bytes);
+    memcpy(A_orig, A, (size_t)n * n * sizeof(double));
+    memcpy(b_orig, b, n * sizeof(double));
+    int status = -1;
+    
+    // 1. Cholesky
+    if (cholesky_factor_panel(A, n, panel_t) == 0) {
+        cholesky_solve(A, b, n);
+        memcpy(x, b, n * sizeof(double));
+        status = 0;
+        goto done;
+    }
+    
+    // 2. Pivoted LDL^T for positive semidefinite matrices
+    memcpy(A, A_orig, (size_t)n * n * sizeof(double));
+    memcpy(b, b_orig, n * sizeof(double));
+    int rank = ldlt_pivoted_solve(A, b, x, n);
+    if (rank >= 0) {
+        fprintf(stderr, "Warning: Matrix is not positive definite (rank %d of %d), "
+                        "using pivoted LDL^T\n", rank, n);
+        status = 0;
+        goto done;
+    }
+    
+    // 3. Indefinite (rounding): ridge jitter on the diagonal
+    double mean_diag = 0.0;
+    for (int i = 0; i < n; i++) {
+        mean_diag += fabs(A_orig[(size_t)i * n + i]);
+    }
+    mean_diag = (mean_diag > 0.0) ? mean_diag / n : 1.0;
+    
+    double jitter = JITTER_START * mean_diag;
+    for (int t = 0; t < JITTER_TRIES; t++, jitter *= 10.0) {
+        memcpy(A, A_orig, (size_t)n * n * sizeof(double));
+        memcpy(b, b_orig, n * sizeof(double));
+        for (int i = 0; i < n; i++) {
+            A[(size_t)i * n + i] += jitter;
+        }
+        if (cholesky_factor_panel(A, n, panel_t) == 0) {
+            fprintf(stderr, "Warning: Matrix is indefinite, added ridge jitter %.3e\n", jitter);
+            cholesky_solve(A, b, n);
+            memcpy(x, b, n * sizeof(double));
+            status = 0;
+            goto done;
+        }
+    }
+    fprintf(stderr, "Error: Matrix is not positive semidefinite\n");
+    
+done:
+    workspace_end(ws, &temp, mark);
+    return status;
+}
+
+int solve_spd_system(double *A, double *b, double *x, int n) {
+    return solve_spd_system_scratch(A, b, x, n, NULL);
+}
+
+int solve_spd_system_multi(double *A, double *B, double *X, int n, int k,
+                           workspace_t *scratch) {
+    if (k == 1) {
+        return solve_spd_system_scratch(A, B, X, n, scratch);
+    }
+    
+    size_t A_bytes = workspace_bytes((size_t)n * n, sizeof(double));
+    size_t b_bytes = workspace_bytes(n, sizeof(double));
+    size_t panel_bytes = workspace_bytes((size_t)CHOL_NB * n, sizeof(double));
+    workspace_t temp;
+    size_t mark;
+    workspace_t *ws = workspace_begin(scratch, &temp, A_bytes + 2 * b_bytes + panel_bytes,
+                                      &mark);
+    if (!ws) {
+        fprintf(stderr, "Error: Memory allocation failed in solve_spd_system_multi\n");
+        return -1;
+    }
+    double *panel_t = (double *)workspace_alloc(ws, panel_bytes);
+    
+    // Keep the original lower triangle for the fallbacks
+    double *A_orig = (double *)workspace_alloc(ws, A_bytes);
+    memcpy(A_orig, A, (size_t)n * n * sizeof(double));
+    
+    // 1. One Cholesky factorisation shared by all right-hand sides
+    if (cholesky_factor_panel(A, n, panel_t) == 0) {
+        cholesky_solve_multi(A, B, n, k);
+        memcpy(X, B, (size_t)n * k * sizeof(double));
+        workspace_end(ws, &temp, mark);
+        return 0;
+    }
+    
+    // 2. Not positive definite: solve each column with the fallbacks
+    double *b = (double *)workspace_alloc(ws, b_bytes);
+    double *x = (double *)workspace_alloc(ws, b_bytes);
+    int status = 0;
+    for (int c = 0; c < k && status == 0; c++) {
+        memcpy(A, A_orig, (size_t)n * n * sizeof(double));
+        for (int i = 0; i < n; i++) {
+            b[i] = B[(size_t)i * k + c];
+        }
+        status = solve_spd_system_scratch(A, b, x, n, ws);
+        for (int i = 0; i < n; i++) {
+            X[(size_t)i * k + c] = x[i];
+        }
+    }
+    
+    workspace_end(ws, &temp, mark);
+    return status;
+}
+
+// QL sweeps allowed per eigenvalue before giving up
+#define EIGEN_MAX_SWEEPS 60
+
+/*
+ * Householder tridiagonalisation (tred2): on return V holds the
+ * accumulated orthogonal transform, w the diagonal and e the
+ * subdiagonal (e[0] unused)
+ */
+static void tridiagonalize(double *V, int n, double *w, double *e) {
+#define V_(i, j) V[(size_t)(i) * n + (j)]
+    for (int j = 0; j < n; j++) {
+        w[j] = V_(n - 1, j);
+    }
+    
+    for (int i = n - 1; i > 0; i--) {
+        double scale = 0.0;
+        double h = 0.0;
+        for (int k = 0; k < i; k++) {
+            scale += fabs(w[k]);
+        }
+        if (scale == 0.0) {
+            e[i] = w[i - 1];
+            for (int j = 0; j < i; j++) {
+                w[j] = V_(i - 1, j);
+                V_(i, j) = 0.0;
+                V_(j, i) = 0.0;
+            }
+        } else {
+            // Householder vector from row i
+            for (int k = 0; k < i; k++) {
+                w[k] /= scale;
+                h += w[k] * w[k];
+            }
+            double f = w[i - 1];
+            double g = sqrt(h);
+            if (f > 0) g = -g;
+            e[i] = scale * g;
+            h -= f * g;
+            w[i - 1] = f - g;
+            for (int j = 0; j < i; j++) {
+                e[j] = 0.0;
+            }
+            
+            // Apply the similarity transform to the remaining columns
+            for (int j = 0; j < i; j++) {
+                f = w[j];
+                V_(j, i) = f;
+                g = e[j] + V_(j, j) * f;
+                for (int k = j + 1; k <= i - 1; k++) {
+                    g += V_(k, j) * w[k];
+                    e[k] += V_(k, j) * f;
+                }
+                e[j] = g;
+            }
+            f = 0.0;
+            for (int j = 0; j < i; j++) {
+                e[j] /= h;
+                f += e[j] * w[j];
+            }
+            double hh = f / (h + h);
+            for (int j = 0; j < i; j++) {
+                e[j] -= hh * w[j];
+            }
+            for (int j = 0; j < i; j++) {
+                f = w[j];
+                g = e[j];
+                for (int k = j; k <= i - 1; k++) {
+                    V_(k, j) -= (f * e[k] + g * w[k]);
+                }
+                w[j] = V_(i - 1, j);
+                V_(i, j) = 0.0;
+            }
+        }
+        w[i] = h;
+    }
+    
+    // Accumulate the transformations
+    for (int i = 0; i < n - 1; i++) {
+        V_(n - 1, i) = V_(i, i);
+        V_(i, i) = 1.0;
+        double h = w[i + 1];
+        if (h != 0.0) {
+            for (int k = 0; k <= i; k++) {
+                w[k] = V_(k, i + 1) / h;
+            }
+            for (int j = 0; j <= i; j++) {
+                double g = 0.0;
+                for (int k = 0; k <= i; k++) {
+                    g += V_(k, i + 1) * V_(k, j);
+                }
+                for (int k = 0; k <= i; k++) {
+                    V_(k, j) -= g * w[k];
+                }
+            }
+        }
+        for (int k = 0; k <= i; k++) {
+            V_(k, i + 1) = 0.0;
+        }
+    }
+    for (int j = 0; j < n; j++) {
+        w[j] = V_(n - 1, j);
+        V_(n - 1, j) = 0.0;
+    }
+    V_(n - 1, n - 1) = 1.0;
+    e[0] = 0.0;
+#undef V_
+}
+
+/*
+ * Implicit QL iteration on the tridiagonal matrix (tql2), rotating the
+ * eigenvectors in V; eigenvalues are sorted ascending at the end
+ */
+static int tridiagonal_ql(double *V, int n, double *w, double *e) {
+#define V_(i, j) V[(size_t)(i) * n + (j)]
+    for (int i = 1; i < n; i++) {
+        e[i - 1] = e[i];
+    }
+    e[n - 1] = 0.0;
+    
+    double f = 0.0;
+    double tst1 = 0.0;
+    const double eps = 2.220446049250313e-16;
+    for (int l = 0; l < n; l++) {
+        // Find a small subdiagonal element
+        double t = fabs(w[l]) + fabs(e[l]);
+        if (t > tst1) tst1 = t;
+        int m = l;
+        while (m < n - 1 && fabs(e[m]) > eps * tst1) {
+            m++;
+        }
+        
+        // Converged unless e[l] is still significant
+        if (m > l) {
+            int sweeps = 0;
+            do {
+                if (++sweeps > EIGEN_MAX_SWEEPS) {
+                    return -1;
+                }
+                
+                // Implicit shift
+                double g = w[l];
+                double p = (w[l + 1] - g) / (2.0 * e[l]);
+                double r = hypot(p, 1.0);
+                if (p < 0) r = -r;
+                w[l] = e[l] / (p + r);
+                w[l + 1] = e[l] * (p + r);
+                double dl1 = w[l + 1];
+                double h = g - w[l];
+                for (int i = l + 2; i < n; i++) {
+                    w[i] -= h;
+                }
+                f += h;
+                
+                // Implicit QL transformation
+                p = w[m];
+                double c = 1.0, c2 = 1.0, c3 = 1.0;
+                double el1 = e[l + 1];
+                double s = 0.0, s2 = 0.0;
+                for (int i = m - 1; i >= l; i--) {
+                    c3 = c2;
+                    c2 = c;
+                    s2 = s;
+                    g = c * e[i];
+                    h = c * p;
+                    r = hypot(p, e[i]);
+                    e[i + 1] = s * r;
+                    s = e[i] / r;
+                    c = p / r;
+                    p = c * w[i] - s * g;
+                    w[i + 1] = h + s * (c * g + s * w[i]);
+                    
+                    for (int k = 0; k < n; k++) {
+                        h = V_(k, i + 1);
+                        V_(k, i + 1) = s * V_(k, i) + c * h;
+                        V_(k, i) = c * V_(k, i) - s * h;
+                    }
+                }
+                p = -s * s2 * c3 * el1 * e[l] / dl1;
+                e[l] = s * p;
+                w[l] = c * p;
+            } while (fabs(e[l]) > eps * tst1);
+        }
+        w[l] += f;
+        e[l] = 0.0;
+    }
+    
+    // Selection sort of eigenvalues (and columns of V) ascending
+    for (int i = 0; i < n - 1; i++) {
+        int k = i;
+        double p = w[i];
+        for (int j = i + 1; j < n; j++) {
+            if (w[j] < p) {
+                k = j;
+                p = w[j];
+            }
+        }
+        if (k != i) {
+            w[k] = w[i];
+            w[i] = p;
+            for (int j = 0; j < n; j++) {
+                double tmp = V_(j, i);
+                V_(j, i) = V_(j, k);
+                V_(j, k) = tmp;
+            }
+        }
+    }
+    return 0;
+#undef V_
+}
+
+int symmetric_eigen(const double *A, int n, double *w, double *V) {
+    double *e = (double *)malloc(n * sizeof(double));
+    if (!e) {
+        fprintf(stderr, "Error: Memory allocation failed in symmetric_eigen\n");
+        return -1;
+    }
+    memcpy(V, A, (size_t)n * n * sizeof(double));
+    tridiagonalize(V, n, w, e);
+    int status = tridiagonal_ql(V, n, w, e);
+    free(e);
+    if (status != 0) {
+        fprintf(stderr, "Error: Symmetric eigensolver did not converge\n");
+    }
+    return status;
+}
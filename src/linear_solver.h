@@ -1,12 +1,15 @@
 /*
  * linear_solver.h - Linear system solver
  * 
- * Gaussian elimination for solving linear systems
+ * Gaussian elimination for general systems, and a blocked Cholesky
+ * solver for the symmetric positive (semi)definite normal equations
  */
 
 #ifndef LINEAR_SOLVER_H
 #define LINEAR_SOLVER_H
 
+#include "workspace.h"
+
 /*
  * Solve linear system Ax = b using Gaussian elimination
  * 
@@ -21,4 +24,87 @@
  */
 int solve_linear_system(double *A, double *b, double *x, int n);
 
+/*
+ * Solve L * L^T * x = b given a Cholesky factor L of A
+ * 
+ * Parameters:
+ *   L - n x n factor (lower triangle)
+ *   b - n x 1 right-hand side, overwritten with the solution
+ *   n - size of the system
+ */
+void cholesky_solve(const double *L, double *b, int n);
+
+/*
+ * cholesky_solve for k right-hand sides at once
+ * 
+ * Parameters:
+ *   L - n x n factor (lower triangle)
+ *   B - n x k row-major right-hand sides, overwritten with the solutions
+ *   n - size of the system
+ *   k - number of right-hand sides
+ */
+void cholesky_solve_multi(const double *L, double *B, int n, int k);
+
+/*
+ * Solve a symmetric positive (semi)definite system Ax = b
+ * 
+ * Tries a blocked Cholesky factorisation first. If A is not positive
+ * definite it falls back to LDL^T with symmetric diagonal pivoting,
+ * which returns the basic solution of a rank-deficient PSD system. If
+ * A turns out to be indefinite, a small ridge jitter is added to the
+ * diagonal and Cholesky is retried.
+ * 
+ * Parameters:
+ *   A - n x n symmetric matrix (will be modified; lower triangle used)
+ *   b - n x 1 right-hand side vector (will be modified)
+ *   x - n x 1 solution vector (output)
+ *   n - size of the system
+ * 
+ * Returns:
+ *   0 on success, -1 if no method produced a solution
+ */
+int solve_spd_system(double *A, double *b, double *x, int n);
+
+/*
+ * solve_spd_system for k right-hand sides: A * X = B
+ * 
+ * A is factorised once and all k systems share the factor. The
+ * fallbacks for non-definite A are applied column by column. The
+ * Cholesky panel and the copies kept for the fallbacks are carved from
+ * scratch, so repeated solves on a warm workspace do not allocate
+ * (except in the LDL^T fallback).
+ * 
+ * Parameters:
+ *   A - n x n symmetric matrix (will be modified; lower triangle used)
+ *   B - n x k row-major right-hand sides (will be modified)
+ *   X - n x k row-major solutions (output)
+ *   n - size of the system
+ *   k - number of right-hand sides
+ *   scratch - workspace for the temporaries, or NULL for a one-off one
+ * 
+ * Returns:
+ *   0 on success, -1 if no method produced a solution
+ */
+int solve_spd_system_multi(double *A, double *B, double *X, int n, int k,
+                           workspace_t *scratch);
+
+/*
+ * Eigendecomposition of a symmetric matrix: A = V * diag(w) * V^T
+ * 
+ * Householder reduction to tridiagonal form followed by the implicit
+ * QL algorithm (EISPACK tred2/tql2), O(n^3) once.
+ * 
+ * Parameters:
+ *   A - n x n symmetric matrix, row-major (not modified)
+ *   n - size of the matrix
+ *   w - n eigenvalues in ascending order (output)
+ *   V - n x n row-major matrix whose column j is the eigenvector of w[j]
+ *       (output)
+ * 
+ * Returns:
+ *   0 on success, -1 if allocation failed or the QL iteration did not
+ *   converge
+ */
+int symmetric_eigen(const double *A, int n, double *w, double *V);
+
 #endif // LINEAR_SOLVER_H
@@ -4,10 +4,25 @@
 
 #include "ols.h"
 #include "linear_solver.h"
+#include "kernels.h"
+#include "threads.h"
+#include "utils.h"
+#include "dist_solver.h"
+#include "tsqr.h"
+#include "workspace.h"
+#include "timing.h"
+#include "sparse.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// How the reduced normal equations are solved (see ols_set_solver)
+static int ols_solver = OLS_SOLVER_ROOT;
+
 void ols_serial(
     const double *X,
     const double *y,
@@ -20,25 +35,24 @@ void ols_serial(
     double *Xty = (double *)malloc(d * sizeof(double));
     
     // 1. Compute XtX = X^T * X (d x d symmetric matrix)
-    for (int i = 0; i < d; i++) {
-        for (int j = 0; j < d; j++) {
-            XtX[i * d + j] = 0.0;
-            for (int k = 0; k < n; k++) {
-                XtX[i * d + j] += X[k * d + i] * X[k * d + j];
-            }
-        }
-    }
+    // Only the lower triangle is computed, then mirrored
+    memset(XtX, 0, d * d * sizeof(double));
+    syrk_lower(X, n, d, XtX);
+    syrk_mirror(XtX, d);
     
-    // 2. Compute Xty = X^T * y (d x 1 vector)
+    // 2. Compute Xty = X^T * y (d x 1 vector), row by row
     for (int i = 0; i < d; i++) {
         Xty[i] = 0.0;
-        for (int k = 0; k < n; k++) {
-            Xty[i] += X[k * d + i] * y[k];
+    }
+    for (int k = 0; k < n; k++) {
+        double y_val = y[k];
+        for (int i = 0; i < d; i++) {
+            Xty[i] += X[(size_t)k * d + i] * y_val;
         }
     }
     
     // 3. Solve linear system: XtX * beta = Xty
-    int result = solve_linear_system(XtX, Xty, beta, d);
+    int result = solve_spd_system(XtX, Xty, beta, d);
     if (result != 0) {
         fprintf(stderr, "Error: Failed to solve linear system in OLS\n");
     }
@@ -48,7 +62,11 @@ void ols_serial(
     free(Xty);
 }
 
-void ols_parallel(
+void ols_set_solver(int solver) {
+    ols_solver = solver;
+}
+
+int ols_parallel(
     const double *X,
     const double *y,
     double *beta,
@@ -56,136 +74,751 @@ void ols_parallel(
     int d,
     MPI_Comm comm
 ) {
-    int rank, size;
-    MPI_Comm_rank(comm, &rank);
-    MPI_Comm_size(comm, &size);
+    // Steps 1-2: Aligned row block, first-touched by the compute threads
+    solver_context_t ctx;
+    if (solver_context_init(&ctx, n, d, comm) != 0) {
+        return -1;
+    }
     
-    // Step 1: Calculate load distribution
-    int rows_per_proc = n / size;
-    int remainder = n % size;
-    int local_n = rows_per_proc + (rank < remainder ? 1 : 0);
-    int start_row = rank * rows_per_proc + (rank < remainder ? rank : remainder);
+    // Steps 3-6: Distribute X and y
+    timing_start("ols.scatter");
+    solver_context_scatter(&ctx, X, y);
+    timing_stop("ols.scatter");
     
-    // Step 2: Allocate local data
-    double *local_X = (double *)malloc(local_n * d * sizeof(double));
-    double *local_y = (double *)malloc(local_n * sizeof(double));
+    // Steps 7-9: Local accumulation, reduction and solve
+    int status = ols_parallel_ctx(&ctx, beta);
     
-    // Step 3: Prepare for Scatterv (only rank 0)
-    int *sendcounts = NULL;
-    int *displs = NULL;
-    if (rank == 0) {
-        sendcounts = (int *)malloc(size * sizeof(int));
-        displs = (int *)malloc(size * sizeof(int));
-        for (int i = 0; i < size; i++) {
-            int i_rows = rows_per_proc + (i < remainder ? 1 : 0);
-            sendcounts[i] = i_rows * d;
-            displs[i] = (i * rows_per_proc + (i < remainder ? i : remainder)) * d;
+    // Clean up
+    solver_context_free(&ctx);
+    return status;
+}
+
+/*
+ * Accumulate XtX += X^T * X (lower triangle) and Xty += X^T * y
+ * over a block of rows (single thread). X holds float64 or float32
+ * values (X_DENSE_F64/X_DENSE_F32) or is a csr_matrix_t (X_CSR);
+ * sums are always float64. With k > 1 targets y is rows x k and Xty
+ * is d x k (dense float64 X only). widen holds syrk_lower_f32_scratch(d)
+ * doubles for float32 X (unused otherwise).
+ */
+static void ols_accumulate_block(
+    const void *X,
+    x_kind_t x_kind,
+    const double *y,
+    int rows,
+    int d,
+    int k,
+    double *XtX,
+    double *Xty,
+    double *widen
+) {
+    // Cache-blocked SYRK kernel; the upper triangle is filled in after
+    // the reduction
+    if (x_kind == X_CSR) {
+        // Only the nonzero pairs of each row
+        const csr_matrix_t *Xs = (const csr_matrix_t *)X;
+        csr_syrk_lower(Xs->row_ptr, Xs->col_idx, Xs->val, rows, d, XtX);
+        csr_spmv_t(Xs->row_ptr, Xs->col_idx, Xs->val, rows, y, Xty);
+        return;
+    }
+    if (x_kind == X_DENSE_F32) {
+        const float *Xf = (const float *)X;
+        syrk_lower_f32(Xf, rows, d, XtX, widen);
+        for (int row = 0; row < rows; row++) {
+            const float *x_row = Xf + (size_t)row * d;
+            double y_val = y[row];
+            for (int i = 0; i < d; i++) {
+                Xty[i] += (double)x_row[i] * y_val;
+            }
         }
+        return;
     }
     
-    // Step 4: Distribute X using Scatterv
-    MPI_Scatterv(X, sendcounts, displs, MPI_DOUBLE,
-                 local_X, local_n * d, MPI_DOUBLE,
-                 0, comm);
+    const double *Xd = (const double *)X;
+    syrk_lower(Xd, rows, d, XtX);
+    if (k > 1) {
+        gemm_tn(Xd, y, rows, d, k, Xty);
+        return;
+    }
     
-    // Step 5: Prepare for y distribution
-    int *sendcounts_y = NULL;
-    int *displs_y = NULL;
-    if (rank == 0) {
-        sendcounts_y = (int *)malloc(size * sizeof(int));
-        displs_y = (int *)malloc(size * sizeof(int));
-        for (int i = 0; i < size; i++) {
-            int i_rows = rows_per_proc + (i < remainder ? 1 : 0);
-            sendcounts_y[i] = i_rows;
-            displs_y[i] = i * rows_per_proc + (i < remainder ? i : remainder);
-        }
-    }
-    
-    // Step 6: Distribute y using Scatterv
-    MPI_Scatterv(y, sendcounts_y, displs_y, MPI_DOUBLE,
-                 local_y, local_n, MPI_DOUBLE,
-                 0, comm);
-    
-    // // Step 7: Compute local XtX and Xty
-    // double *local_XtX = (double *)malloc(d * d * sizeof(double));
-    // double *local_Xty = (double *)malloc(d * sizeof(double));
-    
-    // // Compute local XtX = local_X^T * local_X
-    // for (int i = 0; i < d; i++) {
-    //     for (int j = 0; j < d; j++) {
-    //         local_XtX[i * d + j] = 0.0;
-    //         for (int k = 0; k < local_n; k++) {
-    //             local_XtX[i * d + j] += local_X[k * d + i] * local_X[k * d + j];
-    //         }
-    //     }
-    // }
-    // Step 7: Compute local XtX and Xty
-    // Initialize matrices to zero first
-    // usage of calloc is safer/cleaner, or manual loop initialization
-    double *local_XtX = (double *)calloc(d * d, sizeof(double));
-    double *local_Xty = (double *)calloc(d, sizeof(double));
-
-    // Compute local XtX = local_X^T * local_X
-    // Optimization: Iterate k (rows) in the outer loop for sequential memory access
-    for (int k = 0; k < local_n; k++) {
+    // Iterate rows outside for sequential memory access
+    for (int row = 0; row < rows; row++) {
+        const double *x_row = Xd + (size_t)row * d;
+        double y_val = y[row]; // Read y value once per row
         for (int i = 0; i < d; i++) {
-            // Cache the value from the i-th column of the current row
-            double val_i = local_X[k * d + i]; 
-            
-            // Inner loop updates the i-th row of the result matrix
-            for (int j = 0; j < d; j++) {
-                local_XtX[i * d + j] += val_i * local_X[k * d + j];
-            }
+            Xty[i] += x_row[i] * y_val;
         }
     }
+}
 
-    // Compute local Xty = local_X^T * local_y
-    // Optimization: Same strategy, iterate k outside
-    for (int k = 0; k < local_n; k++) {
-        double y_val = local_y[k]; // Read y value once per row
-        for (int i = 0; i < d; i++) {
-            local_Xty[i] += local_X[k * d + i] * y_val;
+#ifdef _OPENMP
+/*
+ * ols_accumulate_block over rows [start, start + rows) of X (one
+ * thread's share in ols_accumulate)
+ */
+static void ols_accumulate_rows(
+    const void *X,
+    x_kind_t x_kind,
+    const double *y,
+    int start,
+    int rows,
+    int d,
+    int k,
+    double *XtX,
+    double *Xty,
+    double *widen
+) {
+    const double *y_block = y + (size_t)start * k;
+    if (x_kind == X_CSR) {
+        csr_matrix_t block = csr_row_block((const csr_matrix_t *)X, start, rows);
+        ols_accumulate_block(&block, x_kind, y_block, rows, d, k, XtX, Xty, widen);
+    } else if (x_kind == X_DENSE_F32) {
+        ols_accumulate_block((const float *)X + (size_t)start * d, x_kind, y_block,
+                             rows, d, k, XtX, Xty, widen);
+    } else {
+        ols_accumulate_block((const double *)X + (size_t)start * d, x_kind, y_block,
+                             rows, d, k, XtX, Xty, widen);
+    }
+}
+#endif
+
+/*
+ * Accumulate XtX/Xty over a block of rows, splitting the rows across
+ * OpenMP threads. Each thread sums its sub-block into a private buffer
+ * carved from scratch (or a one-off workspace if NULL) and zeroed, so
+ * first-touched, by that thread; the buffers are then combined with a
+ * tree reduction into XtX/Xty. Float32 X also gets a per-thread
+ * widening panel from scratch.
+ */
+static void ols_accumulate(
+    const void *X,
+    x_kind_t x_kind,
+    const double *y,
+    int rows,
+    int d,
+    int k,
+    double *XtX,
+    double *Xty,
+    workspace_t *scratch
+) {
+    int num_threads = get_row_threads(rows, ROW_MIN_ROWS_PER_THREAD);
+    size_t widen_bytes = (x_kind == X_DENSE_F32) ?
+                         workspace_bytes(syrk_lower_f32_scratch(d), sizeof(double)) : 0;
+    workspace_t temp;
+    size_t mark;
+    if (num_threads <= 1) {
+        if (widen_bytes == 0) {
+            ols_accumulate_block(X, x_kind, y, rows, d, k, XtX, Xty, NULL);
+            return;
+        }
+        workspace_t *ws = workspace_begin(scratch, &temp, widen_bytes, &mark);
+        workspace_require(ws, "ols_accumulate");
+        double *widen = (double *)workspace_alloc(ws, widen_bytes);
+        ols_accumulate_block(X, x_kind, y, rows, d, k, XtX, Xty, widen);
+        workspace_end(ws, &temp, mark);
+        return;
+    }
+    
+#ifdef _OPENMP
+    size_t XtX_bytes = workspace_bytes((size_t)d * d, sizeof(double));
+    size_t Xty_bytes = workspace_bytes((size_t)d * k, sizeof(double));
+    size_t bytes = 3 * workspace_bytes(num_threads, sizeof(double *)) +
+                   (num_threads - 1) * (XtX_bytes + Xty_bytes) + num_threads * widen_bytes;
+    workspace_t *ws = workspace_begin(scratch, &temp, bytes, &mark);
+    workspace_require(ws, "ols_accumulate");
+    double **XtX_bufs = (double **)workspace_alloc(ws, num_threads * sizeof(double *));
+    double **Xty_bufs = (double **)workspace_alloc(ws, num_threads * sizeof(double *));
+    double **widen_bufs = (double **)workspace_alloc(ws, num_threads * sizeof(double *));
+    XtX_bufs[0] = XtX;
+    Xty_bufs[0] = Xty;
+    for (int t = 1; t < num_threads; t++) {
+        XtX_bufs[t] = (double *)workspace_alloc(ws, XtX_bytes);
+        Xty_bufs[t] = (double *)workspace_alloc(ws, Xty_bytes);
+    }
+    for (int t = 0; t < num_threads; t++) {
+        widen_bufs[t] = widen_bytes ? (double *)workspace_alloc(ws, widen_bytes) : NULL;
+    }
+    
+    #pragma omp parallel num_threads(num_threads)
+    {
+        int tid = omp_get_thread_num();
+        int nt = omp_get_num_threads();
+        int block_n, block_start;
+        if (x_kind == X_CSR) {
+            csr_row_partition(((const csr_matrix_t *)X)->row_ptr, rows, tid, nt,
+                              &block_n, &block_start);
+        } else {
+            get_row_partition(rows, tid, nt, &block_n, &block_start);
         }
+        
+        // Thread 0 accumulates straight into the output
+        if (tid != 0) {
+            memset(XtX_bufs[tid], 0, (size_t)d * d * sizeof(double));
+            memset(Xty_bufs[tid], 0, (size_t)d * k * sizeof(double));
+        }
+        
+        ols_accumulate_rows(X, x_kind, y, block_start, block_n, d, k,
+                            XtX_bufs[tid], Xty_bufs[tid], widen_bufs[tid]);
+        
+        thread_tree_reduce(XtX_bufs, nt, (size_t)d * d);
+        thread_tree_reduce(Xty_bufs, nt, (size_t)d * k);
     }
     
-    // Compute local Xty = local_X^T * local_y
+    workspace_end(ws, &temp, mark);
+#endif
+}
+
+/*
+ * Reduce local XtX (lower triangle) and Xty (d x k) to rank 0, which
+ * receives the full symmetric XtX and Xty (only used on rank 0)
+ */
+static void ols_reduce_to_root(
+    const double *local_XtX,
+    const double *local_Xty,
+    int d,
+    int k,
+    double *XtX,
+    double *Xty,
+    workspace_t *scratch,
+    MPI_Comm comm
+) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    
+    // Pack the lower triangle and Xty into one message: about half the
+    // volume of the full d x d matrix, and a single collective
+    int tri = d * (d + 1) / 2;
+    int count = tri + d * k;
+    workspace_t temp;
+    size_t mark;
+    workspace_t *ws = workspace_begin(scratch, &temp, workspace_bytes(count, sizeof(double)),
+                                      &mark);
+    workspace_require(ws, "ols_reduce_to_root");
+    double *packed = (double *)workspace_alloc(ws, count * sizeof(double));
+    int pos = 0;
     for (int i = 0; i < d; i++) {
-        local_Xty[i] = 0.0;
-        for (int k = 0; k < local_n; k++) {
-            local_Xty[i] += local_X[k * d + i] * local_y[k];
+        for (int j = 0; j <= i; j++) {
+            packed[pos++] = local_XtX[i * d + j];
         }
     }
+    memcpy(packed + tri, local_Xty, (size_t)d * k * sizeof(double));
+    
+    if (rank == 0) {
+        MPI_Reduce(MPI_IN_PLACE, packed, count, MPI_DOUBLE, MPI_SUM, 0, comm);
+    } else {
+        MPI_Reduce(packed, NULL, count, MPI_DOUBLE, MPI_SUM, 0, comm);
+    }
     
-    // Step 8: Reduce to rank 0
+    if (rank == 0) {
+        pos = 0;
+        for (int i = 0; i < d; i++) {
+            for (int j = 0; j <= i; j++) {
+                XtX[i * d + j] = packed[pos++];
+            }
+        }
+        syrk_mirror(XtX, d);
+        memcpy(Xty, packed + tri, (size_t)d * k * sizeof(double));
+    }
+    workspace_end(ws, &temp, mark);
+}
+
+/*
+ * Reduce local XtX (lower triangle) and Xty (d x k) to rank 0 and
+ * solve XtX * beta = Xty there for all k targets (temporaries from
+ * scratch, or a one-off workspace if NULL). Returns rank 0's solve
+ * status on every rank
+ */
+static int ols_reduce_and_solve(
+    const double *local_XtX,
+    const double *local_Xty,
+    double *beta,
+    int d,
+    int k,
+    workspace_t *scratch,
+    MPI_Comm comm
+) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    
+    // The distributed solver takes a single right-hand side
+    if (ols_solver == OLS_SOLVER_DISTRIBUTED && k == 1) {
+        timing_start("ols.dist_solve");
+        int result = dist_cholesky_solve(local_XtX, local_Xty, beta, d, comm);
+        timing_stop("ols.dist_solve");
+        if (result == 0) {
+            return 0;
+        }
+        // Not positive definite: let rank 0 apply the SPD fallbacks
+        if (rank == 0) {
+            fprintf(stderr, "Warning: Distributed Cholesky failed, solving on rank 0\n");
+        }
+    }
+    
+    // The packed reduction buffer is carved on top of these
+    size_t bytes = workspace_bytes((size_t)d * d, sizeof(double)) +
+                   workspace_bytes((size_t)d * k, sizeof(double)) +
+                   workspace_bytes(d * (d + 1) / 2 + (size_t)d * k, sizeof(double));
+    workspace_t temp;
+    size_t mark;
+    workspace_t *ws = workspace_begin(scratch, &temp, bytes, &mark);
+    workspace_require(ws, "ols_reduce_and_solve");
     double *global_XtX = NULL;
     double *global_Xty = NULL;
     if (rank == 0) {
-        global_XtX = (double *)malloc(d * d * sizeof(double));
-        global_Xty = (double *)malloc(d * sizeof(double));
+        global_XtX = (double *)workspace_alloc(ws, (size_t)d * d * sizeof(double));
+        global_Xty = (double *)workspace_alloc(ws, (size_t)d * k * sizeof(double));
     }
+    timing_start("ols.reduce");
+    ols_reduce_to_root(local_XtX, local_Xty, d, k, global_XtX, global_Xty, ws, comm);
+    timing_stop("ols.reduce");
     
-    MPI_Reduce(local_XtX, global_XtX, d * d, MPI_DOUBLE, MPI_SUM, 0, comm);
-    MPI_Reduce(local_Xty, global_Xty, d, MPI_DOUBLE, MPI_SUM, 0, comm);
-    
-    // Step 9: Rank 0 solves the system
+    int status = 0;
     if (rank == 0) {
-        int result = solve_linear_system(global_XtX, global_Xty, beta, d);
-        if (result != 0) {
+        timing_start("ols.solve");
+        status = solve_spd_system_multi(global_XtX, global_Xty, beta, d, k, ws);
+        timing_stop("ols.solve");
+        if (status != 0) {
             fprintf(stderr, "Error: Failed to solve linear system in parallel OLS\n");
         }
-        free(global_XtX);
-        free(global_Xty);
     }
+    MPI_Bcast(&status, 1, MPI_INT, 0, comm);
+    workspace_end(ws, &temp, mark);
+    return status;
+}
+
+void ols_normal_equations(
+    const double *X,
+    const double *y,
+    int n,
+    int d,
+    double *XtX,
+    double *Xty
+) {
+    memset(XtX, 0, d * d * sizeof(double));
+    memset(Xty, 0, d * sizeof(double));
+    ols_accumulate(X, X_DENSE_F64, y, n, d, 1, XtX, Xty, NULL);
+    syrk_mirror(XtX, d);
+}
+
+/*
+ * Carve local XtX (lower triangle) and Xty (d x k) from ws and
+ * accumulate them over a float64, float32 or CSR row block
+ */
+static void ols_local_sums(
+    const void *local_X,
+    x_kind_t x_kind,
+    const double *local_y,
+    int local_n,
+    int d,
+    int k,
+    workspace_t *ws,
+    double **local_XtX,
+    double **local_Xty
+) {
+    *local_XtX = (double *)workspace_alloc(ws, (size_t)d * d * sizeof(double));
+    *local_Xty = (double *)workspace_alloc(ws, (size_t)d * k * sizeof(double));
+    memset(*local_XtX, 0, (size_t)d * d * sizeof(double));
+    memset(*local_Xty, 0, (size_t)d * k * sizeof(double));
+    ols_accumulate(local_X, x_kind, local_y, local_n, d, k, *local_XtX, *local_Xty, ws);
+}
+
+/*
+ * Accumulate local XtX/Xty from a row block and reduce them to rank 0
+ * (temporaries from scratch, or a one-off workspace if NULL)
+ */
+static void ols_normal_equations_any(
+    const void *local_X,
+    x_kind_t x_kind,
+    const double *local_y,
+    int local_n,
+    int d,
+    int k,
+    double *XtX,
+    double *Xty,
+    workspace_t *scratch,
+    MPI_Comm comm
+) {
+    size_t bytes = workspace_bytes((size_t)d * d, sizeof(double)) +
+                   workspace_bytes((size_t)d * k, sizeof(double));
+    workspace_t temp;
+    size_t mark;
+    workspace_t *ws = workspace_begin(scratch, &temp, bytes, &mark);
+    workspace_require(ws, "ols_normal_equations_any");
+    double *local_XtX, *local_Xty;
+    ols_local_sums(local_X, x_kind, local_y, local_n, d, k, ws, &local_XtX, &local_Xty);
+    ols_reduce_to_root(local_XtX, local_Xty, d, k, XtX, Xty, ws, comm);
+    workspace_end(ws, &temp, mark);
+}
+
+/*
+ * Parallel OLS on a row block of any storage with k targets: local
+ * sums, reduction and rank 0's solve all carve from scratch (or a
+ * one-off workspace if NULL)
+ */
+static int ols_solve_any(
+    const void *local_X,
+    x_kind_t x_kind,
+    const double *local_y,
+    double *beta,
+    int local_n,
+    int d,
+    int k,
+    workspace_t *scratch,
+    MPI_Comm comm
+) {
+    // Step 7: Compute local XtX and Xty
+    workspace_t temp;
+    size_t mark;
+    workspace_t *ws = workspace_begin(scratch, &temp,
+                                      workspace_bytes((size_t)d * d, sizeof(double)) +
+                                      workspace_bytes((size_t)d * k, sizeof(double)), &mark);
+    workspace_require(ws, "ols_solve_any");
+    double *local_XtX, *local_Xty;
+    timing_start("ols.compute");
+    ols_local_sums(local_X, x_kind, local_y, local_n, d, k, ws, &local_XtX, &local_Xty);
+    timing_stop("ols.compute");
     
-    // Clean up
-    free(local_X);
-    free(local_y);
-    free(local_XtX);
-    free(local_Xty);
+    // Steps 8-9: Reduce to rank 0, which solves the system
+    int status = ols_reduce_and_solve(local_XtX, local_Xty, beta, d, k, ws, comm);
+    workspace_end(ws, &temp, mark);
+    return status;
+}
+
+void ols_normal_equations_local(
+    const double *local_X,
+    const double *local_y,
+    int local_n,
+    int d,
+    double *XtX,
+    double *Xty,
+    MPI_Comm comm
+) {
+    ols_normal_equations_any(local_X, X_DENSE_F64, local_y, local_n, d, 1,
+                             XtX, Xty, NULL, comm);
+}
+
+void ols_normal_equations_local_f32(
+    const float *local_X,
+    const double *local_y,
+    int local_n,
+    int d,
+    double *XtX,
+    double *Xty,
+    MPI_Comm comm
+) {
+    ols_normal_equations_any(local_X, X_DENSE_F32, local_y, local_n, d, 1,
+                             XtX, Xty, NULL, comm);
+}
+
+/*
+ * ols_parallel_local with all temporaries carved from scratch (or a
+ * one-off workspace if NULL)
+ */
+static int ols_solve_local(
+    const double *local_X,
+    const double *local_y,
+    double *beta,
+    int local_n,
+    int d,
+    workspace_t *scratch,
+    MPI_Comm comm
+) {
+    // QR of the row blocks instead of the normal equations
+    if (ols_solver == OLS_SOLVER_TSQR) {
+        return tsqr_solve(local_X, local_y, beta, local_n, d, scratch, comm);
+    }
+    
+    return ols_solve_any(local_X, X_DENSE_F64, local_y, beta, local_n, d, 1, scratch,
+                         comm);
+}
+
+int ols_parallel_local(
+    const double *local_X,
+    const double *local_y,
+    double *beta,
+    int local_n,
+    int d,
+    MPI_Comm comm
+) {
+    return ols_solve_local(local_X, local_y, beta, local_n, d, NULL, comm);
+}
+
+int ols_parallel_ctx(solver_context_t *ctx, double *beta) {
+    return ols_solve_local(ctx->local_X, ctx->local_y, beta, ctx->local_n, ctx->d, &ctx->scratch,
+                    ctx->comm);
+}
+
+void ols_normal_equations_ctx(solver_context_t *ctx, double *XtX, double *Xty) {
+    ols_normal_equations_any(ctx->local_X, X_DENSE_F64, ctx->local_y, ctx->local_n,
+                             ctx->d, 1, XtX, Xty, &ctx->scratch, ctx->comm);
+}
+
+int ols_parallel_local_f32(
+    const float *local_X,
+    const double *local_y,
+    double *beta,
+    int local_n,
+    int d,
+    workspace_t *scratch,
+    MPI_Comm comm
+) {
+    // Same as ols_parallel_local; only the X reads are narrower
+    return ols_solve_any(local_X, X_DENSE_F32, local_y, beta, local_n, d, 1, scratch,
+                         comm);
+}
+
+void ols_normal_equations_local_csr(
+    const csr_matrix_t *local_X,
+    const double *local_y,
+    double *XtX,
+    double *Xty,
+    MPI_Comm comm
+) {
+    ols_normal_equations_any(local_X, X_CSR, local_y, local_X->rows,
+                             local_X->d, 1, XtX, Xty, NULL, comm);
+}
+
+int ols_parallel_local_csr(
+    const csr_matrix_t *local_X,
+    const double *local_y,
+    double *beta,
+    workspace_t *scratch,
+    MPI_Comm comm
+) {
+    // Same as ols_parallel_local; only nonzero pairs reach XtX
+    return ols_solve_any(local_X, X_CSR, local_y, beta, local_X->rows, local_X->d, 1,
+                         scratch, comm);
+}
+
+void ols_normal_equations_local_multi(
+    const double *local_X,
+    const double *local_Y,
+    int local_n,
+    int d,
+    int k,
+    double *XtX,
+    double *XtY,
+    MPI_Comm comm
+) {
+    ols_normal_equations_any(local_X, X_DENSE_F64, local_Y, local_n, d, k,
+                             XtX, XtY, NULL, comm);
+}
+
+int ols_parallel_local_multi(
+    const double *local_X,
+    const double *local_Y,
+    double *B,
+    int local_n,
+    int d,
+    int k,
+    workspace_t *scratch,
+    MPI_Comm comm
+) {
+    // One SYRK for XtX shared by all targets, one GEMM for X^T * Y, a
+    // single reduction and one factorisation with k right-hand sides
+    return ols_solve_any(local_X, X_DENSE_F64, local_Y, B, local_n, d, k, scratch,
+                         comm);
+}
+
+/*
+ * Solve the normal equations stored as a packed record (lower triangle
+ * of XtX followed by Xty)
+ */
+static int cv_solve_packed(const double *rec, int d, double *beta) {
+    double *A = (double *)malloc((size_t)d * d * sizeof(double));
+    double *b = (double *)malloc(d * sizeof(double));
+    int pos = 0;
+    for (int i = 0; i < d; i++) {
+        for (int j = 0; j <= i; j++) {
+            A[i * d + j] = rec[pos++];
+        }
+    }
+    syrk_mirror(A, d);
+    memcpy(b, rec + pos, d * sizeof(double));
+    int result = solve_spd_system(A, b, beta, d);
+    if (result != 0) {
+        fprintf(stderr, "Error: Failed to solve linear system in cross-validation\n");
+    }
+    free(A);
+    free(b);
+    return result;
+}
+
+int ols_cross_validate_local(
+    const double *local_X,
+    const double *local_y,
+    double *beta,
+    int n,
+    int local_n,
+    int start_row,
+    int d,
+    int folds,
+    double *fold_mse,
+    double *mean_mse,
+    MPI_Comm comm
+) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    if (folds < 2 || folds > n) {
+        if (rank == 0) {
+            fprintf(stderr, "Error: Cross-validation needs 2 <= folds <= n (got %d)\n", folds);
+        }
+        return -1;
+    }
+    
+    // Per-fold record: XtX lower triangle, Xty, yty, row count
+    int tri = d * (d + 1) / 2;
+    int stride = tri + d + 2;
+    double *packed = (double *)calloc((size_t)folds * stride, sizeof(double));
+    double *fold_XtX = (double *)malloc((size_t)d * d * sizeof(double));
+    double *fold_Xty = (double *)malloc(d * sizeof(double));
+    workspace_t scratch = {0};  // thread buffers, reused by every fold
+    
+    // Step 1: One pass; folds are contiguous row ranges, so each rank's
+    // block splits into a few runs that go through the usual kernels
+    timing_start("ols.compute");
+    int local_end = start_row + local_n;
+    for (int f = 0; f < folds; f++) {
+        int fold_n, fold_start;
+        get_row_partition(n, f, folds, &fold_n, &fold_start);
+        int lo = (fold_start > start_row) ? fold_start : start_row;
+        int hi = (fold_start + fold_n < local_end) ? fold_start + fold_n : local_end;
+        if (hi <= lo) {
+            continue;
+        }
+        
+        memset(fold_XtX, 0, (size_t)d * d * sizeof(double));
+        memset(fold_Xty, 0, d * sizeof(double));
+        const double *X_run = local_X + (size_t)(lo - start_row) * d;
+        const double *y_run = local_y + (lo - start_row);
+        ols_accumulate(X_run, X_DENSE_F64, y_run, hi - lo, d, 1,
+                       fold_XtX, fold_Xty, &scratch);
+        
+        double *rec = packed + (size_t)f * stride;
+        int pos = 0;
+        for (int i = 0; i < d; i++) {
+            for (int j = 0; j <= i; j++) {
+                rec[pos++] = fold_XtX[i * d + j];
+            }
+        }
+        memcpy(rec + tri, fold_Xty, d * sizeof(double));
+        for (int r = 0; r < hi - lo; r++) {
+            rec[tri + d] += y_run[r] * y_run[r];
+        }
+        rec[tri + d + 1] = hi - lo;
+    }
+    timing_stop("ols.compute");
+    
+    // Step 2: A single reduction of every fold's statistics
+    timing_start("ols.reduce");
+    if (rank == 0) {
+        MPI_Reduce(MPI_IN_PLACE, packed, folds * stride, MPI_DOUBLE, MPI_SUM, 0, comm);
+    } else {
+        MPI_Reduce(packed, NULL, folds * stride, MPI_DOUBLE, MPI_SUM, 0, comm);
+    }
+    timing_stop("ols.reduce");
+    
+    // Step 3: Rank 0 fits each training set (total minus fold f) and
+    // scores the held-out fold with RSS = yty - 2 b'Xty + b'XtX b
+    int status = 0;
     if (rank == 0) {
-        free(sendcounts);
-        free(displs);
-        free(sendcounts_y);
-        free(displs_y);
+        timing_start("ols.solve");
+        double *total = (double *)calloc(stride, sizeof(double));
+        double *train = (double *)malloc(stride * sizeof(double));
+        double *fit = (double *)malloc(d * sizeof(double));
+        for (int f = 0; f < folds; f++) {
+            const double *rec = packed + (size_t)f * stride;
+            for (int i = 0; i < stride; i++) {
+                total[i] += rec[i];
+            }
+        }
+        
+        *mean_mse = 0.0;
+        for (int f = 0; f < folds && status == 0; f++) {
+            const double *rec = packed + (size_t)f * stride;
+            for (int i = 0; i < stride; i++) {
+                train[i] = total[i] - rec[i];
+            }
+            status = cv_solve_packed(train, d, fit);
+            
+            // Held-out score from the fold's own statistics
+            double quad = 0.0;
+            double cross = 0.0;
+            int pos = 0;
+            for (int i = 0; i < d; i++) {
+                for (int j = 0; j < i; j++) {
+                    quad += 2.0 * fit[i] * rec[pos++] * fit[j];
+                }
+                quad += fit[i] * rec[pos++] * fit[i];
+                cross += fit[i] * rec[tri + i];
+            }
+            double rss = rec[tri + d] - 2.0 * cross + quad;
+            double rows = rec[tri + d + 1];
+            fold_mse[f] = (rows > 0) ? (rss > 0.0 ? rss : 0.0) / rows : 0.0;
+            *mean_mse += fold_mse[f] / folds;
+        }
+        
+        // Final model on all rows
+        if (status == 0) {
+            status = cv_solve_packed(total, d, beta);
+        }
+        free(total);
+        free(train);
+        free(fit);
+        timing_stop("ols.solve");
+    }
+    
+    free(packed);
+    free(fold_XtX);
+    free(fold_Xty);
+    workspace_free(&scratch);
+    MPI_Bcast(&status, 1, MPI_INT, 0, comm);
+    return status;
+}
+
+int ols_parallel_stream(
+    row_stream_t *stream,
+    double *beta,
+    MPI_Comm comm
+) {
+    int d = stream->d;
+    double *local_XtX = (double *)calloc(d * d, sizeof(double));
+    double *local_Xty = (double *)calloc(d, sizeof(double));
+    workspace_t scratch = {0};  // thread buffers, reused by every chunk
+    
+    // Accumulate chunk by chunk; the stream reads the next chunk meanwhile
+    const double *chunk_X;
+    const double *chunk_y;
+    int rows;
+    int ok = 1;
+    // ols.read_wait is time blocked on I/O the prefetch did not hide
+    for (;;) {
+        timing_start("ols.read_wait");
+        rows = row_stream_next(stream, &chunk_X, &chunk_y);
+        timing_stop("ols.read_wait");
+        if (rows <= 0) {
+            break;
+        }
+        timing_start("ols.compute");
+        ols_accumulate(chunk_X, X_DENSE_F64, chunk_y, rows, d, 1,
+                       local_XtX, local_Xty, &scratch);
+        timing_stop("ols.compute");
+    }
+    if (rows < 0) {
+        fprintf(stderr, "Error: Failed to read row chunk in streaming OLS\n");
+        ok = 0;
+    }
+    
+    // Every rank must agree before entering the reduction
+    int all_ok;
+    MPI_Allreduce(&ok, &all_ok, 1, MPI_INT, MPI_LAND, comm);
+    int status = -1;
+    if (all_ok) {
+        status = ols_reduce_and_solve(local_XtX, local_Xty, beta, d, 1, &scratch, comm);
     }
+    
+    free(local_XtX);
+    free(local_Xty);
+    workspace_free(&scratch);
+    return status;
 }
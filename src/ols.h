@@ -8,6 +8,26 @@
 #define OLS_H
 
 #include <mpi.h>
+#include "stream.h"
+#include "sparse.h"
+#include "context.h"
+
+// Solvers for the reduced normal equations
+#define OLS_SOLVER_ROOT        0  // reduce to rank 0, Cholesky there
+#define OLS_SOLVER_DISTRIBUTED 1  // reduce-scatter, distributed Cholesky
+#define OLS_SOLVER_TSQR        2  // tree-reduced QR, no normal equations
+
+/*
+ * Select how the parallel OLS variants solve XtX * beta = Xty
+ * 
+ * OLS_SOLVER_DISTRIBUTED keeps XtX block-cyclically distributed and
+ * factorises it across all ranks; use it when d is large enough that
+ * the d x d solve on rank 0 is the bottleneck. OLS_SOLVER_TSQR never
+ * forms XtX (see tsqr.h): use it for ill-conditioned X, where the
+ * normal equations lose twice the digits. It applies to ols_parallel
+ * and ols_parallel_local only.
+ */
+void ols_set_solver(int solver);
 
 /*
  * Serial OLS implementation (for baseline comparison)
@@ -37,13 +57,289 @@ void ols_serial(
  *   n - total number of samples
  *   d - number of features
  *   comm - MPI communicator
+ * 
+ * Returns:
+ *   0 on success, -1 on every rank if the solve failed (setup failure,
+ *   or a rank-deficient X under OLS_SOLVER_TSQR)
+ */
+int ols_parallel(
+    const double *X,
+    const double *y,
+    double *beta,
+    int n,
+    int d,
+    MPI_Comm comm
+);
+
+/*
+ * Parallel OLS on pre-distributed data
+ * 
+ * Each rank passes its own row block (e.g. from
+ * generate_synthetic_data_local), so no rank ever holds the full X.
+ * 
+ * Parameters:
+ *   local_X - local_n x d row block owned by this rank
+ *   local_y - local_n x 1 response block owned by this rank
+ *   beta - output parameters (computed on rank 0)
+ *   local_n - number of rows owned by this rank
+ *   d - number of features
+ *   comm - MPI communicator
+ * 
+ * Returns:
+ *   0 on success, -1 on every rank if rank 0 cannot solve the normal
+ *   equations (not positive semidefinite, e.g. non-finite data) or if X
+ *   is rank deficient under OLS_SOLVER_TSQR (beta is then not valid)
+ */
+int ols_parallel_local(
+    const double *local_X,
+    const double *local_y,
+    double *beta,
+    int local_n,
+    int d,
+    MPI_Comm comm
+);
+
+/*
+ * Parallel OLS on a solver context's row block (see context.h)
+ * 
+ * Same result as ols_parallel_local; the thread buffers, the packed
+ * reduction buffer, rank 0's system and its Cholesky temporaries are
+ * carved from the context's scratch, so repeated solves do not allocate
+ * (with OLS_SOLVER_ROOT and a positive definite XtX).
+ * 
+ * Parameters:
+ *   ctx - initialised context holding this rank's rows
+ *   beta - d x 1 output parameters (computed on rank 0)
+ * 
+ * Returns:
+ *   0 on success, -1 as for ols_parallel_local
+ */
+int ols_parallel_ctx(solver_context_t *ctx, double *beta);
+
+/*
+ * Parallel OLS on pre-distributed float32 row blocks
+ * 
+ * Mixed precision: X is stored (and read) as float32, halving memory
+ * footprint and traffic; XtX, Xty and the solve stay in float64.
+ * scratch is a workspace for the local sums, the reduction and rank
+ * 0's solve (NULL for a one-off one); other parameters and the return
+ * value as for ols_parallel_local.
+ */
+int ols_parallel_local_f32(
+    const float *local_X,
+    const double *local_y,
+    double *beta,
+    int local_n,
+    int d,
+    workspace_t *scratch,
+    MPI_Comm comm
+);
+
+/*
+ * Out-of-core parallel OLS
+ * 
+ * Accumulates XtX and Xty chunk by chunk from each rank's row stream,
+ * so peak memory is O(chunk_rows * d + d^2) instead of O(local_n * d).
+ * 
+ * Parameters:
+ *   stream - this rank's open row stream (see stream.h)
+ *   beta - output parameters (computed on rank 0)
+ *   comm - MPI communicator
+ * 
+ * Returns:
+ *   0 on success, -1 if any rank failed to read its rows or the solve
+ *   failed
+ */
+int ols_parallel_stream(
+    row_stream_t *stream,
+    double *beta,
+    MPI_Comm comm
+);
+
+/*
+ * Form the normal equations XtX = X^T * X and Xty = X^T * y (serial)
+ * 
+ * Parameters:
+ *   X - n x d data matrix
+ *   y - n x 1 response vector
+ *   n - number of samples
+ *   d - number of features
+ *   XtX - d x d output matrix (full, symmetric)
+ *   Xty - d x 1 output vector
  */
-void ols_parallel(
+void ols_normal_equations(
     const double *X,
     const double *y,
+    int n,
+    int d,
+    double *XtX,
+    double *Xty
+);
+
+/*
+ * Form the global normal equations from pre-distributed row blocks
+ * 
+ * One pass over each rank's rows and a single reduction; the result
+ * is only available on rank 0 (XtX/Xty may be NULL on other ranks).
+ * 
+ * Parameters:
+ *   local_X - local_n x d row block owned by this rank
+ *   local_y - local_n x 1 response block owned by this rank
+ *   local_n - number of rows owned by this rank
+ *   d - number of features
+ *   XtX - d x d output matrix (full, symmetric; rank 0)
+ *   Xty - d x 1 output vector (rank 0)
+ *   comm - MPI communicator
+ */
+void ols_normal_equations_local(
+    const double *local_X,
+    const double *local_y,
+    int local_n,
+    int d,
+    double *XtX,
+    double *Xty,
+    MPI_Comm comm
+);
+
+/*
+ * ols_normal_equations_local on a solver context's row block, with the
+ * temporaries carved from its scratch
+ */
+void ols_normal_equations_ctx(solver_context_t *ctx, double *XtX, double *Xty);
+
+/*
+ * ols_normal_equations_local for float32 row blocks
+ */
+void ols_normal_equations_local_f32(
+    const float *local_X,
+    const double *local_y,
+    int local_n,
+    int d,
+    double *XtX,
+    double *Xty,
+    MPI_Comm comm
+);
+
+/*
+ * Parallel OLS on pre-distributed CSR row blocks
+ * 
+ * Each row contributes only its nonzero pairs to XtX, so the local
+ * work is sum(nnz_row^2) instead of rows x d^2; the reduction and the
+ * solve are the same as for dense rows. Blocks are best split by
+ * nonzeros (dataset_scatter_csr, dataset_read_csr_local).
+ * 
+ * Parameters:
+ *   local_X - this rank's CSR row block (local_X->d features)
+ *   local_y - local_X->rows x 1 response block
+ *   beta - output parameters (computed on rank 0)
+ *   scratch - workspace for all temporaries, or NULL for a one-off one
+ *   comm - MPI communicator
+ * 
+ * Returns:
+ *   0 on success, -1 on every rank if the solve failed
+ */
+int ols_parallel_local_csr(
+    const csr_matrix_t *local_X,
+    const double *local_y,
+    double *beta,
+    workspace_t *scratch,
+    MPI_Comm comm
+);
+
+/*
+ * ols_normal_equations_local for CSR row blocks
+ */
+void ols_normal_equations_local_csr(
+    const csr_matrix_t *local_X,
+    const double *local_y,
+    double *XtX,
+    double *Xty,
+    MPI_Comm comm
+);
+
+/*
+ * Multi-target parallel OLS on pre-distributed data: X * B = Y
+ * 
+ * XtX is formed once and shared by all k targets, X^T * Y comes from
+ * one blocked GEMM, and the k systems are solved with a single
+ * Cholesky factorisation on rank 0 (the distributed solver is not
+ * used for k > 1).
+ * 
+ * Parameters:
+ *   local_X - local_n x d row block owned by this rank
+ *   local_Y - local_n x k row-major response block
+ *   B - d x k row-major coefficients (output, valid on rank 0)
+ *   local_n - number of rows owned by this rank
+ *   d - number of features
+ *   k - number of targets
+ *   scratch - workspace for all temporaries, or NULL for a one-off one
+ *   comm - MPI communicator
+ * 
+ * Returns:
+ *   0 on success, -1 on every rank if the solve failed
+ */
+int ols_parallel_local_multi(
+    const double *local_X,
+    const double *local_Y,
+    double *B,
+    int local_n,
+    int d,
+    int k,
+    workspace_t *scratch,
+    MPI_Comm comm
+);
+
+/*
+ * ols_normal_equations_local with k targets: XtY is d x k (rank 0 only)
+ */
+void ols_normal_equations_local_multi(
+    const double *local_X,
+    const double *local_Y,
+    int local_n,
+    int d,
+    int k,
+    double *XtX,
+    double *XtY,
+    MPI_Comm comm
+);
+
+/*
+ * k-fold cross-validated parallel OLS on pre-distributed data
+ * 
+ * Fold f holds the contiguous global rows given by
+ * get_row_partition(n, f, folds). One pass accumulates XtX, Xty and
+ * y^T y per fold and one reduction combines them; each training set is
+ * then the total minus one fold, and its held-out MSE follows from the
+ * fold's statistics (RSS = yty - 2 beta^T Xty + beta^T XtX beta), so
+ * the data is read once for all folds.
+ * 
+ * Parameters:
+ *   local_X - local_n x d row block owned by this rank
+ *   local_y - local_n x 1 response block
+ *   beta - d x 1 fit on all rows (output, valid on rank 0)
+ *   n - total number of samples
+ *   local_n - number of rows owned by this rank
+ *   start_row - global index of this rank's first row
+ *   d - number of features
+ *   folds - number of folds (2 <= folds <= n)
+ *   fold_mse - folds held-out MSEs (output, valid on rank 0)
+ *   mean_mse - mean of fold_mse (output, valid on rank 0)
+ *   comm - MPI communicator
+ * 
+ * Returns (same on every rank):
+ *   0 on success, -1 if a training system could not be solved
+ */
+int ols_cross_validate_local(
+    const double *local_X,
+    const double *local_y,
     double *beta,
     int n,
+    int local_n,
+    int start_row,
     int d,
+    int folds,
+    double *fold_mse,
+    double *mean_mse,
     MPI_Comm comm
 );
 
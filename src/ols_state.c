@@ -0,0 +1,200 @@
+/*
+ * ols_state.c - Persistent OLS sufficient statistics implementation
+ */
+
+#include "ols_state.h"
+#include "ols.h"
+#include "linear_solver.h"
+#include "timing.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+static const char OLS_STATE_MAGIC[8] = "PLRSTAT";
+
+/*
+ * On-disk header, padded to OLS_STATE_HEADER_SIZE bytes
+ */
+typedef struct {
+    char magic[8];
+    int64_t n;
+    int64_t d;
+    char reserved[OLS_STATE_HEADER_SIZE - 24];
+} ols_state_file_header_t;
+
+int ols_state_init(ols_state_t *state, int d) {
+    state->n = 0;
+    state->d = d;
+    state->XtX = (double *)calloc((size_t)d * d, sizeof(double));
+    state->Xty = (double *)calloc(d, sizeof(double));
+    state->yty = 0.0;
+    return (state->XtX && state->Xty) ? 0 : -1;
+}
+
+void ols_state_free(ols_state_t *state) {
+    free(state->XtX);
+    free(state->Xty);
+    state->XtX = NULL;
+    state->Xty = NULL;
+}
+
+int ols_state_load(const char *path, int d, ols_state_t *state, MPI_Comm comm) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    
+    timing_start("state.io");
+    
+    // Every rank needs its arrays: fail together if any allocation failed
+    int ok = (ols_state_init(state, d) == 0);
+    int all_ok;
+    MPI_Allreduce(&ok, &all_ok, 1, MPI_INT, MPI_LAND, comm);
+    if (!all_ok) {
+        if (!ok) {
+            fprintf(stderr, "Error: Memory allocation failed in ols_state_load\n");
+        }
+        ols_state_free(state);
+        timing_stop("state.io");
+        return -1;
+    }
+    
+    int status = 0;
+    if (rank == 0) {
+        FILE *f = fopen(path, "rb");
+        if (!f) {
+            status = 1;  // no state yet: start from zero
+        } else {
+            ols_state_file_header_t header;
+            size_t dd = (size_t)d * d;
+            if (fread(&header, sizeof(header), 1, f) != 1 ||
+                memcmp(header.magic, OLS_STATE_MAGIC, sizeof(OLS_STATE_MAGIC)) != 0) {
+                fprintf(stderr, "Error: '%s' is not a model state file\n", path);
+                status = -1;
+            } else if (header.d != d) {
+                fprintf(stderr, "Error: State file '%s' has d=%lld, expected d=%d\n",
+                        path, (long long)header.d, d);
+                status = -1;
+            } else if (fread(state->XtX, sizeof(double), dd, f) != dd ||
+                       fread(state->Xty, sizeof(double), d, f) != (size_t)d ||
+                       fread(&state->yty, sizeof(double), 1, f) != 1) {
+                fprintf(stderr, "Error: State file '%s' is truncated\n", path);
+                status = -1;
+            } else {
+                state->n = header.n;
+            }
+            fclose(f);
+        }
+    }
+    
+    MPI_Bcast(&status, 1, MPI_INT, 0, comm);
+    timing_stop("state.io");
+    return status;
+}
+
+int ols_state_save(const char *path, const ols_state_t *state, MPI_Comm comm) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    
+    timing_start("state.io");
+    int status = 0;
+    if (rank == 0) {
+        // Write to a temporary file and rename, so a failed save never
+        // destroys the previous state
+        char tmp_path[4096];
+        snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+        FILE *f = fopen(tmp_path, "wb");
+        if (!f) {
+            status = -1;
+        } else {
+            ols_state_file_header_t header;
+            size_t dd = (size_t)state->d * state->d;
+            memset(&header, 0, sizeof(header));
+            memcpy(header.magic, OLS_STATE_MAGIC, sizeof(OLS_STATE_MAGIC));
+            header.n = state->n;
+            header.d = state->d;
+            if (fwrite(&header, sizeof(header), 1, f) != 1 ||
+                fwrite(state->XtX, sizeof(double), dd, f) != dd ||
+                fwrite(state->Xty, sizeof(double), state->d, f) != (size_t)state->d ||
+                fwrite(&state->yty, sizeof(double), 1, f) != 1) {
+                status = -1;
+            }
+            if (fclose(f) != 0) {
+                status = -1;
+            }
+            if (status == 0 && rename(tmp_path, path) != 0) {
+                status = -1;
+            }
+        }
+        if (status != 0) {
+            fprintf(stderr, "Error: Failed to write state file '%s'\n", path);
+            remove(tmp_path);
+        }
+    }
+    
+    MPI_Bcast(&status, 1, MPI_INT, 0, comm);
+    timing_stop("state.io");
+    return status;
+}
+
+void ols_state_update(
+    ols_state_t *state,
+    const double *local_X,
+    const double *local_y,
+    int local_n,
+    MPI_Comm comm
+) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    int d = state->d;
+    
+    timing_start("state.update");
+    
+    // Step 1: XtX and Xty of the new rows, reduced to rank 0
+    double *new_XtX = NULL;
+    double *new_Xty = NULL;
+    if (rank == 0) {
+        new_XtX = (double *)malloc((size_t)d * d * sizeof(double));
+        new_Xty = (double *)malloc(d * sizeof(double));
+    }
+    ols_normal_equations_local(local_X, local_y, local_n, d, new_XtX, new_Xty, comm);
+    
+    // Step 2: Row count and yty of the new rows
+    double local_extra[2] = {(double)local_n, 0.0};
+    for (int k = 0; k < local_n; k++) {
+        local_extra[1] += local_y[k] * local_y[k];
+    }
+    double extra[2];
+    MPI_Reduce(local_extra, extra, 2, MPI_DOUBLE, MPI_SUM, 0, comm);
+    
+    // Step 3: Merge into the stored statistics
+    if (rank == 0) {
+        for (size_t i = 0; i < (size_t)d * d; i++) {
+            state->XtX[i] += new_XtX[i];
+        }
+        for (int j = 0; j < d; j++) {
+            state->Xty[j] += new_Xty[j];
+        }
+        state->n += (long long)extra[0];
+        state->yty += extra[1];
+        free(new_XtX);
+        free(new_Xty);
+    }
+    timing_stop("state.update");
+}
+
+int ols_state_solve(const ols_state_t *state, double *beta) {
+    int d = state->d;
+    
+    // solve_spd_system overwrites its matrix
+    timing_start("ols.solve");
+    double *A = (double *)malloc((size_t)d * d * sizeof(double));
+    memcpy(A, state->XtX, (size_t)d * d * sizeof(double));
+    int result = solve_spd_system(A, state->Xty, beta, d);
+    free(A);
+    timing_stop("ols.solve");
+    if (result != 0) {
+        fprintf(stderr, "Error: Failed to solve linear system from model state\n");
+        return -1;
+    }
+    return 0;
+}
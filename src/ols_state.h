@@ -0,0 +1,101 @@
+/*
+ * ols_state.h - Persistent OLS sufficient statistics
+ * 
+ * The OLS solution depends on the data only through XtX, Xty and the
+ * row count, so a model can be refitted after appending rows by
+ * scanning just the new rows and adding their contribution. yty is
+ * kept as well, which makes the residual sum of squares available
+ * without the data: RSS = yty - 2 beta^T Xty + beta^T XtX beta.
+ * 
+ * State file layout (native byte order):
+ *   header (64 bytes): magic "PLRSTAT\0", int64 n, int64 d, 40 reserved bytes
+ *   XtX: d x d values (full symmetric matrix), row-major
+ *   Xty: d values
+ *   yty: 1 value
+ */
+
+#ifndef OLS_STATE_H
+#define OLS_STATE_H
+
+#include <mpi.h>
+
+#define OLS_STATE_HEADER_SIZE 64
+
+typedef struct {
+    long long n;   // rows accumulated so far
+    int d;         // number of features
+    double *XtX;   // d x d
+    double *Xty;   // d x 1
+    double yty;
+} ols_state_t;
+
+/*
+ * Initialise an empty state (n = 0, all sums zero) for d features
+ * 
+ * Returns:
+ *   0 on success, -1 if allocation fails
+ */
+int ols_state_init(ols_state_t *state, int d);
+
+/*
+ * Release the arrays of a state
+ */
+void ols_state_free(ols_state_t *state);
+
+/*
+ * Load a state file on rank 0 (collective; other ranks get an empty state)
+ * 
+ * If the file does not exist, rank 0 gets an empty state, so the first
+ * update starts a new model.
+ * 
+ * Parameters:
+ *   path - state file
+ *   d - expected number of features
+ *   state - output, initialised by this call on every rank
+ *   comm - MPI communicator
+ * 
+ * Returns (same on every rank):
+ *   0 if loaded, 1 if the file does not exist, -1 if allocation fails
+ *   on any rank, on read error or if the file holds a different number
+ *   of features
+ */
+int ols_state_load(const char *path, int d, ols_state_t *state, MPI_Comm comm);
+
+/*
+ * Write rank 0's state to path (collective)
+ * 
+ * Returns:
+ *   0 on success, -1 on I/O error (same on every rank)
+ */
+int ols_state_save(const char *path, const ols_state_t *state, MPI_Comm comm);
+
+/*
+ * Add new pre-distributed rows to the state
+ * 
+ * Each rank accumulates its rows once; the contributions are reduced
+ * and merged into rank 0's state. Cost is O(new rows * d^2 / p).
+ * 
+ * Parameters:
+ *   state - state to update (merged on rank 0)
+ *   local_X - local_n x d new rows owned by this rank
+ *   local_y - local_n x 1 new responses owned by this rank
+ *   local_n - number of new rows owned by this rank
+ *   comm - MPI communicator
+ */
+void ols_state_update(
+    ols_state_t *state,
+    const double *local_X,
+    const double *local_y,
+    int local_n,
+    MPI_Comm comm
+);
+
+/*
+ * Solve XtX * beta = Xty from the state (rank 0 only)
+ * 
+ * Returns:
+ *   0 on success, -1 if the system could not be solved
+ */
+int ols_state_solve(const ols_state_t *state, double *beta);
+
+#endif // OLS_STATE_H
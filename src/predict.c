@@ -0,0 +1,280 @@
+/*
+ * predict.c - Distributed batch prediction and scoring implementation
+ */
+
+#include "predict.h"
+#include "kernels.h"
+#include "timing.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+static const char BETA_MAGIC[8] = "PLRBETA";
+
+typedef struct {
+    char magic[8];
+    int64_t d;
+    char reserved[BETA_HEADER_SIZE - 16];
+} beta_file_header_t;
+
+/*
+ * Mergeable residual summary; kept as plain doubles so it travels as
+ * one MPI datatype
+ */
+typedef struct {
+    double count;
+    double mean_y;     // running mean of y
+    double m2_y;       // sum of squared deviations of y from mean_y
+    double sse;        // sum of squared residuals
+    double sum_r;      // sum of residuals
+    double max_abs_r;
+    double errors;     // ranks that hit an I/O error
+} score_summary_t;
+
+#define SCORE_SUMMARY_FIELDS 7
+
+/*
+ * b = a (+) b: Chan et al. pairwise update for the mean and M2 of y,
+ * plain sums and max for the residual terms
+ */
+static void summary_merge(const score_summary_t *a, score_summary_t *b) {
+    b->errors += a->errors;
+    double count = a->count + b->count;
+    if (count == 0.0) {
+        return;
+    }
+    double delta = b->mean_y - a->mean_y;
+    b->m2_y += a->m2_y + delta * delta * a->count * b->count / count;
+    b->mean_y = a->mean_y + delta * b->count / count;
+    b->count = count;
+    b->sse += a->sse;
+    b->sum_r += a->sum_r;
+    if (a->max_abs_r > b->max_abs_r) {
+        b->max_abs_r = a->max_abs_r;
+    }
+}
+
+static void summary_op(void *in, void *inout, int *len, MPI_Datatype *type) {
+    (void)type;
+    const score_summary_t *a = (const score_summary_t *)in;
+    score_summary_t *b = (score_summary_t *)inout;
+    for (int i = 0; i < *len; i++) {
+        summary_merge(&a[i], &b[i]);
+    }
+}
+
+/*
+ * Summary of one chunk: two passes over data that is still in cache
+ */
+static void summarize_chunk(const double *y, const double *pred, int rows,
+                            score_summary_t *chunk) {
+    double sum_y = 0.0;
+    for (int i = 0; i < rows; i++) {
+        sum_y += y[i];
+    }
+    double mean_y = sum_y / rows;
+    
+    double m2_y = 0.0, sse = 0.0, sum_r = 0.0, max_abs_r = 0.0;
+    for (int i = 0; i < rows; i++) {
+        double dy = y[i] - mean_y;
+        double r = y[i] - pred[i];
+        m2_y += dy * dy;
+        sse += r * r;
+        sum_r += r;
+        if (fabs(r) > max_abs_r) max_abs_r = fabs(r);
+    }
+    
+    chunk->count = rows;
+    chunk->mean_y = mean_y;
+    chunk->m2_y = m2_y;
+    chunk->sse = sse;
+    chunk->sum_r = sum_r;
+    chunk->max_abs_r = max_abs_r;
+    chunk->errors = 0.0;
+}
+
+int beta_write(const char *path, const double *beta, int d, MPI_Comm comm) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    
+    int status = 0;
+    if (rank == 0) {
+        FILE *f = fopen(path, "wb");
+        beta_file_header_t header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, BETA_MAGIC, sizeof(BETA_MAGIC));
+        header.d = d;
+        if (!f ||
+            fwrite(&header, sizeof(header), 1, f) != 1 ||
+            fwrite(beta, sizeof(double), d, f) != (size_t)d) {
+            status = -1;
+        }
+        if (f && fclose(f) != 0) {
+            status = -1;
+        }
+        if (status != 0) {
+            fprintf(stderr, "Error: Failed to write coefficient file '%s'\n", path);
+        }
+    }
+    
+    MPI_Bcast(&status, 1, MPI_INT, 0, comm);
+    return status;
+}
+
+int beta_read(const char *path, double *beta, int d, MPI_Comm comm) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    
+    int status = 0;
+    if (rank == 0) {
+        FILE *f = fopen(path, "rb");
+        beta_file_header_t header;
+        if (!f) {
+            fprintf(stderr, "Error: Cannot open coefficient file '%s'\n", path);
+            status = -1;
+        } else if (fread(&header, sizeof(header), 1, f) != 1 ||
+                   memcmp(header.magic, BETA_MAGIC, sizeof(BETA_MAGIC)) != 0) {
+            fprintf(stderr, "Error: '%s' is not a coefficient file\n", path);
+            status = -1;
+        } else if (header.d != d) {
+            fprintf(stderr, "Error: Coefficient file '%s' has d=%lld, data has d=%d\n",
+                    path, (long long)header.d, d);
+            status = -1;
+        } else if (fread(beta, sizeof(double), d, f) != (size_t)d) {
+            fprintf(stderr, "Error: Coefficient file '%s' is truncated\n", path);
+            status = -1;
+        }
+        if (f) {
+            fclose(f);
+        }
+    }
+    
+    MPI_Bcast(&status, 1, MPI_INT, 0, comm);
+    if (status == 0) {
+        MPI_Bcast(beta, d, MPI_DOUBLE, 0, comm);
+    }
+    return status;
+}
+
+int predict_stream(
+    row_stream_t *stream,
+    const double *beta,
+    const char *pred_path,
+    int n,
+    score_t *score,
+    MPI_Comm comm
+) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    int d = stream->d;
+    score_summary_t local = {0};
+    
+    // Step 1: Open the prediction file (collective) and size it once
+    int ok = 1;
+    MPI_File fh = MPI_FILE_NULL;
+    if (pred_path) {
+        if (MPI_File_open(comm, pred_path, MPI_MODE_CREATE | MPI_MODE_WRONLY,
+                          MPI_INFO_NULL, &fh) != MPI_SUCCESS) {
+            if (rank == 0) {
+                fprintf(stderr, "Error: Cannot create prediction file '%s'\n", pred_path);
+            }
+            return -1;
+        }
+        if (MPI_File_set_size(fh, (MPI_Offset)n * sizeof(double)) != MPI_SUCCESS) {
+            fprintf(stderr, "Error: Cannot size prediction file '%s'\n", pred_path);
+            ok = 0;
+        }
+    }
+    
+    // Step 2: Predict chunk by chunk; two output buffers so the write of
+    // one chunk overlaps the next chunk's reads and compute
+    double *pred[2];
+    pred[0] = (double *)malloc((size_t)stream->chunk_rows * sizeof(double));
+    pred[1] = (double *)malloc((size_t)stream->chunk_rows * sizeof(double));
+    if (!pred[0] || !pred[1]) {
+        fprintf(stderr, "Error: Memory allocation failed in predict_stream\n");
+        ok = 0;
+    }
+    int all_ok;
+    MPI_Allreduce(&ok, &all_ok, 1, MPI_INT, MPI_LAND, comm);
+    if (!all_ok) {
+        if (pred_path) {
+            MPI_File_close(&fh);
+        }
+        free(pred[0]);
+        free(pred[1]);
+        return -1;
+    }
+    MPI_Request write_req[2] = {MPI_REQUEST_NULL, MPI_REQUEST_NULL};
+    
+    const double *chunk_X;
+    const double *chunk_y;
+    int rows;
+    int done_rows = 0;
+    int buf = 0;
+    while ((rows = row_stream_next(stream, &chunk_X, &chunk_y)) > 0) {
+        // The buffer is free once its previous write has completed
+        timing_start("predict.write");
+        MPI_Wait(&write_req[buf], MPI_STATUS_IGNORE);
+        timing_stop("predict.write");
+        
+        timing_start("predict.compute");
+        predict_rows(chunk_X, beta, rows, d, pred[buf]);
+        score_summary_t chunk;
+        summarize_chunk(chunk_y, pred[buf], rows, &chunk);
+        summary_merge(&chunk, &local);
+        timing_stop("predict.compute");
+        
+        if (pred_path) {
+            MPI_Offset offset = ((MPI_Offset)stream->start_row + done_rows) * sizeof(double);
+            if (MPI_File_iwrite_at(fh, offset, pred[buf], rows, MPI_DOUBLE,
+                                   &write_req[buf]) != MPI_SUCCESS) {
+                local.errors = 1.0;
+            }
+        }
+        done_rows += rows;
+        buf ^= 1;
+    }
+    if (rows < 0) {
+        fprintf(stderr, "Error: Failed to read row chunk while predicting\n");
+        local.errors = 1.0;
+    }
+    timing_start("predict.write");
+    MPI_Waitall(2, write_req, MPI_STATUSES_IGNORE);
+    timing_stop("predict.write");
+    if (pred_path) {
+        MPI_File_close(&fh);
+    }
+    free(pred[0]);
+    free(pred[1]);
+    
+    // Step 3: One collective combines all summaries (and error flags)
+    // with the merge operator
+    MPI_Datatype summary_type;
+    MPI_Type_contiguous(SCORE_SUMMARY_FIELDS, MPI_DOUBLE, &summary_type);
+    MPI_Type_commit(&summary_type);
+    MPI_Op summary_mpi_op;
+    MPI_Op_create(summary_op, 1, &summary_mpi_op);
+    
+    score_summary_t global = {0};
+    timing_start("predict.reduce");
+    MPI_Allreduce(&local, &global, 1, summary_type, summary_mpi_op, comm);
+    timing_stop("predict.reduce");
+    MPI_Op_free(&summary_mpi_op);
+    MPI_Type_free(&summary_type);
+    
+    double count = global.count > 0 ? global.count : 1.0;
+    double mean_r = global.sum_r / count;
+    double var_r = global.sse / count - mean_r * mean_r;
+    score->n = (long long)global.count;
+    score->mse = global.sse / count;
+    score->rmse = sqrt(score->mse);
+    score->r2 = (global.m2_y > 0.0) ? 1.0 - global.sse / global.m2_y : 0.0;
+    score->mean_residual = mean_r;
+    score->residual_std = sqrt(var_r > 0.0 ? var_r : 0.0);
+    score->max_abs_residual = global.max_abs_r;
+    
+    return (global.errors == 0.0) ? 0 : -1;
+}
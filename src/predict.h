@@ -0,0 +1,79 @@
+/*
+ * predict.h - Distributed batch prediction and scoring
+ * 
+ * Coefficient file layout (native byte order):
+ *   header (64 bytes): magic "PLRBETA\0", int64 d, 48 reserved bytes
+ *   beta: d float64 values
+ * 
+ * Prediction file layout: n float64 values in row order, no header.
+ */
+
+#ifndef PREDICT_H
+#define PREDICT_H
+
+#include <mpi.h>
+#include "stream.h"
+
+#define BETA_HEADER_SIZE 64
+
+/*
+ * Scores of a prediction pass
+ */
+typedef struct {
+    long long n;               // rows scored
+    double mse;                // mean squared residual
+    double rmse;
+    double r2;                 // 1 - SSE / SST
+    double mean_residual;      // mean of y - prediction
+    double residual_std;       // population std of the residuals
+    double max_abs_residual;
+} score_t;
+
+/*
+ * Write beta (rank 0's copy) to a coefficient file (collective)
+ * 
+ * Returns:
+ *   0 on success, -1 on I/O error (same on every rank)
+ */
+int beta_write(const char *path, const double *beta, int d, MPI_Comm comm);
+
+/*
+ * Read a coefficient file on rank 0 and broadcast it (collective)
+ * 
+ * Returns:
+ *   0 on success, -1 if the file is missing, invalid or does not hold
+ *   d coefficients (same on every rank)
+ */
+int beta_read(const char *path, double *beta, int d, MPI_Comm comm);
+
+/*
+ * Predict and score every row of each rank's stream (collective)
+ * 
+ * Each chunk is predicted while it is cache resident, its residual
+ * statistics are folded into a running summary, and the predictions are
+ * written with non-blocking MPI-IO at the rows' global offsets while
+ * the next chunk is processed. The per-rank summaries are combined with
+ * a single MPI_Allreduce using a custom operator (parallel mean/variance
+ * merge), so R^2 does not suffer from sum-of-squares cancellation.
+ * 
+ * Parameters:
+ *   stream - this rank's row stream (rows must be contiguous in n)
+ *   beta - d x 1 coefficients (on every rank)
+ *   pred_path - prediction file to write, or NULL to only score
+ *   n - total number of rows over all ranks
+ *   score - output, on every rank
+ *   comm - MPI communicator
+ * 
+ * Returns (same on every rank):
+ *   0 on success, -1 on allocation, read or write error
+ */
+int predict_stream(
+    row_stream_t *stream,
+    const double *beta,
+    const char *pred_path,
+    int n,
+    score_t *score,
+    MPI_Comm comm
+);
+
+#endif // PREDICT_H
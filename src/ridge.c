@@ -0,0 +1,123 @@
+/*
+ * ridge.c - Ridge regression path implementation
+ */
+
+#include "ridge.h"
+#include "linear_solver.h"
+#include "timing.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+// Eigenvalues below this fraction of the largest are treated as zero
+// (lambda = 0 on a rank-deficient XtX gives the minimum-norm solution)
+#define RIDGE_RCOND 1e-12
+
+int ridge_path(
+    const ols_state_t *state,
+    const double *lambdas,
+    int num_lambdas,
+    double *betas,
+    double *mse
+) {
+    int d = state->d;
+    double *w = (double *)malloc(d * sizeof(double));
+    double *V = (double *)malloc((size_t)d * d * sizeof(double));
+    double *z = (double *)malloc(d * sizeof(double));
+    double *c = (double *)malloc(d * sizeof(double));
+    int status = -1;
+    if (!w || !V || !z || !c) {
+        fprintf(stderr, "Error: Memory allocation failed in ridge path\n");
+        goto done;
+    }
+    
+    // Step 1: XtX = V * diag(w) * V^T, once for all lambdas
+    timing_start("ridge.eigen");
+    status = symmetric_eigen(state->XtX, d, w, V);
+    timing_stop("ridge.eigen");
+    if (status != 0) {
+        goto done;
+    }
+    
+    // Step 2: z = V^T * Xty
+    for (int i = 0; i < d; i++) {
+        z[i] = 0.0;
+    }
+    for (int j = 0; j < d; j++) {
+        const double *v_row = V + (size_t)j * d;
+        double xty = state->Xty[j];
+        for (int i = 0; i < d; i++) {
+            z[i] += v_row[i] * xty;
+        }
+    }
+    double cutoff = RIDGE_RCOND * (w[d - 1] > 0.0 ? w[d - 1] : 0.0);
+    
+    // Step 3: per lambda, beta = V * c with c = z / (w + lambda)
+    timing_start("ridge.path");
+    for (int l = 0; l < num_lambdas; l++) {
+        double lambda = lambdas[l];
+        double fit = 0.0;   // beta^T Xty = sum c_i z_i
+        double quad = 0.0;  // beta^T XtX beta = sum w_i c_i^2
+        for (int i = 0; i < d; i++) {
+            double denom = w[i] + lambda;
+            c[i] = (denom > cutoff) ? z[i] / denom : 0.0;
+            fit += c[i] * z[i];
+            quad += w[i] * c[i] * c[i];
+        }
+        
+        double *beta = betas + (size_t)l * d;
+        for (int j = 0; j < d; j++) {
+            const double *v_row = V + (size_t)j * d;
+            double sum = 0.0;
+            for (int i = 0; i < d; i++) {
+                sum += v_row[i] * c[i];
+            }
+            beta[j] = sum;
+        }
+        
+        if (mse) {
+            double rss = state->yty - 2.0 * fit + quad;
+            mse[l] = (state->n > 0) ? (rss > 0.0 ? rss : 0.0) / (double)state->n : 0.0;
+        }
+    }
+    timing_stop("ridge.path");
+    
+done:
+    free(w);
+    free(V);
+    free(z);
+    free(c);
+    return status;
+}
+
+int ridge_path_local(
+    const double *local_X,
+    const double *local_y,
+    int local_n,
+    int d,
+    const double *lambdas,
+    int num_lambdas,
+    double *betas,
+    double *mse,
+    MPI_Comm comm
+) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    
+    // Steps 1-2: One pass and one reduction for XtX, Xty, yty and n
+    ols_state_t state;
+    if (ols_state_init(&state, d) != 0) {
+        fprintf(stderr, "Error: Memory allocation failed in ridge path\n");
+        MPI_Abort(comm, 1);
+    }
+    ols_state_update(&state, local_X, local_y, local_n, comm);
+    
+    // Step 3: Every lambda on rank 0
+    int status = 0;
+    if (rank == 0) {
+        status = ridge_path(&state, lambdas, num_lambdas, betas, mse);
+    }
+    ols_state_free(&state);
+    
+    MPI_Bcast(&status, 1, MPI_INT, 0, comm);
+    return status;
+}
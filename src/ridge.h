@@ -0,0 +1,73 @@
+/*
+ * ridge.h - Ridge regression path
+ * 
+ * Solves (XtX + lambda * I) * beta = Xty for many penalties from one
+ * data pass and one eigendecomposition XtX = V * diag(w) * V^T:
+ * 
+ *   beta(lambda) = V * diag(1 / (w + lambda)) * V^T * Xty
+ * 
+ * so each extra lambda costs O(d^2). The penalty is on the sum of
+ * squares scale: beta minimises ||y - X * beta||^2 + lambda * ||beta||^2.
+ */
+
+#ifndef RIDGE_H
+#define RIDGE_H
+
+#include <mpi.h>
+#include "ols_state.h"
+
+/*
+ * Ridge path from sufficient statistics (serial)
+ * 
+ * Training MSE comes from the quadratic-form identity
+ * RSS = yty - 2 beta^T Xty + beta^T XtX beta, evaluated in the
+ * eigenbasis in O(d), so the data is never rescanned.
+ * 
+ * Parameters:
+ *   state - XtX, Xty, yty and row count (see ols_state.h)
+ *   lambdas - num_lambdas penalties (>= 0)
+ *   num_lambdas - number of penalties
+ *   betas - num_lambdas x d coefficients, one row per lambda (output)
+ *   mse - num_lambdas training MSEs (output, may be NULL)
+ * 
+ * Returns:
+ *   0 on success, -1 if allocation or the eigendecomposition failed
+ */
+int ridge_path(
+    const ols_state_t *state,
+    const double *lambdas,
+    int num_lambdas,
+    double *betas,
+    double *mse
+);
+
+/*
+ * Parallel ridge path on pre-distributed data
+ * 
+ * One pass over each rank's rows and one reduction; rank 0 then runs
+ * ridge_path. Results are only valid on rank 0.
+ * 
+ * Parameters:
+ *   local_X - local_n x d row block owned by this rank
+ *   local_y - local_n x 1 response block
+ *   local_n - number of rows owned by this rank
+ *   d - number of features
+ *   lambdas, num_lambdas, betas, mse - as for ridge_path
+ *   comm - MPI communicator
+ * 
+ * Returns (same on every rank):
+ *   0 on success, -1 on failure
+ */
+int ridge_path_local(
+    const double *local_X,
+    const double *local_y,
+    int local_n,
+    int d,
+    const double *lambdas,
+    int num_lambdas,
+    double *betas,
+    double *mse,
+    MPI_Comm comm
+);
+
+#endif // RIDGE_H
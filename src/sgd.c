@@ -0,0 +1,132 @@
+/*
+ * sgd.c - Mini-batch SGD implementation
+ */
+
+#include "sgd.h"
+#include "data.h"
+#include "kernels.h"
+#include "timing.h"
+#include <stdlib.h>
+#include <string.h>
+
+// RNG stream for the row shuffles (data generation uses 1-15)
+#define STREAM_SHUFFLE 16
+
+void sgd_default_config(sgd_config_t *config) {
+    config->batch_size = 256;
+    config->local_steps = 8;
+    config->steps = 1000;
+    config->learning_rate = 0.01;
+    config->decay = 0.0;
+    config->seed = 42;
+}
+
+/*
+ * Fisher-Yates shuffle of this rank's row order for one epoch
+ * 
+ * Draws are keyed on (epoch, global row index), so the order depends
+ * only on the seed and the partition, not on earlier calls.
+ */
+static void shuffle_rows(int *order, int local_n, int start_row, int epoch,
+                         unsigned int seed) {
+    for (int i = 0; i < local_n; i++) {
+        order[i] = i;
+    }
+    for (int i = local_n - 1; i > 0; i--) {
+        uint64_t counter = ((uint64_t)epoch << 32) | (uint64_t)(start_row + i);
+        int j = (int)(counter_random(seed, STREAM_SHUFFLE, counter) % (uint64_t)(i + 1));
+        int tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+}
+
+/*
+ * beta = sum over ranks of (local_n / n) * beta
+ */
+static void average_models(double *beta, double *scratch, int d,
+                           int n, int local_n, MPI_Comm comm) {
+    double weight = (double)local_n / n;
+    for (int j = 0; j < d; j++) {
+        scratch[j] = weight * beta[j];
+    }
+    timing_start("sgd.allreduce");
+    MPI_Allreduce(scratch, beta, d, MPI_DOUBLE, MPI_SUM, comm);
+    timing_stop("sgd.allreduce");
+}
+
+void sgd_parallel_local(
+    const double *local_X,
+    const double *local_y,
+    double *beta,
+    int n,
+    int local_n,
+    int start_row,
+    int d,
+    const sgd_config_t *config,
+    MPI_Comm comm
+) {
+    int batch = config->batch_size;
+    if (batch > local_n) batch = local_n;
+    if (batch < 1) batch = 1;
+    int local_steps = (config->local_steps < 1) ? 1 : config->local_steps;
+    
+    // Gathered mini-batch rows, contiguous for the fused gradient kernel
+    double *batch_X = (double *)malloc((size_t)batch * d * sizeof(double));
+    double *batch_y = (double *)malloc(batch * sizeof(double));
+    double *gradient = (double *)malloc(d * sizeof(double));
+    double *scratch = (double *)malloc(d * sizeof(double));
+    int *order = (int *)malloc((local_n > 0 ? local_n : 1) * sizeof(int));
+    
+    // Initialize beta = 0 (identical on every rank)
+    for (int j = 0; j < d; j++) {
+        beta[j] = 0.0;
+    }
+    
+    int epoch = 0;
+    int pos = local_n;  // forces a shuffle before the first batch
+    for (int step = 0; step < config->steps; step++) {
+        if (local_n > 0) {
+            timing_start("sgd.compute");
+            // 1. Next mini-batch from this rank's shuffled rows
+            for (int b = 0; b < batch; b++) {
+                if (pos == local_n) {
+                    shuffle_rows(order, local_n, start_row, epoch++, config->seed);
+                    pos = 0;
+                }
+                int row = order[pos++];
+                memcpy(batch_X + (size_t)b * d, local_X + (size_t)row * d,
+                       d * sizeof(double));
+                batch_y[b] = local_y[row];
+            }
+            
+            // 2. Mean gradient of the batch
+            memset(gradient, 0, d * sizeof(double));
+            gd_gradient_fused(batch_X, batch_y, beta, batch, d, gradient);
+            
+            // 3. Local update with the scheduled step size
+            double lr = config->learning_rate / (1.0 + config->decay * step);
+            double scale = lr / batch;
+            for (int j = 0; j < d; j++) {
+                beta[j] -= scale * gradient[j];
+            }
+            timing_stop("sgd.compute");
+        }
+        
+        // 4. Average models every K steps
+        if ((step + 1) % local_steps == 0) {
+            average_models(beta, scratch, d, n, local_n, comm);
+        }
+    }
+    
+    // Final averaging unless the last step already did it
+    if (config->steps % local_steps != 0) {
+        average_models(beta, scratch, d, n, local_n, comm);
+    }
+    
+    free(batch_X);
+    free(batch_y);
+    free(gradient);
+    free(scratch);
+    free(order);
+}
@@ -0,0 +1,61 @@
+/*
+ * sgd.h - Mini-batch stochastic gradient descent
+ * 
+ * Local SGD on pre-distributed row blocks: every rank takes K steps on
+ * mini-batches drawn from its own shuffled rows, then the models are
+ * averaged with one MPI_Allreduce. Communication drops by a factor of
+ * K compared with synchronising every step.
+ */
+
+#ifndef SGD_H
+#define SGD_H
+
+#include <mpi.h>
+
+typedef struct {
+    int batch_size;        // rows per mini-batch on each rank
+    int local_steps;       // K: steps between model averaging (1 = synchronous)
+    int steps;             // total steps taken by each rank
+    double learning_rate;  // initial step size
+    double decay;          // step t uses learning_rate / (1 + decay * t)
+    unsigned int seed;     // shuffle seed
+} sgd_config_t;
+
+/*
+ * Fill in the default configuration (batch 256, K = 8, 1000 steps,
+ * learning rate 0.01, no decay, seed 42)
+ */
+void sgd_default_config(sgd_config_t *config);
+
+/*
+ * Parallel local SGD on pre-distributed data
+ * 
+ * Each rank reshuffles its rows every local epoch and walks through
+ * them in mini-batches; the step is learning_rate_t times the mean
+ * gradient of the batch. Models are averaged every local_steps steps
+ * and once at the end, weighted by each rank's row count.
+ * 
+ * Parameters:
+ *   local_X - local_n x d row block owned by this rank
+ *   local_y - local_n x 1 response block owned by this rank
+ *   beta - d x 1 output parameters (on every rank)
+ *   n - total number of samples
+ *   local_n - number of rows owned by this rank
+ *   start_row - global index of this rank's first row
+ *   d - number of features
+ *   config - SGD parameters
+ *   comm - MPI communicator
+ */
+void sgd_parallel_local(
+    const double *local_X,
+    const double *local_y,
+    double *beta,
+    int n,
+    int local_n,
+    int start_row,
+    int d,
+    const sgd_config_t *config,
+    MPI_Comm comm
+);
+
+#endif // SGD_H
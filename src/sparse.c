@@ -0,0 +1,106 @@
+/*
+ * sparse.c - CSR matrix implementation
+ */
+
+#include "sparse.h"
+#include <stdlib.h>
+
+int csr_alloc(csr_matrix_t *X, int rows, int d, int nnz) {
+    X->rows = rows;
+    X->d = d;
+    X->row_ptr = (int *)malloc(((size_t)rows + 1) * sizeof(int));
+    X->col_idx = (int *)malloc((nnz > 0 ? (size_t)nnz : 1) * sizeof(int));
+    X->val = (double *)malloc((nnz > 0 ? (size_t)nnz : 1) * sizeof(double));
+    if (!X->row_ptr || !X->col_idx || !X->val) {
+        csr_free(X);
+        return -1;
+    }
+    X->row_ptr[0] = 0;
+    return 0;
+}
+
+void csr_free(csr_matrix_t *X) {
+    free(X->row_ptr);
+    free(X->col_idx);
+    free(X->val);
+    X->row_ptr = NULL;
+    X->col_idx = NULL;
+    X->val = NULL;
+    X->rows = 0;
+}
+
+int csr_nnz(const csr_matrix_t *X) {
+    if (!X->row_ptr) {
+        return 0;
+    }
+    return X->row_ptr[X->rows] - X->row_ptr[0];
+}
+
+csr_matrix_t csr_row_block(const csr_matrix_t *X, int start_row, int rows) {
+    csr_matrix_t block = *X;
+    block.rows = rows;
+    block.row_ptr = X->row_ptr + start_row;
+    return block;
+}
+
+/*
+ * Row offset i of either a CSR row_ptr (ptr32) or int64 offsets
+ * (ptr64, used when ptr32 is NULL), widened to int64
+ */
+static int64_t row_offset(const int *ptr32, const int64_t *ptr64, int i) {
+    return ptr32 ? (int64_t)ptr32[i] : ptr64[i];
+}
+
+/*
+ * First row r with work(0..r) >= total * part / parts, where the work
+ * of rows [0, r) is their nonzeros plus r; offsets come from ptr32 or
+ * ptr64 (see row_offset), so both partitions apply the same rule
+ */
+static int partition_boundary(const int *ptr32, const int64_t *ptr64, int rows,
+                              int part, int parts) {
+    int64_t base = row_offset(ptr32, ptr64, 0);
+    long long total = (long long)(row_offset(ptr32, ptr64, rows) - base) + rows;
+    long long target = total * part;
+    
+    // Work is strictly increasing in r, so binary search the boundary
+    int lo = 0;
+    int hi = rows;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        long long work = (long long)(row_offset(ptr32, ptr64, mid) - base) + mid;
+        if (work * parts >= target) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return lo;
+}
+
+void csr_row_partition(
+    const int *row_ptr,
+    int rows,
+    int part,
+    int parts,
+    int *local_n,
+    int *start_row
+) {
+    int first = partition_boundary(row_ptr, NULL, rows, part, parts);
+    int last = partition_boundary(row_ptr, NULL, rows, part + 1, parts);
+    *start_row = first;
+    *local_n = last - first;
+}
+
+void csr_row_partition64(
+    const int64_t *row_offsets,
+    int rows,
+    int part,
+    int parts,
+    int *local_n,
+    int *start_row
+) {
+    int first = partition_boundary(NULL, row_offsets, rows, part, parts);
+    int last = partition_boundary(NULL, row_offsets, rows, part + 1, parts);
+    *start_row = first;
+    *local_n = last - first;
+}
@@ -0,0 +1,106 @@
+/*
+ * sparse.h - Compressed sparse row (CSR) feature matrices
+ * 
+ * For one-hot or bag-of-words features, where densifying X would
+ * multiply memory and flops by 1 / density. Rows are distributed in
+ * contiguous blocks like the dense data, but the blocks are balanced
+ * by nonzeros rather than by row count.
+ */
+
+#ifndef SPARSE_H
+#define SPARSE_H
+
+#include <stdint.h>
+
+/*
+ * In-memory kind of the X operand the solvers' shared kernels take as
+ * a void pointer (distinct from the on-disk DATASET_DTYPE_* values)
+ */
+typedef enum {
+    X_DENSE_F64,  // row-major double block
+    X_DENSE_F32,  // row-major float block (float64 accumulation)
+    X_CSR         // csr_matrix_t
+} x_kind_t;
+
+/*
+ * CSR matrix: the nonzeros of row i are val[row_ptr[i] .. row_ptr[i+1])
+ * in columns col_idx[...], strictly increasing within each row
+ * 
+ * row_ptr values index col_idx/val directly, so a range of rows is just
+ * a view with an offset row_ptr (see csr_row_block). Owned matrices
+ * (csr_alloc) start at row_ptr[0] = 0.
+ * 
+ * Offsets are int, so one matrix (one rank's block) holds at most
+ * INT32_MAX nonzeros; global counts across ranks are int64 (see
+ * dataset.h).
+ */
+typedef struct {
+    int rows;          // number of rows
+    int d;             // number of columns (features)
+    int *row_ptr;      // rows + 1 offsets
+    int *col_idx;      // nnz column indices
+    double *val;       // nnz values
+} csr_matrix_t;
+
+/*
+ * Allocate an owned rows x d matrix with room for nnz nonzeros;
+ * row_ptr[0] is set to 0
+ * 
+ * Returns:
+ *   0 on success, -1 if allocation failed
+ */
+int csr_alloc(csr_matrix_t *X, int rows, int d, int nnz);
+
+/*
+ * Release an owned matrix (safe on a zeroed struct)
+ */
+void csr_free(csr_matrix_t *X);
+
+/*
+ * Number of nonzeros of X
+ */
+int csr_nnz(const csr_matrix_t *X);
+
+/*
+ * View of rows [start_row, start_row + rows) sharing X's arrays
+ */
+csr_matrix_t csr_row_block(const csr_matrix_t *X, int start_row, int rows);
+
+/*
+ * Nonzero-balanced row partition (CSR counterpart of get_row_partition)
+ * 
+ * Splits the rows into parts contiguous blocks with about equal work,
+ * counting each row as its nonzeros plus one (so empty rows still
+ * cost something).
+ * 
+ * Parameters:
+ *   row_ptr - rows + 1 offsets of the matrix
+ *   rows - number of rows
+ *   part - index of the block to return (rank or thread)
+ *   parts - number of blocks
+ *   local_n - number of rows in the block (output)
+ *   start_row - first row of the block (output)
+ */
+void csr_row_partition(
+    const int *row_ptr,
+    int rows,
+    int part,
+    int parts,
+    int *local_n,
+    int *start_row
+);
+
+/*
+ * csr_row_partition over int64 offsets, for row offsets of a whole
+ * dataset whose nonzeros may exceed INT32_MAX
+ */
+void csr_row_partition64(
+    const int64_t *row_offsets,
+    int rows,
+    int part,
+    int parts,
+    int *local_n,
+    int *start_row
+);
+
+#endif // SPARSE_H
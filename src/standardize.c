@@ -0,0 +1,229 @@
+/*
+ * standardize.c - Distributed feature standardisation implementation
+ */
+
+#include "standardize.h"
+#include "threads.h"
+#include "timing.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*
+ * Mergeable column moments, packed as plain doubles so they travel as
+ * one MPI datatype: [count, mean[0..d), m2[0..d)]
+ */
+#define MOMENTS_LEN(d) (1 + 2 * (size_t)(d))
+
+/*
+ * b = a (+) b: Chan et al. pairwise update of the means and M2 sums
+ */
+static void moments_merge(const double *a, double *b, int d) {
+    double count = a[0] + b[0];
+    if (a[0] == 0.0) {
+        return;
+    }
+    const double *mean_a = a + 1;
+    const double *m2_a = a + 1 + d;
+    double *mean_b = b + 1;
+    double *m2_b = b + 1 + d;
+    double weight = a[0] * b[0] / count;
+    double frac = a[0] / count;
+    for (int j = 0; j < d; j++) {
+        double delta = mean_a[j] - mean_b[j];
+        m2_b[j] += m2_a[j] + delta * delta * weight;
+        mean_b[j] += delta * frac;
+    }
+    b[0] = count;
+}
+
+static void moments_op(void *in, void *inout, int *len, MPI_Datatype *type) {
+    // d is implied by the size of the contiguous datatype
+    int bytes;
+    MPI_Type_size(*type, &bytes);
+    size_t fields = (size_t)bytes / sizeof(double);
+    int d = (int)((fields - 1) / 2);
+    const double *a = (const double *)in;
+    double *b = (double *)inout;
+    for (int i = 0; i < *len; i++) {
+        moments_merge(a + i * fields, b + i * fields, d);
+    }
+}
+
+/*
+ * Welford's update over a block of rows (single thread); one division
+ * per row, and the column loop vectorises
+ */
+static void moments_block(const double *X, int rows, int d, double *moments) {
+    double *mean = moments + 1;
+    double *m2 = moments + 1 + d;
+    memset(moments, 0, MOMENTS_LEN(d) * sizeof(double));
+    for (int i = 0; i < rows; i++) {
+        const double *x_row = X + (size_t)i * d;
+        double inv_count = 1.0 / (i + 1);
+        for (int j = 0; j < d; j++) {
+            double delta = x_row[j] - mean[j];
+            mean[j] += delta * inv_count;
+            m2[j] += delta * (x_row[j] - mean[j]);
+        }
+    }
+    moments[0] = rows;
+}
+
+/*
+ * Moments of this rank's rows, with the rows split across OpenMP
+ * threads and the per-thread moments merged in thread order
+ */
+static void moments_local(const double *X, int rows, int d, double *moments) {
+    int num_threads = get_row_threads(rows, ROW_MIN_ROWS_PER_THREAD);
+    if (num_threads <= 1) {
+        moments_block(X, rows, d, moments);
+        return;
+    }
+    
+#ifdef _OPENMP
+    size_t len = MOMENTS_LEN(d);
+    double *thread_moments = (double *)malloc(num_threads * len * sizeof(double));
+    int team = num_threads;
+    
+    #pragma omp parallel num_threads(num_threads)
+    {
+        // The team may be smaller than requested (e.g. OMP_THREAD_LIMIT):
+        // split the rows over, and merge only, the threads actually granted
+        int tid = omp_get_thread_num();
+        int nt = omp_get_num_threads();
+        if (tid == 0) {
+            team = nt;
+        }
+        int block_n, block_start;
+        get_row_partition(rows, tid, nt, &block_n, &block_start);
+        moments_block(X + (size_t)block_start * d, block_n, d, thread_moments + tid * len);
+    }
+    
+    memcpy(moments, thread_moments, len * sizeof(double));
+    for (int t = 1; t < team; t++) {
+        moments_merge(thread_moments + t * len, moments, d);
+    }
+    free(thread_moments);
+#endif
+}
+
+int standardize_compute(
+    const double *local_X,
+    int local_n,
+    int d,
+    feature_scaling_t *scaling,
+    MPI_Comm comm
+) {
+    size_t len = MOMENTS_LEN(d);
+    double *local = (double *)malloc(len * sizeof(double));
+    double *global = (double *)malloc(len * sizeof(double));
+    scaling->n = 0;
+    scaling->d = d;
+    scaling->mean = (double *)malloc(d * sizeof(double));
+    scaling->std = (double *)malloc(d * sizeof(double));
+    scaling->scale = (double *)malloc(d * sizeof(double));
+    int ok = local && global && scaling->mean && scaling->std && scaling->scale;
+    int all_ok;
+    MPI_Allreduce(&ok, &all_ok, 1, MPI_INT, MPI_LAND, comm);
+    if (!all_ok) {
+        fprintf(stderr, "Error: Memory allocation failed in standardize_compute\n");
+        free(local);
+        free(global);
+        standardize_free(scaling);
+        return -1;
+    }
+    
+    // Step 1: One pass over the local rows
+    timing_start("standardize.moments");
+    moments_local(local_X, local_n, d, local);
+    timing_stop("standardize.moments");
+    
+    // Step 2: One collective merges all ranks' moments
+    MPI_Datatype moments_type;
+    MPI_Type_contiguous((int)len, MPI_DOUBLE, &moments_type);
+    MPI_Type_commit(&moments_type);
+    MPI_Op moments_mpi_op;
+    MPI_Op_create(moments_op, 1, &moments_mpi_op);
+    timing_start("standardize.reduce");
+    MPI_Allreduce(local, global, 1, moments_type, moments_mpi_op, comm);
+    timing_stop("standardize.reduce");
+    MPI_Op_free(&moments_mpi_op);
+    MPI_Type_free(&moments_type);
+    
+    // Step 3: Scale by the root mean square (no centring, see standardize.h)
+    double count = global[0];
+    scaling->n = (long long)count;
+    for (int j = 0; j < d; j++) {
+        double mean = global[1 + j];
+        double var = (count > 0.0) ? global[1 + d + j] / count : 0.0;
+        double rms = sqrt(mean * mean + var);
+        scaling->mean[j] = mean;
+        scaling->std[j] = sqrt(var);
+        scaling->scale[j] = (rms > 0.0) ? rms : 1.0;
+    }
+    
+    free(local);
+    free(global);
+    return 0;
+}
+
+/*
+ * Scale a block of rows by inv_scale (single thread)
+ */
+static void apply_block(double *X, int rows, int d, const double *inv_scale) {
+    for (int i = 0; i < rows; i++) {
+        double *x_row = X + (size_t)i * d;
+        for (int j = 0; j < d; j++) {
+            x_row[j] *= inv_scale[j];
+        }
+    }
+}
+
+void standardize_apply(double *local_X, int local_n, const feature_scaling_t *scaling) {
+    int d = scaling->d;
+    double *inv_scale = (double *)malloc(d * sizeof(double));
+    for (int j = 0; j < d; j++) {
+        inv_scale[j] = 1.0 / scaling->scale[j];
+    }
+    
+    timing_start("standardize.apply");
+    int num_threads = get_row_threads(local_n, ROW_MIN_ROWS_PER_THREAD);
+    if (num_threads <= 1) {
+        apply_block(local_X, local_n, d, inv_scale);
+    } else {
+#ifdef _OPENMP
+        #pragma omp parallel num_threads(num_threads)
+        {
+            // Split over the granted team, which may be smaller than requested
+            int block_n, block_start;
+            get_row_partition(local_n, omp_get_thread_num(), omp_get_num_threads(),
+                              &block_n, &block_start);
+            apply_block(local_X + (size_t)block_start * d, block_n, d, inv_scale);
+        }
+#endif
+    }
+    timing_stop("standardize.apply");
+    free(inv_scale);
+}
+
+void standardize_unscale_beta(const feature_scaling_t *scaling, double *beta) {
+    for (int j = 0; j < scaling->d; j++) {
+        beta[j] /= scaling->scale[j];
+    }
+}
+
+void standardize_free(feature_scaling_t *scaling) {
+    free(scaling->mean);
+    free(scaling->std);
+    free(scaling->scale);
+    scaling->mean = NULL;
+    scaling->std = NULL;
+    scaling->scale = NULL;
+}
@@ -0,0 +1,71 @@
+/*
+ * standardize.h - Distributed feature standardisation
+ * 
+ * Gradient methods at a fixed learning rate converge at a speed set by
+ * the condition number of XtX, which badly scaled columns inflate by
+ * the square of the scale ratio. One pass over each rank's rows gives
+ * the column means and variances (Welford per thread, Chan's pairwise
+ * merge across threads and ranks), X is rescaled in place, and the
+ * fitted coefficients are mapped back to the original units.
+ * 
+ * The model has no intercept, so columns are divided by their root
+ * mean square sqrt(mean^2 + var) but not centred: centring would
+ * change the fitted model, while pure scaling is an exact change of
+ * variables (beta = gamma / scale) that makes diag(XtX) / n = 1.
+ */
+
+#ifndef STANDARDIZE_H
+#define STANDARDIZE_H
+
+#include <mpi.h>
+
+typedef struct {
+    long long n;    // rows seen across all ranks
+    int d;          // number of features
+    double *mean;   // d column means
+    double *std;    // d column standard deviations (population)
+    double *scale;  // d divisors applied to the columns (1 for all-zero columns)
+} feature_scaling_t;
+
+/*
+ * Column moments of the distributed rows (collective)
+ * 
+ * Reads X once; the per-rank moments travel as one MPI datatype and
+ * are combined by a single Allreduce with a merge operator. Ranks may
+ * hold no rows.
+ * 
+ * Parameters:
+ *   local_X - local_n x d row block owned by this rank
+ *   local_n - number of rows owned by this rank
+ *   d - number of features
+ *   scaling - output, allocated by this call, same on every rank
+ *   comm - MPI communicator
+ * 
+ * Returns:
+ *   0 on success, -1 if allocation fails
+ */
+int standardize_compute(
+    const double *local_X,
+    int local_n,
+    int d,
+    feature_scaling_t *scaling,
+    MPI_Comm comm
+);
+
+/*
+ * Divide every column of the row block by its scale, in place
+ */
+void standardize_apply(double *local_X, int local_n, const feature_scaling_t *scaling);
+
+/*
+ * Map coefficients fitted on scaled columns back to the original
+ * units: beta[j] /= scale[j]
+ */
+void standardize_unscale_beta(const feature_scaling_t *scaling, double *beta);
+
+/*
+ * Release the arrays of a scaling
+ */
+void standardize_free(feature_scaling_t *scaling);
+
+#endif // STANDARDIZE_H
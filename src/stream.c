@@ -0,0 +1,186 @@
+/*
+ * stream.c - Chunked row stream implementation
+ */
+
+#include "stream.h"
+#include "data.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+/*
+ * Fill buffer b with the chunk starting at stream->next_row
+ * (asynchronously for files) and advance next_row
+ */
+static int fetch_chunk(row_stream_t *stream, int b) {
+    int rows = stream->local_n - stream->next_row;
+    if (rows > stream->chunk_rows) rows = stream->chunk_rows;
+    stream->buf_rows[b] = rows;
+    if (rows <= 0) {
+        stream->buf_rows[b] = 0;
+        return 0;
+    }
+    
+    int row = stream->start_row + stream->next_row;
+    stream->next_row += rows;
+    
+    if (stream->kind == ROW_STREAM_GENERATOR) {
+        generate_synthetic_data_local(stream->buf_X[b], stream->buf_y[b], NULL,
+                                      stream->d, row, rows, stream->seed);
+        return 0;
+    }
+    
+    // Read whole rows so the count stays within int range for any d
+    MPI_Offset x_off = DATASET_HEADER_SIZE + (MPI_Offset)row * stream->d * sizeof(double);
+    MPI_Offset y_off = DATASET_HEADER_SIZE + (MPI_Offset)stream->n * stream->d * sizeof(double)
+                       + (MPI_Offset)row * sizeof(double);
+    int err = MPI_File_iread_at(stream->fh, x_off, stream->buf_X[b],
+                                rows, stream->row_type, &stream->req[b][0]);
+    err |= MPI_File_iread_at(stream->fh, y_off, stream->buf_y[b],
+                             rows, MPI_DOUBLE, &stream->req[b][1]);
+    return err == MPI_SUCCESS ? 0 : -1;
+}
+
+static int alloc_buffers(row_stream_t *stream) {
+    for (int b = 0; b < 2; b++) {
+        stream->buf_X[b] = (double *)malloc((size_t)stream->chunk_rows * stream->d * sizeof(double));
+        stream->buf_y[b] = (double *)malloc(stream->chunk_rows * sizeof(double));
+        stream->req[b][0] = MPI_REQUEST_NULL;
+        stream->req[b][1] = MPI_REQUEST_NULL;
+        if (!stream->buf_X[b] || !stream->buf_y[b]) {
+            fprintf(stderr, "Error: Memory allocation failed for stream buffers\n");
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int row_stream_open_file(
+    row_stream_t *stream,
+    const char *path,
+    const dataset_header_t *header,
+    int start_row,
+    int local_n,
+    int chunk_rows
+) {
+    memset(stream, 0, sizeof(*stream));
+    stream->kind = ROW_STREAM_FILE;
+    stream->d = header->d;
+    stream->n = header->n;
+    stream->start_row = start_row;
+    stream->local_n = local_n;
+    stream->chunk_rows = chunk_rows;
+    stream->fh = MPI_FILE_NULL;
+    stream->row_type = MPI_DATATYPE_NULL;
+    
+    if (header->dtype != DATASET_DTYPE_FLOAT64 ||
+        header->layout != DATASET_LAYOUT_ROW_MAJOR) {
+        fprintf(stderr, "Error: Unsupported dataset dtype %d / layout %d\n",
+                header->dtype, header->layout);
+        return -1;
+    }
+    if (alloc_buffers(stream) != 0) {
+        return -1;
+    }
+    if (MPI_File_open(MPI_COMM_SELF, path, MPI_MODE_RDONLY,
+                      MPI_INFO_NULL, &stream->fh) != MPI_SUCCESS) {
+        fprintf(stderr, "Error: Cannot open dataset file '%s'\n", path);
+        stream->fh = MPI_FILE_NULL;
+        return -1;
+    }
+    
+    // Non-blocking reads past the end of the file are not reliably
+    // reported short, so the file must cover this rank's rows of y
+    MPI_Offset file_size = 0;
+    MPI_Offset needed = DATASET_HEADER_SIZE + (MPI_Offset)header->n * header->d * sizeof(double)
+                        + (MPI_Offset)(start_row + local_n) * sizeof(double);
+    MPI_File_get_size(stream->fh, &file_size);
+    if (file_size < needed) {
+        fprintf(stderr, "Error: Dataset file '%s' is truncated\n", path);
+        return -1;
+    }
+    MPI_Type_contiguous(stream->d, MPI_DOUBLE, &stream->row_type);
+    MPI_Type_commit(&stream->row_type);
+    
+    // Start reading the first chunk right away
+    return fetch_chunk(stream, 0);
+}
+
+void row_stream_open_generator(
+    row_stream_t *stream,
+    int d,
+    unsigned int seed,
+    int start_row,
+    int local_n,
+    int chunk_rows
+) {
+    memset(stream, 0, sizeof(*stream));
+    stream->kind = ROW_STREAM_GENERATOR;
+    stream->d = d;
+    stream->seed = seed;
+    stream->start_row = start_row;
+    stream->local_n = local_n;
+    stream->chunk_rows = chunk_rows;
+    stream->fh = MPI_FILE_NULL;
+    stream->row_type = MPI_DATATYPE_NULL;
+    
+    if (alloc_buffers(stream) != 0) {
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    fetch_chunk(stream, 0);
+}
+
+int row_stream_next(row_stream_t *stream, const double **X, const double **y) {
+    int cur = stream->current;
+    
+    int rows = stream->buf_rows[cur];
+    if (stream->kind == ROW_STREAM_FILE) {
+        // A read past the end of a truncated file completes short
+        MPI_Status status[2];
+        int x_rows = 0;
+        int y_rows = 0;
+        if (MPI_Waitall(2, stream->req[cur], status) != MPI_SUCCESS) {
+            return -1;
+        }
+        if (rows > 0) {
+            MPI_Get_count(&status[0], stream->row_type, &x_rows);
+            MPI_Get_count(&status[1], MPI_DOUBLE, &y_rows);
+            if (x_rows != rows || y_rows != rows) {
+                return -1;
+            }
+        }
+    }
+    
+    if (rows == 0) {
+        return 0;
+    }
+    
+    // Prefetch the following chunk into the other buffer, which the
+    // caller finished with on the previous call
+    if (fetch_chunk(stream, 1 - cur) != 0) {
+        return -1;
+    }
+    stream->current = 1 - cur;
+    
+    *X = stream->buf_X[cur];
+    *y = stream->buf_y[cur];
+    return rows;
+}
+
+void row_stream_close(row_stream_t *stream) {
+    for (int b = 0; b < 2; b++) {
+        if (stream->kind == ROW_STREAM_FILE) {
+            MPI_Waitall(2, stream->req[b], MPI_STATUSES_IGNORE);
+        }
+        free(stream->buf_X[b]);
+        free(stream->buf_y[b]);
+        stream->buf_X[b] = NULL;
+        stream->buf_y[b] = NULL;
+    }
+    if (stream->fh != MPI_FILE_NULL) {
+        MPI_File_close(&stream->fh);
+    }
+    if (stream->row_type != MPI_DATATYPE_NULL) {
+        MPI_Type_free(&stream->row_type);
+    }
+}
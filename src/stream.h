@@ -0,0 +1,89 @@
+/*
+ * stream.h - Chunked row streams
+ * 
+ * Deliver a rank's row range in fixed-size chunks from either a dataset
+ * file or the synthetic generator, so solvers that only need sums over
+ * rows can run in O(chunk_rows * d) memory. File streams are double
+ * buffered: the next chunk is read with non-blocking MPI-IO while the
+ * caller works on the current one.
+ */
+
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <mpi.h>
+#include "dataset.h"
+
+#define ROW_STREAM_FILE      0
+#define ROW_STREAM_GENERATOR 1
+
+typedef struct {
+    int kind;          // ROW_STREAM_*
+    int d;             // number of features
+    int start_row;     // first global row of this rank's range
+    int local_n;       // rows in this rank's range
+    int chunk_rows;    // rows per chunk
+    int next_row;      // offset (within the range) of the next chunk to fetch
+    int current;       // buffer holding the chunk handed out next
+    
+    double *buf_X[2];  // chunk_rows x d
+    double *buf_y[2];  // chunk_rows x 1
+    int buf_rows[2];   // rows held by each buffer
+    
+    // File source
+    MPI_File fh;
+    int n;             // total rows in the file
+    MPI_Datatype row_type;  // one row of X, so read counts are in rows
+    MPI_Request req[2][2];
+    
+    // Generator source
+    unsigned int seed;
+} row_stream_t;
+
+/*
+ * Open a stream over rows [start_row, start_row + local_n) of a dataset
+ * file and start prefetching the first chunk. Local (not collective).
+ * 
+ * Returns:
+ *   0 on success, -1 on error (including a file too short for the
+ *   rows), or unsupported dtype/layout
+ */
+int row_stream_open_file(
+    row_stream_t *stream,
+    const char *path,
+    const dataset_header_t *header,
+    int start_row,
+    int local_n,
+    int chunk_rows
+);
+
+/*
+ * Open a stream that generates rows [start_row, start_row + local_n) of
+ * the synthetic dataset chunk by chunk (see generate_synthetic_data_local)
+ */
+void row_stream_open_generator(
+    row_stream_t *stream,
+    int d,
+    unsigned int seed,
+    int start_row,
+    int local_n,
+    int chunk_rows
+);
+
+/*
+ * Get the next chunk
+ * 
+ * The returned pointers stay valid until the following call.
+ * 
+ * Returns:
+ *   number of rows in the chunk, 0 at the end of the range, -1 on error
+ *   (including a file read that returned fewer rows than requested)
+ */
+int row_stream_next(row_stream_t *stream, const double **X, const double **y);
+
+/*
+ * Release buffers and close the file
+ */
+void row_stream_close(row_stream_t *stream);
+
+#endif // STREAM_H
@@ -0,0 +1,93 @@
+/*
+ * bench_syrk.c - Micro-benchmark of the XtX accumulation
+ * 
+ * Compares the original rank-1 update loop of ols_parallel against the
+ * cache-blocked syrk_lower kernel and reports GFLOP/s
+ * 
+ * Usage: bench_syrk [n] [repeats]
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "../data.h"
+#include "../kernels.h"
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/*
+ * Original loop: full d x d rank-1 update per row
+ */
+static void xtx_reference(const double *X, int n, int d, double *XtX) {
+    for (int k = 0; k < n; k++) {
+        for (int i = 0; i < d; i++) {
+            double val_i = X[(size_t)k * d + i];
+            for (int j = 0; j < d; j++) {
+                XtX[i * d + j] += val_i * X[(size_t)k * d + j];
+            }
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int n = (argc > 1) ? atoi(argv[1]) : 20000;
+    int repeats = (argc > 2) ? atoi(argv[2]) : 3;
+    int dims[] = {10, 50, 100, 200, 500};
+    int num_dims = sizeof(dims) / sizeof(dims[0]);
+    
+    printf("=== XtX kernel benchmark (n=%d, isa=%s) ===\n", n, kernel_isa_name());
+    printf("d,reference_gflops,syrk_gflops,speedup,max_rel_diff\n");
+    
+    for (int t = 0; t < num_dims; t++) {
+        int d = dims[t];
+        double *X = (double *)malloc((size_t)n * d * sizeof(double));
+        double *y = (double *)malloc(n * sizeof(double));
+        double *C_ref = (double *)malloc(d * d * sizeof(double));
+        double *C_syrk = (double *)malloc(d * d * sizeof(double));
+        generate_synthetic_data_local(X, y, NULL, d, 0, n, 42);
+        
+        // The reference updates all d^2 entries per row, the SYRK kernel
+        // only the d(d+1)/2 of the lower triangle: count each's own flops
+        double ref_flops = 2.0 * n * (double)d * d;
+        double syrk_flops = (double)n * d * (d + 1);
+        double best_ref = 1e30, best_syrk = 1e30;
+        
+        for (int r = 0; r < repeats; r++) {
+            memset(C_ref, 0, d * d * sizeof(double));
+            double t0 = now();
+            xtx_reference(X, n, d, C_ref);
+            double t1 = now();
+            if (t1 - t0 < best_ref) best_ref = t1 - t0;
+            
+            memset(C_syrk, 0, d * d * sizeof(double));
+            t0 = now();
+            syrk_lower(X, n, d, C_syrk);
+            syrk_mirror(C_syrk, d);
+            t1 = now();
+            if (t1 - t0 < best_syrk) best_syrk = t1 - t0;
+        }
+        
+        double max_diff = 0.0;
+        for (int i = 0; i < d * d; i++) {
+            double diff = fabs(C_ref[i] - C_syrk[i]) / (fabs(C_ref[i]) + 1.0);
+            if (diff > max_diff) max_diff = diff;
+        }
+        
+        printf("%d,%.3f,%.3f,%.2f,%.2e\n", d, ref_flops / best_ref * 1e-9,
+               syrk_flops / best_syrk * 1e-9, best_ref / best_syrk, max_diff);
+        
+        free(X);
+        free(y);
+        free(C_ref);
+        free(C_syrk);
+    }
+    return 0;
+}
@@ -0,0 +1,131 @@
+/*
+ * test_cv.c - Test k-fold cross-validation from per-fold statistics
+ * 
+ * Compares every fold with an explicit fit on the training rows and
+ * compute_mse on the held-out rows
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <mpi.h>
+#include "../data.h"
+#include "../ols.h"
+#include "../utils.h"
+
+/*
+ * Largest relative error between the per-fold MSEs and explicit
+ * refits, and of beta against a fit on all rows (rank 0 only)
+ */
+static double check_folds(const double *X, const double *y, int n, int d, int folds,
+                          const double *fold_mse, double mean_mse, const double *beta) {
+    double *train_X = (double *)malloc((size_t)n * d * sizeof(double));
+    double *train_y = (double *)malloc(n * sizeof(double));
+    double *pred = (double *)malloc(n * sizeof(double));
+    double *fit = (double *)malloc(d * sizeof(double));
+    double max_err = 0.0;
+    double mean = 0.0;
+    
+    for (int f = 0; f < folds; f++) {
+        int fold_n, fold_start;
+        get_row_partition(n, f, folds, &fold_n, &fold_start);
+        
+        // Training rows: everything outside [fold_start, fold_start + fold_n)
+        int rows = 0;
+        for (int i = 0; i < n; i++) {
+            if (i < fold_start || i >= fold_start + fold_n) {
+                memcpy(train_X + (size_t)rows * d, X + (size_t)i * d, d * sizeof(double));
+                train_y[rows++] = y[i];
+            }
+        }
+        ols_serial(train_X, train_y, fit, rows, d);
+        
+        for (int i = 0; i < fold_n; i++) {
+            const double *x = X + (size_t)(fold_start + i) * d;
+            double p = 0.0;
+            for (int j = 0; j < d; j++) {
+                p += x[j] * fit[j];
+            }
+            pred[i] = p;
+        }
+        double ref = compute_mse(y + fold_start, pred, fold_n);
+        double err = fabs(fold_mse[f] - ref) / ref;
+        if (err > max_err) max_err = err;
+        mean += ref / folds;
+    }
+    
+    double err = fabs(mean_mse - mean) / mean;
+    if (err > max_err) max_err = err;
+    ols_serial(X, y, fit, n, d);
+    err = vector_diff_norm(fit, beta, d);
+    if (err > max_err) max_err = err;
+    
+    free(train_X);
+    free(train_y);
+    free(pred);
+    free(fit);
+    return max_err;
+}
+
+int main(int argc, char *argv[]) {
+    MPI_Init(&argc, &argv);
+    
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    
+    // Test parameters: fold boundaries fall inside rank blocks
+    int n = 1003;
+    int d = 8;
+    unsigned int seed = 42;
+    int fold_counts[] = {2, 5, 7};
+    
+    if (rank == 0) {
+        printf("=== Testing Cross-Validation ===\n");
+        printf("Problem size: n=%d, d=%d\n", n, d);
+        printf("Number of processes: %d\n\n", size);
+    }
+    
+    int local_n, start_row;
+    get_row_partition(n, rank, size, &local_n, &start_row);
+    double *local_X = (double *)malloc((size_t)local_n * d * sizeof(double));
+    double *local_y = (double *)malloc(local_n * sizeof(double));
+    generate_synthetic_data_local(local_X, local_y, NULL, d, start_row, local_n, seed);
+    
+    double *X = NULL;
+    double *y = NULL;
+    if (rank == 0) {
+        X = (double *)malloc((size_t)n * d * sizeof(double));
+        y = (double *)malloc(n * sizeof(double));
+        generate_synthetic_data_local(X, y, NULL, d, 0, n, seed);
+    }
+    
+    double *beta = (double *)malloc(d * sizeof(double));
+    for (int c = 0; c < 3; c++) {
+        int folds = fold_counts[c];
+        double *fold_mse = (double *)malloc(folds * sizeof(double));
+        double mean_mse = 0.0;
+        int status = ols_cross_validate_local(local_X, local_y, beta, n, local_n, start_row,
+                                              d, folds, fold_mse, &mean_mse, MPI_COMM_WORLD);
+        if (rank == 0) {
+            double err = check_folds(X, y, n, d, folds, fold_mse, mean_mse, beta);
+            printf("%d folds: mean MSE %.6e, max error %.3e\n", folds, mean_mse, err);
+            if (status == 0 && err < 1e-9) {
+                printf("✓ TEST PASSED: %d-fold CV matches explicit refits\n", folds);
+            } else {
+                printf("✗ TEST FAILED: %d-fold CV differs from explicit refits\n", folds);
+            }
+        }
+        free(fold_mse);
+    }
+    
+    free(local_X);
+    free(local_y);
+    free(X);
+    free(y);
+    free(beta);
+    
+    MPI_Finalize();
+    return 0;
+}
@@ -69,6 +69,30 @@ int main() {
         printf("✗ Reproducibility test FAILED\n");
     }
     
+    // Test partition independence: blocks generated separately must be
+    // bit-identical to the same rows of the full dataset
+    printf("\n--- Testing block generation for different partitions ---\n");
+    int block_identical = 1;
+    for (int parts = 1; parts <= 4; parts++) {
+        for (int p = 0; p < parts; p++) {
+            int local_n = n / parts + (p < n % parts ? 1 : 0);
+            int start_row = p * (n / parts) + (p < n % parts ? p : n % parts);
+            generate_synthetic_data_local(X2, y2, beta_true2, d, start_row, local_n, seed);
+            for (int i = 0; i < local_n * d; i++) {
+                if (X2[i] != X[start_row * d + i]) block_identical = 0;
+            }
+            for (int i = 0; i < local_n; i++) {
+                if (y2[i] != y[start_row + i]) block_identical = 0;
+            }
+        }
+    }
+    
+    if (block_identical) {
+        printf("✓ Partition test PASSED: Blocks match full data for 1-4 parts\n");
+    } else {
+        printf("✗ Partition test FAILED\n");
+    }
+    
     // Clean up
     free(X);
     free(y);
@@ -0,0 +1,167 @@
+/*
+ * test_dataset.c - Test binary dataset write/read round trip
+ * 
+ * Writes a synthetic dataset collectively (float64 and float32 X) and
+ * reads it back with a different row block per rank, checks the
+ * memory-mapped path against it, and checks that a truncated file is
+ * rejected
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include "../data.h"
+#include "../dataset.h"
+#include "../kernels.h"
+#include "../utils.h"
+
+int main(int argc, char *argv[]) {
+    MPI_Init(&argc, &argv);
+    
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    
+    // Test parameters
+    int n = 103;
+    int d = 4;
+    unsigned int seed = 42;
+    const char *path = "test_dataset.bin";
+    
+    if (rank == 0) {
+        printf("=== Testing Dataset File I/O ===\n");
+        printf("Problem size: n=%d, d=%d, processes=%d\n\n", n, d, size);
+    }
+    
+    // Write: every rank generates and writes its own block
+    int local_n, start_row;
+    get_row_partition(n, rank, size, &local_n, &start_row);
+    double *X = (double *)malloc(n * d * sizeof(double));
+    double *y = (double *)malloc(n * sizeof(double));
+    generate_synthetic_data_local(X, y, NULL, d, start_row, local_n, seed);
+    dataset_write_local(path, n, d, X, y, start_row, local_n, MPI_COMM_WORLD);
+    
+    // Read back with the reversed partition (rank r reads block size-1-r)
+    dataset_header_t header;
+    int ok = (dataset_read_header(path, &header, MPI_COMM_WORLD) == 0);
+    ok = ok && header.n == n && header.d == d;
+    
+    int read_n, read_start;
+    get_row_partition(n, size - 1 - rank, size, &read_n, &read_start);
+    double *X_read = (double *)malloc(n * d * sizeof(double));
+    double *y_read = (double *)malloc(n * sizeof(double));
+    ok = ok && dataset_read_local(path, &header, X_read, y_read,
+                                  read_start, read_n, MPI_COMM_WORLD) == 0;
+    
+    // Compare against freshly generated rows
+    generate_synthetic_data_local(X, y, NULL, d, read_start, read_n, seed);
+    for (int i = 0; i < read_n * d; i++) {
+        if (X[i] != X_read[i]) ok = 0;
+    }
+    for (int i = 0; i < read_n; i++) {
+        if (y[i] != y_read[i]) ok = 0;
+    }
+    
+    int all_ok;
+    MPI_Reduce(&ok, &all_ok, 1, MPI_INT, MPI_LAND, 0, MPI_COMM_WORLD);
+    if (rank == 0) {
+        if (all_ok) {
+            printf("✓ TEST PASSED: Dataset round trip is bit-exact\n");
+        } else {
+            printf("✗ TEST FAILED: Dataset read does not match written data\n");
+        }
+        remove(path);
+    }
+    
+    // float32 X: write this rank's block narrowed, read it back reversed
+    generate_synthetic_data_local(X, y, NULL, d, start_row, local_n, seed);
+    float *X32 = (float *)malloc(n * d * sizeof(float));
+    float *X32_read = (float *)malloc(n * d * sizeof(float));
+    convert_f64_to_f32(X, X32, (size_t)local_n * d);
+    ok = dataset_write_local_f32(path, n, d, X32, y, start_row, local_n,
+                                 MPI_COMM_WORLD) == 0;
+    ok = ok && dataset_read_header(path, &header, MPI_COMM_WORLD) == 0;
+    ok = ok && header.dtype == DATASET_DTYPE_FLOAT32;
+    ok = ok && dataset_read_local_f32(path, &header, X32_read, y_read,
+                                      read_start, read_n, MPI_COMM_WORLD) == 0;
+    
+    generate_synthetic_data_local(X, y, NULL, d, read_start, read_n, seed);
+    convert_f64_to_f32(X, X32, (size_t)read_n * d);
+    for (int i = 0; i < read_n * d; i++) {
+        if (X32[i] != X32_read[i]) ok = 0;
+    }
+    for (int i = 0; i < read_n; i++) {
+        if (y[i] != y_read[i]) ok = 0;
+    }
+    
+    MPI_Reduce(&ok, &all_ok, 1, MPI_INT, MPI_LAND, 0, MPI_COMM_WORLD);
+    if (rank == 0) {
+        if (all_ok) {
+            printf("✓ TEST PASSED: float32 dataset round trip is bit-exact\n");
+        } else {
+            printf("✗ TEST FAILED: float32 dataset read does not match written data\n");
+        }
+        remove(path);
+    }
+    free(X32);
+    free(X32_read);
+    
+    // Memory-mapped rows (-m) must match the MPI-IO read of the same rows
+    generate_synthetic_data_local(X, y, NULL, d, start_row, local_n, seed);
+    dataset_write_local(path, n, d, X, y, start_row, local_n, MPI_COMM_WORLD);
+    ok = dataset_read_header(path, &header, MPI_COMM_WORLD) == 0;
+    ok = ok && dataset_read_local(path, &header, X_read, y_read,
+                                  read_start, read_n, MPI_COMM_WORLD) == 0;
+    dataset_mapping_t mapping;
+    ok = ok && dataset_map_local(path, &header, read_start, read_n, &mapping) == 0;
+    if (ok && read_n > 0) {
+        for (int i = 0; i < read_n * d; i++) {
+            if (mapping.X[i] != X_read[i]) ok = 0;
+        }
+        for (int i = 0; i < read_n; i++) {
+            if (mapping.y[i] != y_read[i]) ok = 0;
+        }
+    }
+    dataset_unmap(&mapping);
+    
+    MPI_Reduce(&ok, &all_ok, 1, MPI_INT, MPI_LAND, 0, MPI_COMM_WORLD);
+    if (rank == 0) {
+        if (all_ok) {
+            printf("✓ TEST PASSED: Mapped rows match dataset_read_local\n");
+        } else {
+            printf("✗ TEST FAILED: Mapped rows differ from dataset_read_local\n");
+        }
+    }
+    
+    // Truncated file: drop the last response, the header must be rejected
+    // and mapping with the stale header must fail instead of faulting
+    MPI_File fh;
+    MPI_File_open(MPI_COMM_WORLD, path, MPI_MODE_WRONLY, MPI_INFO_NULL, &fh);
+    MPI_File_set_size(fh, DATASET_HEADER_SIZE + (MPI_Offset)n * d * sizeof(double)
+                      + (MPI_Offset)(n - 1) * sizeof(double));
+    MPI_File_close(&fh);
+    int map_status = dataset_map_local(path, &header, 0, n, &mapping);
+    dataset_unmap(&mapping);
+    int truncated_status = dataset_read_header(path, &header, MPI_COMM_WORLD);
+    if (rank == 0) {
+        if (truncated_status == -1) {
+            printf("✓ TEST PASSED: Truncated dataset file is rejected\n");
+        } else {
+            printf("✗ TEST FAILED: Truncated dataset file was accepted\n");
+        }
+        if (map_status == -1) {
+            printf("✓ TEST PASSED: Mapping a truncated dataset file fails cleanly\n");
+        } else {
+            printf("✗ TEST FAILED: Mapping a truncated dataset file succeeded\n");
+        }
+        remove(path);
+    }
+    
+    free(X);
+    free(y);
+    free(X_read);
+    free(y_read);
+    
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,120 @@
+/*
+ * test_gd.c - Test parallel GD implementation
+ * 
+ * Compares parallel GD with serial GD, checks that the root and
+ * allreduce communication modes give bit-identical results, and that
+ * Gram-matrix GD follows the data-space iterations
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include "../data.h"
+#include "../gd.h"
+#include "../utils.h"
+
+int main(int argc, char *argv[]) {
+    MPI_Init(&argc, &argv);
+    
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    
+    // Test parameters
+    int n = 1000;
+    int d = 10;
+    int iterations = 200;
+    double learning_rate = 0.1;
+    unsigned int seed = 42;
+    
+    // Every rank generates its own block
+    int local_n, start_row;
+    get_row_partition(n, rank, size, &local_n, &start_row);
+    double *local_X = (double *)malloc((size_t)local_n * d * sizeof(double));
+    double *local_y = (double *)malloc(local_n * sizeof(double));
+    generate_synthetic_data_local(local_X, local_y, NULL, d, start_row, local_n, seed);
+    
+    double *beta_root = (double *)malloc(d * sizeof(double));
+    double *beta_allreduce = (double *)malloc(d * sizeof(double));
+    
+    if (rank == 0) {
+        printf("=== Testing Parallel GD ===\n");
+        printf("Problem size: n=%d, d=%d, iterations=%d\n", n, d, iterations);
+        printf("Number of processes: %d\n\n", size);
+    }
+    
+    double *beta_gram = (double *)malloc(d * sizeof(double));
+    
+    // Data-space iterations for the communication-mode comparison
+    gd_set_mode(GD_MODE_DATA);
+    gd_set_comm_mode(GD_COMM_ROOT);
+    gd_parallel_local(local_X, local_y, beta_root, n, local_n, d,
+                      iterations, learning_rate, MPI_COMM_WORLD);
+    
+    gd_set_comm_mode(GD_COMM_ALLREDUCE);
+    gd_parallel_local(local_X, local_y, beta_allreduce, n, local_n, d,
+                      iterations, learning_rate, MPI_COMM_WORLD);
+    gd_set_comm_mode(GD_COMM_ROOT);
+    
+    gd_set_mode(GD_MODE_GRAM);
+    gd_parallel_local(local_X, local_y, beta_gram, n, local_n, d,
+                      iterations, learning_rate, MPI_COMM_WORLD);
+    gd_set_mode(GD_MODE_DATA);
+    
+    if (rank == 0) {
+        // Serial reference on the full dataset
+        double *X = (double *)malloc((size_t)n * d * sizeof(double));
+        double *y = (double *)malloc(n * sizeof(double));
+        double *beta_serial = (double *)malloc(d * sizeof(double));
+        generate_synthetic_data_local(X, y, NULL, d, 0, n, seed);
+        gd_serial(X, y, beta_serial, n, d, iterations, learning_rate);
+        
+        double diff = vector_diff_norm(beta_serial, beta_root, d);
+        printf("Difference ||beta_serial - beta_parallel|| = %.10e\n", diff);
+        if (diff < 1e-8) {
+            printf("✓ TEST PASSED: Parallel and serial GD match\n");
+        } else {
+            printf("✗ TEST FAILED: Parallel GD differs (%.6e)\n", diff);
+        }
+        
+        int identical = 1;
+        for (int j = 0; j < d; j++) {
+            if (beta_root[j] != beta_allreduce[j]) identical = 0;
+        }
+        if (identical) {
+            printf("✓ TEST PASSED: Root and allreduce modes are bit-identical\n");
+        } else {
+            printf("✗ TEST FAILED: Root and allreduce modes differ\n");
+        }
+        
+        // Gram iterations follow the same trajectory up to rounding
+        diff = vector_diff_norm(beta_root, beta_gram, d);
+        printf("Difference ||beta_data - beta_gram|| = %.10e\n", diff);
+        if (diff < 1e-8) {
+            printf("✓ TEST PASSED: Gram-matrix GD matches data-space GD\n");
+        } else {
+            printf("✗ TEST FAILED: Gram-matrix GD differs (%.6e)\n", diff);
+        }
+        
+        // Cost model: long runs on tall data go to d-space, short ones do not
+        gd_set_mode(GD_MODE_AUTO);
+        if (gd_uses_gram(100000, 100, 1000) && !gd_uses_gram(100000, 100, 10)) {
+            printf("✓ TEST PASSED: Automatic mode selection\n");
+        } else {
+            printf("✗ TEST FAILED: Automatic mode selection\n");
+        }
+        
+        free(X);
+        free(y);
+        free(beta_serial);
+    }
+    
+    free(local_X);
+    free(local_y);
+    free(beta_root);
+    free(beta_allreduce);
+    free(beta_gram);
+    
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,91 @@
+/*
+ * test_iterative.c - Test CG and L-BFGS solvers
+ * 
+ * Compares both iterative solvers with the direct OLS solution and
+ * checks that they stop on the tolerance well before the limit
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include "../data.h"
+#include "../ols.h"
+#include "../iterative.h"
+#include "../utils.h"
+
+static void check(const char *name, const double *beta, const double *beta_ref,
+                  const iter_stats_t *stats, int d, int max_iter, double tol) {
+    double diff = vector_diff_norm(beta, beta_ref, d);
+    printf("%s: %d iterations, residual %.3e, ||beta - beta_ols|| = %.3e\n",
+           name, stats->iterations, stats->residual, diff);
+    if (stats->converged && stats->residual <= tol && stats->iterations < max_iter) {
+        printf("✓ TEST PASSED: %s converged\n", name);
+    } else {
+        printf("✗ TEST FAILED: %s did not converge\n", name);
+    }
+    if (diff < 1e-6) {
+        printf("✓ TEST PASSED: %s matches OLS\n", name);
+    } else {
+        printf("✗ TEST FAILED: %s differs from OLS (%.6e)\n", name, diff);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    MPI_Init(&argc, &argv);
+    
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    
+    // Test parameters
+    int n = 2000;
+    int d = 20;
+    int max_iter = 500;
+    double tol = 1e-10;
+    unsigned int seed = 42;
+    
+    int local_n, start_row;
+    get_row_partition(n, rank, size, &local_n, &start_row);
+    double *local_X = (double *)malloc((size_t)local_n * d * sizeof(double));
+    double *local_y = (double *)malloc(local_n * sizeof(double));
+    generate_synthetic_data_local(local_X, local_y, NULL, d, start_row, local_n, seed);
+    
+    double *beta_cg = (double *)malloc(d * sizeof(double));
+    double *beta_lbfgs = (double *)malloc(d * sizeof(double));
+    iter_stats_t cg_stats, lbfgs_stats;
+    
+    if (rank == 0) {
+        printf("=== Testing CG and L-BFGS ===\n");
+        printf("Problem size: n=%d, d=%d, tol=%.0e\n", n, d, tol);
+        printf("Number of processes: %d\n\n", size);
+    }
+    
+    cg_parallel_local(local_X, local_y, beta_cg, local_n, d, max_iter, tol,
+                      &cg_stats, MPI_COMM_WORLD);
+    lbfgs_parallel_local(local_X, local_y, beta_lbfgs, local_n, d, max_iter, tol,
+                         LBFGS_DEFAULT_MEMORY, &lbfgs_stats, MPI_COMM_WORLD);
+    
+    if (rank == 0) {
+        // Direct solution on the full dataset
+        double *X = (double *)malloc((size_t)n * d * sizeof(double));
+        double *y = (double *)malloc(n * sizeof(double));
+        double *beta_ols = (double *)malloc(d * sizeof(double));
+        generate_synthetic_data_local(X, y, NULL, d, 0, n, seed);
+        ols_serial(X, y, beta_ols, n, d);
+        
+        check("CG", beta_cg, beta_ols, &cg_stats, d, max_iter, tol);
+        check("L-BFGS", beta_lbfgs, beta_ols, &lbfgs_stats, d, max_iter, tol);
+        
+        free(X);
+        free(y);
+        free(beta_ols);
+    }
+    
+    free(local_X);
+    free(local_y);
+    free(beta_cg);
+    free(beta_lbfgs);
+    
+    MPI_Finalize();
+    return 0;
+}
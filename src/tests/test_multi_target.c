@@ -0,0 +1,148 @@
+/*
+ * test_multi_target.c - Test multi-target OLS and GD
+ * 
+ * Checks the X^T * Y kernel against a naive product and every column
+ * of the multi-target solutions against a single-target fit
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <mpi.h>
+#include "../data.h"
+#include "../ols.h"
+#include "../gd.h"
+#include "../kernels.h"
+#include "../utils.h"
+
+// Largest |B[:, t] - beta| over the rows
+static double column_diff(const double *B, const double *beta, int d, int k, int t) {
+    double max_diff = 0.0;
+    for (int j = 0; j < d; j++) {
+        double diff = fabs(B[(size_t)j * k + t] - beta[j]);
+        if (diff > max_diff) max_diff = diff;
+    }
+    return max_diff;
+}
+
+static void report(const char *name, double diff, double tol) {
+    printf("%s: max diff %.3e\n", name, diff);
+    if (diff < tol) {
+        printf("✓ TEST PASSED: %s\n", name);
+    } else {
+        printf("✗ TEST FAILED: %s\n", name);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    MPI_Init(&argc, &argv);
+    
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    
+    // Test parameters (d and k not multiples of the kernel tiles)
+    int n = 2000;
+    int d = 13;
+    int k = 11;
+    int iterations = 300;
+    double learning_rate = 0.1;
+    unsigned int seed = 42;
+    
+    if (rank == 0) {
+        printf("=== Testing Multi-Target Regression ===\n");
+        printf("Problem size: n=%d, d=%d, k=%d\n", n, d, k);
+        printf("Number of processes: %d\n\n", size);
+    }
+    
+    int local_n, start_row;
+    get_row_partition(n, rank, size, &local_n, &start_row);
+    double *local_X = (double *)malloc((size_t)local_n * d * sizeof(double));
+    double *local_Y = (double *)malloc((size_t)local_n * k * sizeof(double));
+    generate_synthetic_targets_local(local_X, local_Y, NULL, d, k, start_row, local_n, seed);
+    
+    double *B_ols = (double *)malloc((size_t)d * k * sizeof(double));
+    double *B_data = (double *)malloc((size_t)d * k * sizeof(double));
+    double *B_gram = (double *)malloc((size_t)d * k * sizeof(double));
+    ols_parallel_local_multi(local_X, local_Y, B_ols, local_n, d, k, NULL, MPI_COMM_WORLD);
+    gd_set_mode(GD_MODE_DATA);
+    gd_parallel_local_multi(local_X, local_Y, B_data, n, local_n, d, k, iterations,
+                            learning_rate, MPI_COMM_WORLD);
+    gd_set_mode(GD_MODE_GRAM);
+    gd_parallel_local_multi(local_X, local_Y, B_gram, n, local_n, d, k, iterations,
+                            learning_rate, MPI_COMM_WORLD);
+    
+    if (rank == 0) {
+        double *X = (double *)malloc((size_t)n * d * sizeof(double));
+        double *Y = (double *)malloc((size_t)n * k * sizeof(double));
+        double *y = (double *)malloc(n * sizeof(double));
+        double *y0 = (double *)malloc(n * sizeof(double));
+        double *beta = (double *)malloc(d * sizeof(double));
+        generate_synthetic_targets_local(X, Y, NULL, d, k, 0, n, seed);
+        
+        // Target 0 is the single-target dataset
+        double *X0 = (double *)malloc((size_t)n * d * sizeof(double));
+        generate_synthetic_data_local(X0, y0, NULL, d, 0, n, seed);
+        double data_diff = vector_diff_norm(X, X0, n * d);
+        for (int i = 0; i < n; i++) {
+            data_diff += fabs(Y[(size_t)i * k] - y0[i]);
+        }
+        report("Target 0 reproduces the single-target data", data_diff, 1e-15);
+        
+        // Kernel against a naive X^T * Y
+        double *C = (double *)calloc((size_t)d * k, sizeof(double));
+        gemm_tn(X, Y, n, d, k, C);
+        double gemm_diff = 0.0;
+        for (int j = 0; j < d; j++) {
+            for (int t = 0; t < k; t++) {
+                double ref = 0.0;
+                for (int i = 0; i < n; i++) {
+                    ref += X[(size_t)i * d + j] * Y[(size_t)i * k + t];
+                }
+                double diff = fabs(C[(size_t)j * k + t] - ref) / (fabs(ref) + 1.0);
+                if (diff > gemm_diff) gemm_diff = diff;
+            }
+        }
+        report("gemm_tn matches naive X^T * Y", gemm_diff, 1e-12);
+        
+        // Every column against a single-target fit of that column
+        double ols_diff = 0.0;
+        double gd_diff = 0.0;
+        double gram_diff = 0.0;
+        for (int t = 0; t < k; t++) {
+            for (int i = 0; i < n; i++) {
+                y[i] = Y[(size_t)i * k + t];
+            }
+            ols_serial(X, y, beta, n, d);
+            double diff = column_diff(B_ols, beta, d, k, t);
+            if (diff > ols_diff) ols_diff = diff;
+            
+            gd_set_mode(GD_MODE_DATA);
+            gd_serial(X, y, beta, n, d, iterations, learning_rate);
+            diff = column_diff(B_data, beta, d, k, t);
+            if (diff > gd_diff) gd_diff = diff;
+            diff = column_diff(B_gram, beta, d, k, t);
+            if (diff > gram_diff) gram_diff = diff;
+        }
+        report("Multi-target OLS matches per-target OLS", ols_diff, 1e-10);
+        report("Multi-target GD matches per-target GD", gd_diff, 1e-9);
+        report("Multi-target Gram GD matches per-target GD", gram_diff, 1e-9);
+        
+        free(X);
+        free(Y);
+        free(y);
+        free(y0);
+        free(X0);
+        free(beta);
+        free(C);
+    }
+    
+    free(local_X);
+    free(local_Y);
+    free(B_ols);
+    free(B_data);
+    free(B_gram);
+    
+    MPI_Finalize();
+    return 0;
+}
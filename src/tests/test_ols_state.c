@@ -0,0 +1,122 @@
+/*
+ * test_ols_state.c - Test incremental OLS with a persistent model state
+ * 
+ * Fits a dataset in two batches through a state file and compares the
+ * result with a single fit on all rows
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include "../data.h"
+#include "../ols.h"
+#include "../ols_state.h"
+#include "../utils.h"
+
+// Add global rows [first, first + count) to the state file
+static void add_batch(const char *path, int first, int count, int d, unsigned int seed) {
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    
+    int local_n, start_row;
+    get_row_partition(count, rank, size, &local_n, &start_row);
+    double *local_X = (double *)malloc((size_t)local_n * d * sizeof(double));
+    double *local_y = (double *)malloc(local_n * sizeof(double));
+    generate_synthetic_data_local(local_X, local_y, NULL, d, first + start_row, local_n, seed);
+    
+    ols_state_t state;
+    ols_state_load(path, d, &state, MPI_COMM_WORLD);
+    ols_state_update(&state, local_X, local_y, local_n, MPI_COMM_WORLD);
+    ols_state_save(path, &state, MPI_COMM_WORLD);
+    ols_state_free(&state);
+    
+    free(local_X);
+    free(local_y);
+}
+
+int main(int argc, char *argv[]) {
+    MPI_Init(&argc, &argv);
+    
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    
+    // Test parameters
+    int n = 3000;
+    int n_first = 1700;
+    int d = 15;
+    unsigned int seed = 42;
+    const char *path = "test_ols_state.bin";
+    
+    if (rank == 0) {
+        printf("=== Testing Incremental OLS ===\n");
+        printf("Problem size: n=%d (%d + %d), d=%d\n", n, n_first, n - n_first, d);
+        printf("Number of processes: %d\n\n", size);
+        remove(path);
+    }
+    
+    // A missing file starts an empty model
+    ols_state_t state;
+    int missing = ols_state_load(path, d, &state, MPI_COMM_WORLD);
+    ols_state_free(&state);
+    
+    add_batch(path, 0, n_first, d, seed);
+    add_batch(path, n_first, n - n_first, d, seed);
+    
+    // A state with a different d must be rejected
+    int mismatch = ols_state_load(path, d + 1, &state, MPI_COMM_WORLD);
+    ols_state_free(&state);
+    
+    int loaded = ols_state_load(path, d, &state, MPI_COMM_WORLD);
+    
+    if (rank == 0) {
+        double *beta_inc = (double *)malloc(d * sizeof(double));
+        double *beta_full = (double *)malloc(d * sizeof(double));
+        double *X = (double *)malloc((size_t)n * d * sizeof(double));
+        double *y = (double *)malloc(n * sizeof(double));
+        generate_synthetic_data_local(X, y, NULL, d, 0, n, seed);
+        ols_serial(X, y, beta_full, n, d);
+        
+        double yty = 0.0;
+        for (int i = 0; i < n; i++) {
+            yty += y[i] * y[i];
+        }
+        
+        if (missing == 1 && mismatch == -1 && loaded == 0) {
+            printf("✓ TEST PASSED: State file created, reloaded and validated\n");
+        } else {
+            printf("✗ TEST FAILED: Load status missing=%d mismatch=%d loaded=%d\n",
+                   missing, mismatch, loaded);
+        }
+        
+        if (state.n == n && state.yty > 0.0 && (state.yty - yty) / yty < 1e-12 &&
+            (yty - state.yty) / yty < 1e-12) {
+            printf("✓ TEST PASSED: State holds all %lld rows\n", state.n);
+        } else {
+            printf("✗ TEST FAILED: State has n=%lld, yty=%.6e (expected %d, %.6e)\n",
+                   state.n, state.yty, n, yty);
+        }
+        
+        double diff = 1.0;
+        if (ols_state_solve(&state, beta_inc) == 0) {
+            diff = vector_diff_norm(beta_inc, beta_full, d);
+        }
+        printf("||beta_incremental - beta_full|| = %.6e\n", diff);
+        if (diff < 1e-10) {
+            printf("✓ TEST PASSED: Incremental fit matches full refit\n");
+        } else {
+            printf("✗ TEST FAILED: Incremental fit differs from full refit\n");
+        }
+        
+        remove(path);
+        free(beta_inc);
+        free(beta_full);
+        free(X);
+        free(y);
+    }
+    
+    ols_state_free(&state);
+    MPI_Finalize();
+    return 0;
+}
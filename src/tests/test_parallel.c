@@ -6,6 +6,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <math.h>
 #include <mpi.h>
 #include "../data.h"
 #include "../ols.h"
@@ -56,6 +57,29 @@ int main(int argc, char *argv[]) {
     
     ols_parallel(X, y, beta_parallel, n, d, MPI_COMM_WORLD);
     
+    // Same problem with the distributed Cholesky solve
+    double *beta_dist = (double *)malloc(d * sizeof(double));
+    ols_set_solver(OLS_SOLVER_DISTRIBUTED);
+    ols_parallel(X, y, beta_dist, n, d, MPI_COMM_WORLD);
+    ols_set_solver(OLS_SOLVER_ROOT);
+    
+    // A non-finite entry leaves rank 0 with no SPD fallback: the
+    // failure must reach every rank
+    double *beta_bad = (double *)malloc(d * sizeof(double));
+    double saved = 0.0;
+    if (rank == 0) {
+        saved = X[0];
+        X[0] = NAN;
+    }
+    int bad_status = ols_parallel(X, y, beta_bad, n, d, MPI_COMM_WORLD);
+    if (rank == 0) {
+        X[0] = saved;
+    }
+    int all_failed;
+    MPI_Allreduce(&bad_status, &all_failed, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    int any_ok;
+    MPI_Allreduce(&bad_status, &any_ok, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    
     // Compare results (only rank 0)
     if (rank == 0) {
         printf("\nResults comparison:\n");
@@ -78,6 +102,21 @@ int main(int argc, char *argv[]) {
             printf("✗ TEST FAILED: Results differ significantly (%.6e)\n", diff);
         }
         
+        double diff_dist = vector_diff_norm(beta_parallel, beta_dist, d);
+        printf("\nDifference ||beta_parallel - beta_distributed|| = %.10e\n", diff_dist);
+        if (diff_dist < 1e-10) {
+            printf("✓ TEST PASSED: Distributed solve matches rank 0 solve\n");
+        } else {
+            printf("✗ TEST FAILED: Distributed solve differs (%.6e)\n", diff_dist);
+        }
+        
+        if (all_failed == -1 && any_ok == -1) {
+            printf("✓ TEST PASSED: Failed solve is reported on every rank\n");
+        } else {
+            printf("✗ TEST FAILED: Failed solve went unreported (status %d..%d)\n",
+                   any_ok, all_failed);
+        }
+        
         // Clean up
         free(X);
         free(y);
@@ -86,6 +125,8 @@ int main(int argc, char *argv[]) {
     }
     
     free(beta_parallel);
+    free(beta_dist);
+    free(beta_bad);
     
     MPI_Finalize();
     return 0;
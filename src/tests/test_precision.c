@@ -0,0 +1,127 @@
+/*
+ * test_precision.c - Mixed-precision (float32 X) accuracy report
+ * 
+ * Checks that the float32 kernels match the float64 kernels on the
+ * widened data, and reports how far OLS and GD betas computed from
+ * float32 X move from the float64 path
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <mpi.h>
+#include "../data.h"
+#include "../ols.h"
+#include "../gd.h"
+#include "../kernels.h"
+#include "../utils.h"
+
+static double norm(const double *v, int n) {
+    double sum = 0.0;
+    for (int i = 0; i < n; i++) sum += v[i] * v[i];
+    return sqrt(sum);
+}
+
+static void report(const char *name, const double *beta64, const double *beta32,
+                   const double *beta_true, int d, double limit) {
+    double rel = vector_diff_norm(beta64, beta32, d) / norm(beta64, d);
+    printf("%-4s  ||b32 - b64||/||b64|| = %.3e   error vs beta_true: "
+           "f64 %.6e, f32 %.6e\n", name, rel,
+           vector_diff_norm(beta_true, beta64, d),
+           vector_diff_norm(beta_true, beta32, d));
+    if (rel < limit) {
+        printf("✓ TEST PASSED: %s float32 storage within %.0e of float64\n", name, limit);
+    } else {
+        printf("✗ TEST FAILED: %s float32 storage differs by %.3e\n", name, rel);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    MPI_Init(&argc, &argv);
+    
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    
+    // Test parameters
+    int n = 5000;
+    int d = 37;  // not a multiple of the vector width
+    int iterations = 300;
+    double learning_rate = 0.1;
+    unsigned int seed = 42;
+    
+    int local_n, start_row;
+    get_row_partition(n, rank, size, &local_n, &start_row);
+    double *X = (double *)malloc((size_t)local_n * d * sizeof(double));
+    double *y = (double *)malloc(local_n * sizeof(double));
+    float *X32 = (float *)malloc((size_t)local_n * d * sizeof(float));
+    double *beta_true = (double *)malloc(d * sizeof(double));
+    generate_synthetic_data_local(X, y, beta_true, d, start_row, local_n, seed);
+    convert_f64_to_f32(X, X32, (size_t)local_n * d);
+    
+    if (rank == 0) {
+        printf("=== Testing Mixed Precision (float32 X) ===\n");
+        printf("Problem size: n=%d, d=%d, kernels: %s\n", n, d, kernel_isa_name());
+        printf("Number of processes: %d\n\n", size);
+        
+        // Kernels: float32 input must give exactly the float64 result
+        // on the widened rows
+        double *Xw = (double *)malloc((size_t)local_n * d * sizeof(double));
+        convert_f32_to_f64(X32, Xw, (size_t)local_n * d);
+        double *C64 = (double *)calloc((size_t)d * d, sizeof(double));
+        double *C32 = (double *)calloc((size_t)d * d, sizeof(double));
+        double *widen = (double *)malloc(syrk_lower_f32_scratch(d) * sizeof(double));
+        syrk_lower(Xw, local_n, d, C64);
+        syrk_lower_f32(X32, local_n, d, C32, widen);
+        free(widen);
+        double *g64 = (double *)calloc(d, sizeof(double));
+        double *g32 = (double *)calloc(d, sizeof(double));
+        widen = (double *)malloc(gd_gradient_fused_f32_scratch(d) * sizeof(double));
+        gd_gradient_fused(Xw, y, beta_true, local_n, d, g64);
+        gd_gradient_fused_f32(X32, y, beta_true, local_n, d, g32, widen);
+        free(widen);
+        if (memcmp(C64, C32, (size_t)d * d * sizeof(double)) == 0 &&
+            memcmp(g64, g32, d * sizeof(double)) == 0) {
+            printf("✓ TEST PASSED: float32 kernels match float64 on widened rows\n");
+        } else {
+            printf("✗ TEST FAILED: float32 kernels differ from float64\n");
+        }
+        free(Xw);
+        free(C64);
+        free(C32);
+        free(g64);
+        free(g32);
+        printf("\n");
+    }
+    
+    double *beta64 = (double *)malloc(d * sizeof(double));
+    double *beta32 = (double *)malloc(d * sizeof(double));
+    
+    // OLS: float32 rounding of X (relative 6e-8) perturbs beta by about
+    // cond(X) times that
+    ols_parallel_local(X, y, beta64, local_n, d, MPI_COMM_WORLD);
+    ols_parallel_local_f32(X32, y, beta32, local_n, d, NULL, MPI_COMM_WORLD);
+    if (rank == 0) report("OLS", beta64, beta32, beta_true, d, 1e-5);
+    
+    // GD, both iteration spaces
+    gd_set_mode(GD_MODE_DATA);
+    gd_parallel_local(X, y, beta64, n, local_n, d, iterations, learning_rate, MPI_COMM_WORLD);
+    gd_parallel_local_f32(X32, y, beta32, n, local_n, d, iterations, learning_rate, MPI_COMM_WORLD);
+    if (rank == 0) report("GD", beta64, beta32, beta_true, d, 1e-5);
+    
+    gd_set_mode(GD_MODE_GRAM);
+    gd_parallel_local(X, y, beta64, n, local_n, d, iterations, learning_rate, MPI_COMM_WORLD);
+    gd_parallel_local_f32(X32, y, beta32, n, local_n, d, iterations, learning_rate, MPI_COMM_WORLD);
+    if (rank == 0) report("GD-G", beta64, beta32, beta_true, d, 1e-5);
+    
+    free(X);
+    free(y);
+    free(X32);
+    free(beta_true);
+    free(beta64);
+    free(beta32);
+    
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,145 @@
+/*
+ * test_predict.c - Test distributed batch prediction and scoring
+ * 
+ * Round-trips a coefficient file, predicts a generated dataset chunk by
+ * chunk on every rank and compares the prediction file and the scores
+ * with a serial computation
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <mpi.h>
+#include "../data.h"
+#include "../ols.h"
+#include "../predict.h"
+#include "../stream.h"
+#include "../utils.h"
+
+int main(int argc, char *argv[]) {
+    MPI_Init(&argc, &argv);
+    
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    
+    // Test parameters
+    int n = 5000;
+    int d = 12;
+    int chunk_rows = 700;
+    unsigned int seed = 42;
+    const char *beta_path = "test_predict_beta.bin";
+    const char *pred_path = "test_predict_pred.bin";
+    
+    if (rank == 0) {
+        printf("=== Testing Batch Prediction ===\n");
+        printf("Problem size: n=%d, d=%d, chunk=%d\n", n, d, chunk_rows);
+        printf("Number of processes: %d\n\n", size);
+    }
+    
+    // Fit on rank 0 and write the coefficients
+    double *beta = (double *)calloc(d, sizeof(double));
+    double *X = NULL;
+    double *y = NULL;
+    if (rank == 0) {
+        X = (double *)malloc((size_t)n * d * sizeof(double));
+        y = (double *)malloc(n * sizeof(double));
+        generate_synthetic_data_local(X, y, NULL, d, 0, n, seed);
+        ols_serial(X, y, beta, n, d);
+    }
+    int written = beta_write(beta_path, beta, d, MPI_COMM_WORLD);
+    
+    // Read back on every rank; a different d must be rejected
+    double *beta_read_back = (double *)malloc((d + 1) * sizeof(double));
+    int mismatch = beta_read(beta_path, beta_read_back, d + 1, MPI_COMM_WORLD);
+    int loaded = beta_read(beta_path, beta_read_back, d, MPI_COMM_WORLD);
+    
+    // Predict this rank's rows
+    int local_n, start_row;
+    get_row_partition(n, rank, size, &local_n, &start_row);
+    row_stream_t stream;
+    row_stream_open_generator(&stream, d, seed, start_row, local_n, chunk_rows);
+    score_t score;
+    int status = predict_stream(&stream, beta_read_back, pred_path, n, &score, MPI_COMM_WORLD);
+    row_stream_close(&stream);
+    
+    if (rank == 0) {
+        if (written == 0 && mismatch == -1 && loaded == 0 &&
+            vector_diff_norm(beta_read_back, beta, d) == 0.0) {
+            printf("✓ TEST PASSED: Coefficient file round-trips and is validated\n");
+        } else {
+            printf("✗ TEST FAILED: Coefficient file status write=%d mismatch=%d read=%d\n",
+                   written, mismatch, loaded);
+        }
+        
+        // Serial reference
+        double *pred = (double *)malloc(n * sizeof(double));
+        double mean_y = 0.0;
+        for (int i = 0; i < n; i++) {
+            double p = 0.0;
+            for (int j = 0; j < d; j++) {
+                p += X[(size_t)i * d + j] * beta[j];
+            }
+            pred[i] = p;
+            mean_y += y[i];
+        }
+        mean_y /= n;
+        double sst = 0.0;
+        double max_abs = 0.0;
+        for (int i = 0; i < n; i++) {
+            sst += (y[i] - mean_y) * (y[i] - mean_y);
+            if (fabs(y[i] - pred[i]) > max_abs) {
+                max_abs = fabs(y[i] - pred[i]);
+            }
+        }
+        double mse = compute_mse(y, pred, n);
+        double r2 = 1.0 - mse * n / sst;
+        
+        // Compare the prediction file row by row
+        double *file_pred = (double *)malloc(n * sizeof(double));
+        size_t got = 0;
+        FILE *f = fopen(pred_path, "rb");
+        if (f) {
+            got = fread(file_pred, sizeof(double), n, f);
+            if (fgetc(f) != EOF) {
+                got = 0;
+            }
+            fclose(f);
+        }
+        double max_diff = (got == (size_t)n) ? 0.0 : 1.0;
+        for (size_t i = 0; i < got; i++) {
+            if (fabs(file_pred[i] - pred[i]) > max_diff) {
+                max_diff = fabs(file_pred[i] - pred[i]);
+            }
+        }
+        printf("max |pred_file - pred_serial| = %.6e\n", max_diff);
+        if (status == 0 && max_diff < 1e-12) {
+            printf("✓ TEST PASSED: Prediction file matches serial predictions\n");
+        } else {
+            printf("✗ TEST FAILED: Prediction file differs (status=%d, rows=%zu)\n",
+                   status, got);
+        }
+        
+        printf("MSE: %.12e (serial %.12e)\n", score.mse, mse);
+        printf("R^2: %.12f (serial %.12f)\n", score.r2, r2);
+        if (score.n == n && fabs(score.mse - mse) < 1e-10 * mse &&
+            fabs(score.r2 - r2) < 1e-10 &&
+            fabs(score.max_abs_residual - max_abs) < 1e-12) {
+            printf("✓ TEST PASSED: Scores match serial computation\n");
+        } else {
+            printf("✗ TEST FAILED: Scores differ from serial computation\n");
+        }
+        
+        remove(beta_path);
+        remove(pred_path);
+        free(pred);
+        free(file_pred);
+        free(X);
+        free(y);
+    }
+    
+    free(beta);
+    free(beta_read_back);
+    MPI_Finalize();
+    return 0;
+}
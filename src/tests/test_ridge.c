@@ -0,0 +1,175 @@
+/*
+ * test_ridge.c - Test the eigensolver and the ridge path
+ * 
+ * Each point of the path is compared with a direct solve of
+ * (XtX + lambda * I) * beta = Xty and its MSE with compute_mse on the
+ * data
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <mpi.h>
+#include "../data.h"
+#include "../ols.h"
+#include "../ridge.h"
+#include "../linear_solver.h"
+#include "../utils.h"
+
+static void report(const char *name, double err, double tol) {
+    printf("%s: max error %.3e\n", name, err);
+    if (err < tol) {
+        printf("✓ TEST PASSED: %s\n", name);
+    } else {
+        printf("✗ TEST FAILED: %s\n", name);
+    }
+}
+
+/*
+ * Largest entry of |A * V - V * diag(w)| and |V^T * V - I|
+ */
+static double eigen_error(const double *A, const double *w, const double *V, int n) {
+    double err = 0.0;
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            double av = 0.0;
+            double vtv = 0.0;
+            for (int k = 0; k < n; k++) {
+                av += A[i * n + k] * V[k * n + j];
+                vtv += V[k * n + i] * V[k * n + j];
+            }
+            double e1 = fabs(av - V[i * n + j] * w[j]);
+            double e2 = fabs(vtv - (i == j ? 1.0 : 0.0));
+            if (e1 > err) err = e1;
+            if (e2 > err) err = e2;
+        }
+    }
+    return err;
+}
+
+int main(int argc, char *argv[]) {
+    MPI_Init(&argc, &argv);
+    
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    
+    // Test parameters
+    int n = 3000;
+    int d = 25;
+    unsigned int seed = 42;
+    double lambdas[] = {0.0, 0.5, 10.0, 1000.0, 1e6};
+    int num_lambdas = sizeof(lambdas) / sizeof(lambdas[0]);
+    
+    if (rank == 0) {
+        printf("=== Testing Ridge Path ===\n");
+        printf("Problem size: n=%d, d=%d, %d lambdas\n", n, d, num_lambdas);
+        printf("Number of processes: %d\n\n", size);
+    }
+    
+    int local_n, start_row;
+    get_row_partition(n, rank, size, &local_n, &start_row);
+    double *local_X = (double *)malloc((size_t)local_n * d * sizeof(double));
+    double *local_y = (double *)malloc(local_n * sizeof(double));
+    generate_synthetic_data_local(local_X, local_y, NULL, d, start_row, local_n, seed);
+    
+    double *betas = (double *)malloc((size_t)num_lambdas * d * sizeof(double));
+    double *mse = (double *)malloc(num_lambdas * sizeof(double));
+    int status = ridge_path_local(local_X, local_y, local_n, d, lambdas, num_lambdas,
+                                  betas, mse, MPI_COMM_WORLD);
+    
+    if (rank == 0) {
+        double *X = (double *)malloc((size_t)n * d * sizeof(double));
+        double *y = (double *)malloc(n * sizeof(double));
+        double *XtX = (double *)malloc((size_t)d * d * sizeof(double));
+        double *Xty = (double *)malloc(d * sizeof(double));
+        double *A = (double *)malloc((size_t)d * d * sizeof(double));
+        double *b = (double *)malloc(d * sizeof(double));
+        double *beta = (double *)malloc(d * sizeof(double));
+        double *pred = (double *)malloc(n * sizeof(double));
+        double *w = (double *)malloc(d * sizeof(double));
+        double *V = (double *)malloc((size_t)d * d * sizeof(double));
+        generate_synthetic_data_local(X, y, NULL, d, 0, n, seed);
+        ols_normal_equations(X, y, n, d, XtX, Xty);
+        
+        // Eigendecomposition of XtX (scaled to unit diagonal magnitude)
+        for (int i = 0; i < d * d; i++) {
+            A[i] = XtX[i] / n;
+        }
+        symmetric_eigen(A, d, w, V);
+        int sorted = 1;
+        for (int i = 1; i < d; i++) {
+            if (w[i] < w[i - 1]) sorted = 0;
+        }
+        report("Eigendecomposition of XtX", eigen_error(A, w, V, d) + (sorted ? 0.0 : 1.0), 1e-12);
+        
+        // Rank-deficient matrix: two eigenvalues must be zero
+        int m = 6;
+        for (int i = 0; i < m; i++) {
+            for (int j = 0; j < m; j++) {
+                double s = 0.0;
+                for (int k = 0; k < m - 2; k++) {
+                    s += X[k * d + i] * X[k * d + j];
+                }
+                A[i * m + j] = s;
+            }
+        }
+        symmetric_eigen(A, m, w, V);
+        report("Eigendecomposition of a rank-deficient matrix",
+               eigen_error(A, w, V, m) + fabs(w[0]) + fabs(w[1]), 1e-12);
+        
+        // Path against direct solves and data-based MSE
+        double beta_err = 0.0;
+        double mse_err = 0.0;
+        for (int l = 0; l < num_lambdas; l++) {
+            memcpy(A, XtX, (size_t)d * d * sizeof(double));
+            memcpy(b, Xty, d * sizeof(double));
+            for (int j = 0; j < d; j++) {
+                A[j * d + j] += lambdas[l];
+            }
+            solve_spd_system(A, b, beta, d);
+            double norm_sq = 0.0;
+            for (int j = 0; j < d; j++) {
+                norm_sq += beta[j] * beta[j];
+            }
+            double err = vector_diff_norm(beta, betas + (size_t)l * d, d) / (sqrt(norm_sq) + 1.0);
+            if (err > beta_err) beta_err = err;
+            
+            const double *bl = betas + (size_t)l * d;
+            for (int i = 0; i < n; i++) {
+                double p = 0.0;
+                for (int j = 0; j < d; j++) {
+                    p += X[(size_t)i * d + j] * bl[j];
+                }
+                pred[i] = p;
+            }
+            double ref = compute_mse(y, pred, n);
+            err = fabs(mse[l] - ref) / ref;
+            if (err > mse_err) mse_err = err;
+            printf("lambda=%-8g mse=%.6e (data %.6e)\n", lambdas[l], mse[l], ref);
+        }
+        report("Ridge path succeeded", status == 0 ? 0.0 : 1.0, 0.5);
+        report("Ridge coefficients match direct solves", beta_err, 1e-9);
+        report("Ridge MSE matches compute_mse", mse_err, 1e-9);
+        
+        free(X);
+        free(y);
+        free(XtX);
+        free(Xty);
+        free(A);
+        free(b);
+        free(beta);
+        free(pred);
+        free(w);
+        free(V);
+    }
+    
+    free(local_X);
+    free(local_y);
+    free(betas);
+    free(mse);
+    
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,111 @@
+/*
+ * test_sgd.c - Test mini-batch local SGD
+ * 
+ * Checks that synchronous and local SGD approach the OLS solution,
+ * that every rank ends with the same model, and that a run is
+ * reproducible for a fixed seed
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <mpi.h>
+#include "../data.h"
+#include "../ols.h"
+#include "../sgd.h"
+#include "../utils.h"
+
+int main(int argc, char *argv[]) {
+    MPI_Init(&argc, &argv);
+    
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    
+    // Test parameters
+    int n = 20000;
+    int d = 10;
+    unsigned int seed = 42;
+    
+    int local_n, start_row;
+    get_row_partition(n, rank, size, &local_n, &start_row);
+    double *local_X = (double *)malloc((size_t)local_n * d * sizeof(double));
+    double *local_y = (double *)malloc(local_n * sizeof(double));
+    generate_synthetic_data_local(local_X, local_y, NULL, d, start_row, local_n, seed);
+    
+    // Reference: direct solution on the full dataset
+    double *beta_ols = (double *)malloc(d * sizeof(double));
+    double *X = (double *)malloc((size_t)n * d * sizeof(double));
+    double *y = (double *)malloc(n * sizeof(double));
+    generate_synthetic_data_local(X, y, NULL, d, 0, n, seed);
+    ols_serial(X, y, beta_ols, n, d);
+    double ols_norm = 0.0;
+    for (int j = 0; j < d; j++) ols_norm += beta_ols[j] * beta_ols[j];
+    ols_norm = sqrt(ols_norm);
+    free(X);
+    free(y);
+    
+    if (rank == 0) {
+        printf("=== Testing Local SGD ===\n");
+        printf("Problem size: n=%d, d=%d\n", n, d);
+        printf("Number of processes: %d\n\n", size);
+    }
+    
+    sgd_config_t config;
+    sgd_default_config(&config);
+    config.batch_size = 32;
+    config.steps = 400;
+    config.learning_rate = 0.05;
+    config.decay = 0.01;
+    
+    double *beta = (double *)malloc(d * sizeof(double));
+    double *beta_again = (double *)malloc(d * sizeof(double));
+    double *beta_max = (double *)malloc(d * sizeof(double));
+    double *beta_min = (double *)malloc(d * sizeof(double));
+    int local_steps[2] = {1, 8};
+    
+    for (int t = 0; t < 2; t++) {
+        config.local_steps = local_steps[t];
+        sgd_parallel_local(local_X, local_y, beta, n, local_n, start_row, d,
+                           &config, MPI_COMM_WORLD);
+        sgd_parallel_local(local_X, local_y, beta_again, n, local_n, start_row, d,
+                           &config, MPI_COMM_WORLD);
+        MPI_Allreduce(beta, beta_max, d, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+        MPI_Allreduce(beta, beta_min, d, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+        
+        if (rank == 0) {
+            // Much less than one epoch: 400 steps x 32 rows x p ranks
+            double rel = vector_diff_norm(beta, beta_ols, d) / ols_norm;
+            printf("K=%d: ||beta - beta_ols|| / ||beta_ols|| = %.3e\n",
+                   local_steps[t], rel);
+            if (rel < 1e-2) {
+                printf("✓ TEST PASSED: SGD (K=%d) approaches the OLS solution\n", local_steps[t]);
+            } else {
+                printf("✗ TEST FAILED: SGD (K=%d) is too far from OLS\n", local_steps[t]);
+            }
+            
+            if (vector_diff_norm(beta_max, beta_min, d) == 0.0) {
+                printf("✓ TEST PASSED: All ranks hold the same model\n");
+            } else {
+                printf("✗ TEST FAILED: Ranks disagree on the model\n");
+            }
+            
+            if (vector_diff_norm(beta, beta_again, d) == 0.0) {
+                printf("✓ TEST PASSED: Repeated run is bit-identical\n");
+            } else {
+                printf("✗ TEST FAILED: Repeated run differs\n");
+            }
+        }
+    }
+    
+    free(local_X);
+    free(local_y);
+    free(beta_ols);
+    free(beta);
+    free(beta_again);
+    free(beta_max);
+    free(beta_min);
+    
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,241 @@
+/*
+ * test_sparse.c - Test CSR feature matrices in OLS, GD and CG
+ * 
+ * Compares the sparse solvers on nonzero-balanced row blocks with the
+ * dense serial solvers on the densified matrix, and checks the
+ * partition and the CSR file round trip
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+#include "../data.h"
+#include "../dataset.h"
+#include "../sparse.h"
+#include "../ols.h"
+#include "../gd.h"
+#include "../iterative.h"
+#include "../utils.h"
+
+int main(int argc, char *argv[]) {
+    MPI_Init(&argc, &argv);
+    
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    
+    // Test parameters
+    int n = 4000;
+    int d = 40;
+    double density = 0.05;
+    int gd_iterations = 200;
+    double gd_lr = 10.0;
+    unsigned int seed = 42;
+    const char *path = "test_sparse.bin";
+    
+    if (rank == 0) {
+        printf("=== Testing Sparse CSR Solvers ===\n");
+        printf("Problem size: n=%d, d=%d, density=%g\n", n, d, density);
+        printf("Number of processes: %d\n\n", size);
+    }
+    
+    // Rank 0 generates all rows; the densified copy feeds the serial solvers
+    csr_matrix_t X = {0};
+    double *y = NULL;
+    double *X_dense = NULL;
+    double *beta_ols = (double *)malloc(d * sizeof(double));
+    double *beta_gd = (double *)malloc(d * sizeof(double));
+    if (rank == 0) {
+        y = (double *)malloc(n * sizeof(double));
+        generate_synthetic_sparse_local(&X, y, NULL, d, density, 0, n, seed);
+        X_dense = (double *)calloc((size_t)n * d, sizeof(double));
+        for (int i = 0; i < n; i++) {
+            for (int p = X.row_ptr[i]; p < X.row_ptr[i + 1]; p++) {
+                X_dense[(size_t)i * d + X.col_idx[p]] = X.val[p];
+            }
+        }
+        ols_serial(X_dense, y, beta_ols, n, d);
+        gd_set_mode(GD_MODE_DATA);
+        gd_serial(X_dense, y, beta_gd, n, d, gd_iterations, gd_lr);
+        
+        // Nonzeros take the dense generator's values
+        double *X_full = (double *)malloc((size_t)n * d * sizeof(double));
+        double *y_full = (double *)malloc(n * sizeof(double));
+        generate_synthetic_data_local(X_full, y_full, NULL, d, 0, n, seed);
+        int same = 1;
+        for (size_t i = 0; i < (size_t)n * d; i++) {
+            same = same && (X_dense[i] == 0.0 || X_dense[i] == X_full[i]);
+        }
+        printf("Nonzeros: %d (%.3f%%)\n", csr_nnz(&X), 100.0 * csr_nnz(&X) / ((double)n * d));
+        if (same && csr_nnz(&X) > 0) {
+            printf("✓ TEST PASSED: Sparse rows are masked dense rows\n");
+        } else {
+            printf("✗ TEST FAILED: Sparse generator disagrees with the dense one\n");
+        }
+        free(X_full);
+        free(y_full);
+        
+        // Skewed rows: the first eighth are dense, the rest hold one nonzero
+        int rows = 800;
+        int *row_ptr = (int *)malloc((rows + 1) * sizeof(int));
+        row_ptr[0] = 0;
+        for (int i = 0; i < rows; i++) {
+            row_ptr[i + 1] = row_ptr[i] + (i < rows / 8 ? d : 1);
+        }
+        int parts = 4;
+        double ideal = (double)(row_ptr[rows] + rows) / parts;
+        int covered = 0;
+        int balanced = 1;
+        for (int p = 0; p < parts; p++) {
+            int part_n, part_start;
+            csr_row_partition(row_ptr, rows, p, parts, &part_n, &part_start);
+            double work = row_ptr[part_start + part_n] - row_ptr[part_start] + part_n;
+            balanced = balanced && part_start == covered &&
+                       work <= ideal + d + 1 && work >= ideal - d - 1;
+            covered += part_n;
+        }
+        if (balanced && covered == rows) {
+            printf("✓ TEST PASSED: Partition balances nonzeros on skewed rows\n");
+        } else {
+            printf("✗ TEST FAILED: Partition is unbalanced or does not cover the rows\n");
+        }
+        free(row_ptr);
+        
+        // Same skew with int64 offsets past INT32_MAX (file-wide counts)
+        long long big = 1LL << 26;
+        int64_t *offsets = (int64_t *)malloc((rows + 1) * sizeof(int64_t));
+        offsets[0] = 0;
+        for (int i = 0; i < rows; i++) {
+            offsets[i + 1] = offsets[i] + (i < rows / 8 ? big : 1);
+        }
+        ideal = (double)(offsets[rows] + rows) / parts;
+        covered = 0;
+        balanced = offsets[rows] > INT32_MAX;
+        for (int p = 0; p < parts; p++) {
+            int part_n, part_start;
+            csr_row_partition64(offsets, rows, p, parts, &part_n, &part_start);
+            double work = (double)(offsets[part_start + part_n] - offsets[part_start]) + part_n;
+            balanced = balanced && part_start == covered &&
+                       work <= ideal + big + 1 && work >= ideal - big - 1;
+            covered += part_n;
+        }
+        if (balanced && covered == rows) {
+            printf("✓ TEST PASSED: Partition balances int64 offsets past INT32_MAX\n");
+        } else {
+            printf("✗ TEST FAILED: int64 partition is unbalanced or does not cover the rows\n");
+        }
+        free(offsets);
+    }
+    
+    // Scatter in nonzero-balanced blocks
+    csr_matrix_t local_X;
+    double *local_y = NULL;
+    int start_row = 0;
+    int scatter_err = dataset_scatter_csr(&X, y, d, &local_X, &local_y, &start_row,
+                                          MPI_COMM_WORLD);
+    
+    // Every rank's work (nonzeros + rows) is within one row of the ideal
+    int work = csr_nnz(&local_X) + local_X.rows;
+    int *works = (rank == 0) ? (int *)malloc(size * sizeof(int)) : NULL;
+    MPI_Gather(&work, 1, MPI_INT, works, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    
+    // Sparse solvers
+    double *beta = (double *)malloc(d * sizeof(double));
+    ols_parallel_local_csr(&local_X, local_y, beta, NULL, MPI_COMM_WORLD);
+    double *beta_sparse_gd = (double *)malloc(d * sizeof(double));
+    gd_set_mode(GD_MODE_DATA);
+    gd_parallel_local_csr(&local_X, local_y, beta_sparse_gd, n, gd_iterations, gd_lr,
+                          MPI_COMM_WORLD);
+    double *beta_cg = (double *)malloc(d * sizeof(double));
+    iter_stats_t stats;
+    cg_parallel_local_csr(&local_X, local_y, beta_cg, 200, 1e-12, &stats, MPI_COMM_WORLD);
+    
+    // File round trip: the reader picks the same blocks as the scatter
+    int write_err = dataset_write_csr_local(path, n, d, &local_X, local_y, start_row,
+                                            MPI_COMM_WORLD);
+    dataset_header_t header;
+    int header_err = dataset_read_header(path, &header, MPI_COMM_WORLD);
+    csr_matrix_t read_X;
+    double *read_y = NULL;
+    int read_start = -1;
+    int read_err = header_err ? -1 :
+                   dataset_read_csr_local(path, &header, &read_X, &read_y, &read_start,
+                                          MPI_COMM_WORLD);
+    int same = (read_err == 0 && read_start == start_row && read_X.rows == local_X.rows &&
+                csr_nnz(&read_X) == csr_nnz(&local_X));
+    if (same) {
+        int nnz = csr_nnz(&local_X);
+        same = memcmp(read_X.row_ptr, local_X.row_ptr, (local_X.rows + 1) * sizeof(int)) == 0 &&
+               memcmp(read_X.col_idx, local_X.col_idx, nnz * sizeof(int)) == 0 &&
+               memcmp(read_X.val, local_X.val, nnz * sizeof(double)) == 0 &&
+               memcmp(read_y, local_y, local_X.rows * sizeof(double)) == 0;
+    }
+    int all_same;
+    MPI_Allreduce(&same, &all_same, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+    
+    if (rank == 0) {
+        int max_row = d + 1;
+        double ideal = (double)(csr_nnz(&X) + n) / size;
+        int balanced = 1;
+        for (int p = 0; p < size; p++) {
+            balanced = balanced && works[p] <= ideal + max_row && works[p] >= ideal - max_row;
+        }
+        if (scatter_err == 0 && balanced) {
+            printf("✓ TEST PASSED: Scatter gives nonzero-balanced blocks\n");
+        } else {
+            printf("✗ TEST FAILED: Scatter blocks are unbalanced\n");
+        }
+        
+        double diff = vector_diff_norm(beta, beta_ols, d);
+        printf("||beta_csr - beta_dense|| (OLS) = %.6e\n", diff);
+        if (diff < 1e-10) {
+            printf("✓ TEST PASSED: Sparse OLS matches dense OLS\n");
+        } else {
+            printf("✗ TEST FAILED: Sparse OLS differs from dense OLS\n");
+        }
+        
+        diff = vector_diff_norm(beta_sparse_gd, beta_gd, d);
+        printf("||beta_csr - beta_dense|| (GD) = %.6e\n", diff);
+        if (diff < 1e-9) {
+            printf("✓ TEST PASSED: Sparse GD matches dense GD\n");
+        } else {
+            printf("✗ TEST FAILED: Sparse GD differs from dense GD\n");
+        }
+        
+        diff = vector_diff_norm(beta_cg, beta_ols, d);
+        printf("||beta_csr_cg - beta_ols|| = %.6e (%d iterations)\n", diff, stats.iterations);
+        if (stats.converged && diff < 1e-8) {
+            printf("✓ TEST PASSED: Sparse CG converges to the OLS solution\n");
+        } else {
+            printf("✗ TEST FAILED: Sparse CG did not reach the OLS solution\n");
+        }
+        
+        if (write_err == 0 && header.layout == DATASET_LAYOUT_CSR &&
+            header.nnz == csr_nnz(&X) && all_same) {
+            printf("✓ TEST PASSED: CSR file round-trips into the same blocks\n");
+        } else {
+            printf("✗ TEST FAILED: CSR file round trip (write=%d, read=%d)\n",
+                   write_err, read_err);
+        }
+        remove(path);
+    }
+    
+    csr_free(&X);
+    csr_free(&local_X);
+    if (read_err == 0) {
+        csr_free(&read_X);
+    }
+    free(y);
+    free(X_dense);
+    free(local_y);
+    free(read_y);
+    free(works);
+    free(beta);
+    free(beta_ols);
+    free(beta_gd);
+    free(beta_sparse_gd);
+    free(beta_cg);
+    MPI_Finalize();
+    return 0;
+}
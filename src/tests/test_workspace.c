@@ -0,0 +1,185 @@
+/*
+ * test_workspace.c - Test the arena allocator and the solver context
+ * 
+ * Checks carve alignment and LIFO release, growth to the high-water
+ * mark, and that OLS and GD on a solver context match the
+ * pre-distributed solvers bit for bit while repeated solves reuse the
+ * same scratch region after warm-up
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <mpi.h>
+#include "../data.h"
+#include "../context.h"
+#include "../workspace.h"
+#include "../ols.h"
+#include "../gd.h"
+#include "../utils.h"
+
+int main(int argc, char *argv[]) {
+    MPI_Init(&argc, &argv);
+    
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    
+    // Test parameters
+    int n = 6000;
+    int d = 30;
+    int gd_iterations = 100;
+    double gd_lr = 0.1;
+    unsigned int seed = 42;
+    
+    if (rank == 0) {
+        printf("=== Testing Workspace and Solver Context ===\n");
+        printf("Problem size: n=%d, d=%d\n", n, d);
+        printf("Number of processes: %d\n\n", size);
+    }
+    
+    // Arena: aligned carves, LIFO release, no regrowth under live carves
+    workspace_t ws = {0};
+    int arena_ok = (workspace_reserve(&ws, 1000) == 0);
+    double *a = (double *)workspace_alloc(&ws, 3 * sizeof(double));
+    size_t mark = workspace_mark(&ws);
+    char *b = (char *)workspace_alloc(&ws, 1);
+    arena_ok = arena_ok && a && b &&
+               (uintptr_t)a % WORKSPACE_ALIGN == 0 && (uintptr_t)b % WORKSPACE_ALIGN == 0 &&
+               b - (char *)a == WORKSPACE_ALIGN;
+    arena_ok = arena_ok && workspace_alloc(&ws, 4096) == NULL &&
+               workspace_reserve(&ws, 4096) == -1;
+    workspace_release(&ws, mark);
+    arena_ok = arena_ok && workspace_alloc(&ws, 1) == b;
+    workspace_release(&ws, 0);
+    arena_ok = arena_ok && workspace_reserve(&ws, 3 * WORKSPACE_HUGE_PAGE) == 0 &&
+               (uintptr_t)ws.base % WORKSPACE_HUGE_PAGE == 0;
+    workspace_free(&ws);
+    
+    // High-water mark: an oversized nested carve gets a one-off region,
+    // and the next call on the empty workspace grows to cover both
+    workspace_t outer = {0};
+    workspace_t temp;
+    size_t outer_mark, inner_mark;
+    workspace_t *first = workspace_begin(&outer, &temp, 256, &outer_mark);
+    workspace_alloc(first, 256);
+    workspace_t *inner = workspace_begin(first, &temp, 1024, &inner_mark);
+    int grow_ok = (first == &outer && inner == &temp);
+    workspace_end(inner, &temp, inner_mark);
+    workspace_end(first, &temp, outer_mark);
+    first = workspace_begin(&outer, &temp, 256, &outer_mark);
+    workspace_alloc(first, 256);
+    inner = workspace_begin(first, &temp, 1024, &inner_mark);
+    grow_ok = grow_ok && first == &outer && inner == &outer && outer.capacity >= 1280;
+    workspace_end(inner, &temp, inner_mark);
+    workspace_end(first, &temp, outer_mark);
+    grow_ok = grow_ok && outer.used == 0;
+    workspace_free(&outer);
+    
+    // Reference fits on pre-distributed rows
+    int local_n, start_row;
+    get_row_partition(n, rank, size, &local_n, &start_row);
+    double *local_X = (double *)malloc((size_t)local_n * d * sizeof(double));
+    double *local_y = (double *)malloc(local_n * sizeof(double));
+    generate_synthetic_data_local(local_X, local_y, NULL, d, start_row, local_n, seed);
+    double *beta_ols = (double *)calloc(d, sizeof(double));
+    double *beta_gd = (double *)calloc(d, sizeof(double));
+    double *beta_gram = (double *)calloc(d, sizeof(double));
+    ols_parallel_local(local_X, local_y, beta_ols, local_n, d, MPI_COMM_WORLD);
+    gd_set_mode(GD_MODE_DATA);
+    gd_parallel_local(local_X, local_y, beta_gd, n, local_n, d, gd_iterations, gd_lr,
+                      MPI_COMM_WORLD);
+    gd_set_mode(GD_MODE_GRAM);
+    gd_parallel_local(local_X, local_y, beta_gram, n, local_n, d, gd_iterations, gd_lr,
+                      MPI_COMM_WORLD);
+    
+    // Same rows scattered from rank 0 into a context
+    double *X = NULL;
+    double *y = NULL;
+    if (rank == 0) {
+        X = (double *)malloc((size_t)n * d * sizeof(double));
+        y = (double *)malloc(n * sizeof(double));
+        generate_synthetic_data_local(X, y, NULL, d, 0, n, seed);
+    }
+    solver_context_t ctx;
+    int init_err = solver_context_init(&ctx, n, d, MPI_COMM_WORLD);
+    solver_context_scatter(&ctx, X, y);
+    int rows_same = (ctx.local_n == local_n && ctx.start_row == start_row &&
+                     (uintptr_t)ctx.local_X % WORKSPACE_ALIGN == 0 &&
+                     memcmp(ctx.local_X, local_X, (size_t)local_n * d * sizeof(double)) == 0);
+    
+    // Repeated solves: scratch settles once nested carves have been seen
+    // (the first round) and the workspace has regrown (the second)
+    double *beta = (double *)calloc(d, sizeof(double));
+    int same = 1;
+    int reused = 1;
+    char *scratch_base = NULL;
+    size_t scratch_capacity = 0;
+    for (int round = 0; round < 4; round++) {
+        ols_parallel_ctx(&ctx, beta);
+        same = same && (rank != 0 || memcmp(beta, beta_ols, d * sizeof(double)) == 0);
+        gd_set_mode(GD_MODE_DATA);
+        gd_parallel_ctx(&ctx, beta, gd_iterations, gd_lr);
+        same = same && (rank != 0 || memcmp(beta, beta_gd, d * sizeof(double)) == 0);
+        gd_set_mode(GD_MODE_GRAM);
+        gd_parallel_ctx(&ctx, beta, gd_iterations, gd_lr);
+        same = same && (rank != 0 || memcmp(beta, beta_gram, d * sizeof(double)) == 0);
+        
+        if (round > 1) {
+            reused = reused && ctx.scratch.base == scratch_base &&
+                     ctx.scratch.capacity == scratch_capacity;
+        }
+        reused = reused && ctx.scratch.used == 0;
+        scratch_base = ctx.scratch.base;
+        scratch_capacity = ctx.scratch.capacity;
+    }
+    int all_rows_same, all_reused;
+    MPI_Allreduce(&rows_same, &all_rows_same, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+    MPI_Allreduce(&reused, &all_reused, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+    
+    if (rank == 0) {
+        if (arena_ok) {
+            printf("✓ TEST PASSED: Carves are aligned and released in LIFO order\n");
+        } else {
+            printf("✗ TEST FAILED: Arena carve or release misbehaved\n");
+        }
+        
+        if (grow_ok) {
+            printf("✓ TEST PASSED: Workspace grows to its high-water mark when empty\n");
+        } else {
+            printf("✗ TEST FAILED: High-water growth (capacity %zu)\n", outer.capacity);
+        }
+        
+        if (init_err == 0 && all_rows_same) {
+            printf("✓ TEST PASSED: Context holds the standard row blocks, aligned\n");
+        } else {
+            printf("✗ TEST FAILED: Context row blocks differ from the partition\n");
+        }
+        
+        if (same) {
+            printf("✓ TEST PASSED: Context OLS/GD match the pre-distributed solvers\n");
+        } else {
+            printf("✗ TEST FAILED: Context solvers differ from the pre-distributed ones\n");
+        }
+        
+        printf("Scratch after warm-up: %zu bytes\n", scratch_capacity);
+        if (all_reused) {
+            printf("✓ TEST PASSED: Repeated solves reuse the scratch region\n");
+        } else {
+            printf("✗ TEST FAILED: Scratch was reallocated between solves\n");
+        }
+    }
+    
+    solver_context_free(&ctx);
+    free(local_X);
+    free(local_y);
+    free(X);
+    free(y);
+    free(beta);
+    free(beta_ols);
+    free(beta_gd);
+    free(beta_gram);
+    MPI_Finalize();
+    return 0;
+}
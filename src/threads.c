@@ -0,0 +1,56 @@
+/*
+ * threads.c - OpenMP helpers implementation
+ */
+
+#include "threads.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+void set_num_threads(int num_threads) {
+#ifdef _OPENMP
+    if (num_threads > 0) {
+        omp_set_num_threads(num_threads);
+    }
+#else
+    (void)num_threads;
+#endif
+}
+
+int get_num_threads(void) {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+int get_row_threads(int rows, int min_rows_per_thread) {
+    int num_threads = get_num_threads();
+    if (num_threads > rows / min_rows_per_thread) {
+        num_threads = rows / min_rows_per_thread;
+    }
+    return num_threads < 1 ? 1 : num_threads;
+}
+
+void thread_tree_reduce(double **bufs, int num_threads, size_t len) {
+#ifdef _OPENMP
+    int tid = omp_get_thread_num();
+    for (int stride = 1; stride < num_threads; stride *= 2) {
+        #pragma omp barrier
+        if (tid % (2 * stride) == 0 && tid + stride < num_threads) {
+            double *dst = bufs[tid];
+            const double *src = bufs[tid + stride];
+            for (size_t i = 0; i < len; i++) {
+                dst[i] += src[i];
+            }
+        }
+    }
+    #pragma omp barrier
+#else
+    (void)bufs;
+    (void)num_threads;
+    (void)len;
+#endif
+}
@@ -0,0 +1,49 @@
+/*
+ * threads.h - OpenMP helpers for hybrid MPI+OpenMP execution
+ * 
+ * Everything here compiles to the serial equivalent when OpenMP is
+ * disabled.
+ */
+
+#ifndef THREADS_H
+#define THREADS_H
+
+#include <stddef.h>
+
+// Below this many rows per thread, threading a row loop costs more than
+// it saves (shared by every threaded row loop: OLS, GD, TSQR,
+// standardisation and the context first touch)
+#define ROW_MIN_ROWS_PER_THREAD 256
+
+/*
+ * Set the number of OpenMP threads used inside each rank
+ */
+void set_num_threads(int num_threads);
+
+/*
+ * Number of OpenMP threads a parallel region will use (1 without OpenMP)
+ */
+int get_num_threads(void);
+
+/*
+ * Number of threads for a loop over rows: get_num_threads(), capped so
+ * each thread gets at least min_rows_per_thread rows (at least 1)
+ */
+int get_row_threads(int rows, int min_rows_per_thread);
+
+/*
+ * Binary-tree reduction of per-thread buffers: bufs[0] += bufs[1..]
+ * 
+ * Must be called by every thread of the enclosing parallel region.
+ * Each level adds pairs of buffers in parallel, so the reduction takes
+ * log2(num_threads) steps; the result is deterministic for a fixed
+ * thread count.
+ * 
+ * Parameters:
+ *   bufs - one buffer per thread
+ *   num_threads - number of threads in the region
+ *   len - elements per buffer
+ */
+void thread_tree_reduce(double **bufs, int num_threads, size_t len);
+
+#endif // THREADS_H
@@ -0,0 +1,167 @@
+/*
+ * timing.c - Phase timers implementation
+ */
+
+#include "timing.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    char name[TIMING_NAME_LEN];
+    double total;    // accumulated seconds
+    double started;  // MPI_Wtime of the open interval, < 0 if stopped
+    int calls;
+} phase_timer_t;
+
+static phase_timer_t timers[TIMING_MAX_TIMERS];
+static int num_timers = 0;
+
+/*
+ * Index of the named timer, creating it if create is set (-1 if absent
+ * or the table is full)
+ */
+static int find_timer(const char *name, int create) {
+    for (int i = 0; i < num_timers; i++) {
+        if (strncmp(timers[i].name, name, TIMING_NAME_LEN) == 0) {
+            return i;
+        }
+    }
+    if (!create || num_timers == TIMING_MAX_TIMERS) {
+        return -1;
+    }
+    phase_timer_t *t = &timers[num_timers];
+    memset(t, 0, sizeof(*t));
+    strncpy(t->name, name, TIMING_NAME_LEN - 1);
+    t->started = -1.0;
+    return num_timers++;
+}
+
+void timing_start(const char *name) {
+    int i = find_timer(name, 1);
+    if (i >= 0) {
+        timers[i].started = MPI_Wtime();
+    }
+}
+
+void timing_stop(const char *name) {
+    double now = MPI_Wtime();
+    int i = find_timer(name, 0);
+    if (i >= 0 && timers[i].started >= 0.0) {
+        timers[i].total += now - timers[i].started;
+        timers[i].started = -1.0;
+        timers[i].calls++;
+    }
+}
+
+void timing_reset(void) {
+    num_timers = 0;
+}
+
+double timing_get(const char *name) {
+    int i = find_timer(name, 0);
+    return (i >= 0) ? timers[i].total : 0.0;
+}
+
+int timing_report(FILE *out, const char *json_path, MPI_Comm comm) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    
+    // Step 1: Gather every rank's timer names, totals and call counts
+    // (ranks may have run different phases, e.g. the rank-0 solve)
+    char names[TIMING_MAX_TIMERS][TIMING_NAME_LEN];
+    double values[2 * TIMING_MAX_TIMERS];
+    memset(names, 0, sizeof(names));
+    memset(values, 0, sizeof(values));
+    for (int i = 0; i < num_timers; i++) {
+        memcpy(names[i], timers[i].name, TIMING_NAME_LEN);
+        values[2 * i] = timers[i].total;
+        values[2 * i + 1] = timers[i].calls;
+    }
+    
+    char *all_names = NULL;
+    double *all_values = NULL;
+    if (rank == 0) {
+        all_names = (char *)malloc((size_t)size * sizeof(names));
+        all_values = (double *)malloc((size_t)size * sizeof(values));
+    }
+    MPI_Gather(names, (int)sizeof(names), MPI_CHAR,
+               all_names, (int)sizeof(names), MPI_CHAR, 0, comm);
+    MPI_Gather(values, 2 * TIMING_MAX_TIMERS, MPI_DOUBLE,
+               all_values, 2 * TIMING_MAX_TIMERS, MPI_DOUBLE, 0, comm);
+    
+    int status = 0;
+    if (rank == 0) {
+        // Step 2: Merge by name in order of first appearance
+        char phase[TIMING_MAX_TIMERS][TIMING_NAME_LEN];
+        double t_min[TIMING_MAX_TIMERS], t_max[TIMING_MAX_TIMERS];
+        double t_sum[TIMING_MAX_TIMERS];
+        int calls[TIMING_MAX_TIMERS];
+        int seen[TIMING_MAX_TIMERS];
+        int num_phases = 0;
+        
+        for (int p = 0; p < size; p++) {
+            const char *p_names = all_names + (size_t)p * sizeof(names);
+            for (int i = 0; i < TIMING_MAX_TIMERS; i++) {
+                const char *name = p_names + (size_t)i * TIMING_NAME_LEN;
+                if (name[0] == '\0') continue;
+                int k = 0;
+                while (k < num_phases && strncmp(phase[k], name, TIMING_NAME_LEN) != 0) k++;
+                if (k == num_phases) {
+                    if (num_phases == TIMING_MAX_TIMERS) continue;
+                    memcpy(phase[k], name, TIMING_NAME_LEN);
+                    t_min[k] = 1e300;
+                    t_max[k] = 0.0;
+                    t_sum[k] = 0.0;
+                    calls[k] = 0;
+                    seen[k] = 0;
+                    num_phases++;
+                }
+                double t = all_values[(size_t)p * 2 * TIMING_MAX_TIMERS + 2 * i];
+                int c = (int)all_values[(size_t)p * 2 * TIMING_MAX_TIMERS + 2 * i + 1];
+                if (t < t_min[k]) t_min[k] = t;
+                if (t > t_max[k]) t_max[k] = t;
+                if (c > calls[k]) calls[k] = c;
+                t_sum[k] += t;
+                seen[k]++;
+            }
+        }
+        
+        // Ranks that never ran a phase spent 0 s in it
+        for (int k = 0; k < num_phases; k++) {
+            if (seen[k] < size) t_min[k] = 0.0;
+        }
+        
+        // Step 3: CSV to out, JSON to json_path
+        fprintf(out, "phase,calls,min_seconds,mean_seconds,max_seconds,imbalance\n");
+        for (int k = 0; k < num_phases; k++) {
+            double mean = t_sum[k] / size;
+            fprintf(out, "%s,%d,%.6f,%.6f,%.6f,%.3f\n", phase[k], calls[k],
+                    t_min[k], mean, t_max[k], mean > 0.0 ? t_max[k] / mean : 1.0);
+        }
+        
+        if (json_path) {
+            FILE *f = fopen(json_path, "w");
+            if (!f) {
+                fprintf(stderr, "Error: Cannot write timing file '%s'\n", json_path);
+                status = -1;
+            } else {
+                fprintf(f, "{\n  \"processes\": %d,\n  \"phases\": [", size);
+                for (int k = 0; k < num_phases; k++) {
+                    double mean = t_sum[k] / size;
+                    fprintf(f, "%s\n    {\"name\": \"%s\", \"calls\": %d, \"min\": %.9f, "
+                            "\"mean\": %.9f, \"max\": %.9f, \"imbalance\": %.6f}",
+                            k ? "," : "", phase[k], calls[k], t_min[k], mean, t_max[k],
+                            mean > 0.0 ? t_max[k] / mean : 1.0);
+                }
+                fprintf(f, "\n  ]\n}\n");
+                fclose(f);
+            }
+        }
+        free(all_names);
+        free(all_values);
+    }
+    
+    MPI_Bcast(&status, 1, MPI_INT, 0, comm);
+    return status;
+}
@@ -0,0 +1,53 @@
+/*
+ * timing.h - Named phase timers with cross-rank statistics
+ * 
+ * Solvers bracket each phase (scatter, local compute, collectives,
+ * solve) with timing_start/timing_stop. Repeated phases such as the
+ * per-iteration GD collectives accumulate into one timer and count
+ * their calls. timing_report combines the timers of all ranks into
+ * min/mean/max so load imbalance shows up as max >> mean.
+ * 
+ * Timers are process-global and must only be used from the thread
+ * that makes MPI calls.
+ */
+
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <stdio.h>
+#include <mpi.h>
+
+#define TIMING_MAX_TIMERS 32
+#define TIMING_NAME_LEN   32
+
+/*
+ * Start / stop the named timer (created on first use)
+ */
+void timing_start(const char *name);
+void timing_stop(const char *name);
+
+/*
+ * Clear all timers
+ */
+void timing_reset(void);
+
+/*
+ * Accumulated seconds of a timer on this rank (0 if it does not exist)
+ */
+double timing_get(const char *name);
+
+/*
+ * Combine the timers of all ranks and print them (collective)
+ * 
+ * Rank 0 prints one CSV row per phase to out:
+ *   phase,calls,min_seconds,mean_seconds,max_seconds,imbalance
+ * where imbalance = max / mean and a rank that never ran a phase
+ * counts as 0 s. If json_path is not NULL, rank 0 also writes the
+ * same table as JSON to that file.
+ * 
+ * Returns:
+ *   0 on success, -1 if the JSON file cannot be written
+ */
+int timing_report(FILE *out, const char *json_path, MPI_Comm comm);
+
+#endif // TIMING_H
@@ -0,0 +1,374 @@
+/*
+ * tsqr.c - TSQR least-squares solver implementation
+ * 
+ * All triangular factors are c x c with c = d + 1: the last column of
+ * [X | y] carries Q^T * y along, and R[d][d] ends up as the residual
+ * norm. R is stored row-major in full (only the upper triangle is
+ * used); the rows being folded in are stored column-major so every
+ * reflector update runs over contiguous memory.
+ */
+
+#include "tsqr.h"
+#include "threads.h"
+#include "timing.h"
+#include "utils.h"
+#include "workspace.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdio.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Row panels of [X | y] are sized to stay resident in L2
+#define TSQR_PANEL_BYTES (256 * 1024)
+#define TSQR_PANEL_MIN_ROWS 16
+
+// Columns per block of the blocked Householder QR
+#define TSQR_QR_NB 32
+
+// Relative size below which a diagonal entry of R counts as zero
+#define TSQR_RANK_RTOL 1e-13
+
+#define TSQR_TAG 23
+
+/*
+ * Householder QR of the stack [R; B]: R (c x c, upper triangular) is
+ * replaced by the triangular factor of the stack, B (b x c,
+ * column-major) is overwritten with the reflectors
+ * 
+ * Below the diagonal, column j of the stack is nonzero only in B, so
+ * every reflector has length b + 1 and the update costs about 2 b c^2
+ * flops instead of 2 (b + c) c^2.
+ * 
+ * Blocked: the reflectors of each TSQR_QR_NB-column block are factored
+ * against that block only, then applied to the trailing columns at
+ * once in compact WY form, Q^T = I - V T^T V^T, so each trailing column
+ * is read once per block instead of once per reflector. The R part of
+ * reflector j is e_j, hence V^T V = I + B^T B off the diagonal.
+ */
+static void qr_stack(double *R, double *B, int b, int c) {
+    double T[TSQR_QR_NB * TSQR_QR_NB];
+    double w[TSQR_QR_NB];
+    
+    for (int j0 = 0; j0 < c; j0 += TSQR_QR_NB) {
+        int nb = (c - j0 < TSQR_QR_NB) ? c - j0 : TSQR_QR_NB;
+        int j1 = j0 + nb;
+        
+        // Step 1: Factor the block column, updating only its own columns
+        for (int j = j0; j < j1; j++) {
+            int lj = j - j0;
+            double *bj = B + (size_t)j * b;
+            double norm_sq = 0.0;
+            for (int i = 0; i < b; i++) {
+                norm_sq += bj[i] * bj[i];
+            }
+            double tau = 0.0;  // column already triangular: H = I
+            if (norm_sq != 0.0) {
+                // Reflector v = [e_j; bj / (alpha - beta)] maps the column to beta * e_j
+                double alpha = R[(size_t)j * c + j];
+                double norm = sqrt(alpha * alpha + norm_sq);
+                double beta = (alpha >= 0.0) ? -norm : norm;
+                tau = (beta - alpha) / beta;
+                double scale = 1.0 / (alpha - beta);
+                for (int i = 0; i < b; i++) {
+                    bj[i] *= scale;
+                }
+                R[(size_t)j * c + j] = beta;
+                
+                // Apply H = I - tau * v * v^T to the rest of the block
+                for (int k = j + 1; k < j1; k++) {
+                    double *bk = B + (size_t)k * b;
+                    double wk = R[(size_t)j * c + k];
+                    for (int i = 0; i < b; i++) {
+                        wk += bj[i] * bk[i];
+                    }
+                    wk *= tau;
+                    R[(size_t)j * c + k] -= wk;
+                    for (int i = 0; i < b; i++) {
+                        bk[i] -= wk * bj[i];
+                    }
+                }
+            }
+            
+            // Step 2: Column lj of T: T[0:lj][lj] = -tau * T[0:lj][0:lj] * V^T v_j
+            T[lj * TSQR_QR_NB + lj] = tau;
+            for (int s = 0; s < lj; s++) {
+                const double *bs = B + (size_t)(j0 + s) * b;
+                double dot = 0.0;
+                for (int i = 0; i < b; i++) {
+                    dot += bs[i] * bj[i];
+                }
+                w[s] = dot;
+            }
+            for (int r = 0; r < lj; r++) {
+                double sum = 0.0;
+                for (int s = r; s < lj; s++) {
+                    sum += T[r * TSQR_QR_NB + s] * w[s];
+                }
+                T[r * TSQR_QR_NB + lj] = -tau * sum;
+            }
+        }
+        
+        // Step 3: Apply Q^T = I - V T^T V^T to each trailing column
+        for (int k = j1; k < c; k++) {
+            double *bk = B + (size_t)k * b;
+            for (int s = 0; s < nb; s++) {
+                const double *bs = B + (size_t)(j0 + s) * b;
+                double dot = R[(size_t)(j0 + s) * c + k];
+                for (int i = 0; i < b; i++) {
+                    dot += bs[i] * bk[i];
+                }
+                w[s] = dot;
+            }
+            // w = T^T * w (lower triangular, in place from the bottom)
+            for (int r = nb - 1; r >= 0; r--) {
+                double sum = 0.0;
+                for (int s = 0; s <= r; s++) {
+                    sum += T[s * TSQR_QR_NB + r] * w[s];
+                }
+                w[r] = sum;
+            }
+            for (int s = 0; s < nb; s++) {
+                const double *bs = B + (size_t)(j0 + s) * b;
+                double ws = w[s];
+                R[(size_t)(j0 + s) * c + k] -= ws;
+                for (int i = 0; i < b; i++) {
+                    bk[i] -= ws * bs[i];
+                }
+            }
+        }
+    }
+}
+
+/*
+ * Pack the upper triangle of R row by row (c * (c + 1) / 2 values)
+ */
+static void pack_upper(const double *R, int c, double *packed) {
+    size_t pos = 0;
+    for (int i = 0; i < c; i++) {
+        for (int j = i; j < c; j++) {
+            packed[pos++] = R[(size_t)i * c + j];
+        }
+    }
+}
+
+/*
+ * Unpack a packed triangle into a column-major c x c block for qr_stack
+ */
+static void unpack_upper_cols(const double *packed, int c, double *B) {
+    memset(B, 0, (size_t)c * c * sizeof(double));
+    size_t pos = 0;
+    for (int i = 0; i < c; i++) {
+        for (int j = i; j < c; j++) {
+            B[(size_t)j * c + i] = packed[pos++];
+        }
+    }
+}
+
+/*
+ * Rows per L2-sized panel of [X | y] for a block of rows (0 if empty)
+ */
+static int tsqr_panel_rows(int rows, int c) {
+    int panel = TSQR_PANEL_BYTES / ((int)sizeof(double) * c);
+    if (panel < TSQR_PANEL_MIN_ROWS) panel = TSQR_PANEL_MIN_ROWS;
+    if (panel > rows) panel = rows;
+    return panel;
+}
+
+/*
+ * Fold rows of [X | y] into R, one L2-sized panel at a time (single
+ * thread); B holds tsqr_panel_rows(rows, d + 1) x (d + 1) doubles
+ */
+static void tsqr_local_block(
+    const double *X,
+    const double *y,
+    int rows,
+    int d,
+    double *R,
+    double *B
+) {
+    int c = d + 1;
+    int panel = tsqr_panel_rows(rows, c);
+    if (panel < 1) return;
+    
+    for (int r0 = 0; r0 < rows; r0 += panel) {
+        int b = (rows - r0 < panel) ? rows - r0 : panel;
+        
+        // Transpose the panel into column-major [X | y]
+        for (int i = 0; i < b; i++) {
+            const double *x_row = X + (size_t)(r0 + i) * d;
+            for (int k = 0; k < d; k++) {
+                B[(size_t)k * b + i] = x_row[k];
+            }
+            B[(size_t)d * b + i] = y[r0 + i];
+        }
+        qr_stack(R, B, b, c);
+    }
+}
+
+/*
+ * Bytes tsqr_local carves for num_threads threads: a panel per thread,
+ * plus a factor per extra thread and the pointer tables
+ */
+static size_t tsqr_local_bytes(int rows, int d, int num_threads) {
+    int c = d + 1;
+    size_t panel_len = (size_t)tsqr_panel_rows(rows, c) * c;
+    size_t bytes = num_threads * workspace_bytes(panel_len, sizeof(double));
+    if (num_threads > 1) {
+        bytes += (num_threads - 1) * workspace_bytes((size_t)c * c, sizeof(double)) +
+                 2 * workspace_bytes(num_threads, sizeof(double *));
+    }
+    return bytes;
+}
+
+/*
+ * Triangular factor of this rank's [X | y], with the rows split across
+ * OpenMP threads and the per-thread factors folded together in order
+ * (buffers carved from ws, sized by tsqr_local_bytes; packed and B are
+ * the tree step's buffers, reused for the fold)
+ */
+static void tsqr_local(
+    const double *X,
+    const double *y,
+    int rows,
+    int d,
+    double *R,
+    int num_threads,
+    double *packed,
+    double *B,
+    workspace_t *ws
+) {
+    if (num_threads <= 1) {
+        double *panel = (double *)workspace_alloc(ws, (size_t)tsqr_panel_rows(rows, d + 1) *
+                                                      (d + 1) * sizeof(double));
+        tsqr_local_block(X, y, rows, d, R, panel);
+        return;
+    }
+    
+#ifdef _OPENMP
+    int c = d + 1;
+    size_t panel_len = (size_t)tsqr_panel_rows(rows, c) * c;
+    double **R_bufs = (double **)workspace_alloc(ws, num_threads * sizeof(double *));
+    double **panels = (double **)workspace_alloc(ws, num_threads * sizeof(double *));
+    for (int t = 0; t < num_threads; t++) {
+        // Thread 0 factors straight into the output
+        R_bufs[t] = (t == 0) ? R :
+            (double *)workspace_alloc(ws, (size_t)c * c * sizeof(double));
+        panels[t] = (double *)workspace_alloc(ws, panel_len * sizeof(double));
+    }
+    int team = num_threads;
+    
+    #pragma omp parallel num_threads(num_threads)
+    {
+        // The team may be smaller than requested (e.g. OMP_THREAD_LIMIT):
+        // split the rows over the threads actually granted
+        int tid = omp_get_thread_num();
+        int nt = omp_get_num_threads();
+        if (tid == 0) {
+            team = nt;
+        }
+        int block_n, block_start;
+        get_row_partition(rows, tid, nt, &block_n, &block_start);
+        
+        if (tid != 0) {
+            memset(R_bufs[tid], 0, (size_t)c * c * sizeof(double));
+        }
+        tsqr_local_block(X + (size_t)block_start * d, y + block_start, block_n, d,
+                         R_bufs[tid], panels[tid]);
+    }
+    
+    for (int t = 1; t < team; t++) {
+        pack_upper(R_bufs[t], c, packed);
+        unpack_upper_cols(packed, c, B);
+        qr_stack(R, B, c, c);
+    }
+#endif
+}
+
+int tsqr_solve(
+    const double *local_X,
+    const double *local_y,
+    double *beta,
+    int local_n,
+    int d,
+    workspace_t *scratch,
+    MPI_Comm comm
+) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    
+    // Every buffer is carved up front from one checked workspace
+    int c = d + 1;
+    int count = c * (c + 1) / 2;
+    int num_threads = get_row_threads(local_n, ROW_MIN_ROWS_PER_THREAD);
+    size_t bytes = 2 * workspace_bytes((size_t)c * c, sizeof(double)) +
+                   workspace_bytes(count, sizeof(double)) +
+                   tsqr_local_bytes(local_n, d, num_threads);
+    workspace_t temp;
+    size_t mark;
+    workspace_t *ws = workspace_begin(scratch, &temp, bytes, &mark);
+    workspace_require(ws, "tsqr_solve");
+    double *R = (double *)workspace_alloc(ws, (size_t)c * c * sizeof(double));
+    double *packed = (double *)workspace_alloc(ws, count * sizeof(double));
+    double *B = (double *)workspace_alloc(ws, (size_t)c * c * sizeof(double));
+    memset(R, 0, (size_t)c * c * sizeof(double));
+    
+    // Step 1: Householder QR of the local row block
+    timing_start("tsqr.local");
+    tsqr_local(local_X, local_y, local_n, d, R, num_threads, packed, B, ws);
+    timing_stop("tsqr.local");
+    
+    // Step 2: binary reduction tree; at each level the odd partner sends
+    // its packed triangle and drops out, the even one folds it in
+    timing_start("tsqr.tree");
+    for (int step = 1; step < size; step *= 2) {
+        if (rank % (2 * step) == step) {
+            pack_upper(R, c, packed);
+            MPI_Send(packed, count, MPI_DOUBLE, rank - step, TSQR_TAG, comm);
+            break;
+        }
+        if (rank + step < size) {
+            MPI_Recv(packed, count, MPI_DOUBLE, rank + step, TSQR_TAG, comm, MPI_STATUS_IGNORE);
+            unpack_upper_cols(packed, c, B);
+            qr_stack(R, B, c, c);
+        }
+    }
+    timing_stop("tsqr.tree");
+    
+    // Step 3: rank 0 solves R * beta = Q^T * y (last column of R)
+    int status = 0;
+    if (rank == 0) {
+        timing_start("tsqr.solve");
+        double max_diag = 0.0;
+        for (int j = 0; j < d; j++) {
+            double r = fabs(R[(size_t)j * c + j]);
+            if (r > max_diag) max_diag = r;
+        }
+        for (int j = 0; j < d; j++) {
+            if (!(fabs(R[(size_t)j * c + j]) > TSQR_RANK_RTOL * max_diag)) {
+                status = -1;
+            }
+        }
+        if (status == 0) {
+            for (int i = d - 1; i >= 0; i--) {
+                const double *r_row = R + (size_t)i * c;
+                double sum = r_row[d];
+                for (int k = i + 1; k < d; k++) {
+                    sum -= r_row[k] * beta[k];
+                }
+                beta[i] = sum / r_row[i];
+            }
+        } else {
+            fprintf(stderr, "Error: X is numerically rank deficient (TSQR)\n");
+        }
+        timing_stop("tsqr.solve");
+    }
+    MPI_Bcast(&status, 1, MPI_INT, 0, comm);
+    
+    workspace_end(ws, &temp, mark);
+    return status;
+}
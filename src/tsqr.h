@@ -0,0 +1,44 @@
+/*
+ * tsqr.h - Communication-avoiding QR least-squares solver (TSQR)
+ * 
+ * Solves min ||X * beta - y|| without forming XtX, so the condition
+ * number is not squared. Each rank factors its row block [local_X | y]
+ * with blocked Householder QR; the (d+1) x (d+1) triangular factors are
+ * combined up a binary tree (one packed triangle per message and
+ * level, no more than the XtX reduction sends) and rank 0 finishes
+ * with a triangular solve against Q^T * y.
+ */
+
+#ifndef TSQR_H
+#define TSQR_H
+
+#include <mpi.h>
+#include "workspace.h"
+
+/*
+ * Least-squares fit on pre-distributed row blocks via TSQR
+ * 
+ * Parameters:
+ *   local_X - local_n x d row block owned by this rank
+ *   local_y - local_n x 1 response block owned by this rank
+ *   beta - d x 1 output parameters (computed on rank 0)
+ *   local_n - number of rows owned by this rank (may be below d)
+ *   d - number of features
+ *   scratch - workspace for the factors and panels, or NULL for a
+ *             one-off one
+ *   comm - MPI communicator
+ * 
+ * Returns:
+ *   0 on success, -1 (on every rank) if X is numerically rank deficient
+ */
+int tsqr_solve(
+    const double *local_X,
+    const double *local_y,
+    double *beta,
+    int local_n,
+    int d,
+    workspace_t *scratch,
+    MPI_Comm comm
+);
+
+#endif // TSQR_H
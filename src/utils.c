@@ -24,6 +24,13 @@ double vector_diff_norm(const double *v1, const double *v2, int n) {
     return sqrt(norm);
 }
 
+void get_row_partition(int n, int rank, int size, int *local_n, int *start_row) {
+    int rows_per_proc = n / size;
+    int remainder = n % size;
+    *local_n = rows_per_proc + (rank < remainder ? 1 : 0);
+    *start_row = rank * rows_per_proc + (rank < remainder ? rank : remainder);
+}
+
 void print_vector(const char *name, const double *v, int n) {
     printf("%s = [", name);
     for (int i = 0; i < n; i++) {
@@ -17,6 +17,21 @@ double compute_mse(const double *y_true, const double *y_pred, int n);
  */
 double vector_diff_norm(const double *v1, const double *v2, int n);
 
+/*
+ * Block row partition used by every parallel solver
+ * 
+ * Rows are split into contiguous blocks; the first (n % size) ranks
+ * get one extra row.
+ * 
+ * Parameters:
+ *   n - total number of rows
+ *   rank - rank whose block is requested
+ *   size - number of ranks
+ *   local_n - number of rows owned by rank (output)
+ *   start_row - global index of the first owned row (output)
+ */
+void get_row_partition(int n, int rank, int size, int *local_n, int *start_row);
+
 /*
  * Print vector (for debugging)
  */
@@ -0,0 +1,148 @@
+/*
+ * workspace.c - Aligned arena allocator implementation
+ */
+
+#define _DEFAULT_SOURCE  // posix_memalign/madvise under -std=c99
+
+#include "workspace.h"
+#include "utils.h"
+#include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+size_t workspace_bytes(size_t count, size_t elem_size) {
+    size_t bytes = count * elem_size;
+    return (bytes + WORKSPACE_ALIGN - 1) & ~((size_t)WORKSPACE_ALIGN - 1);
+}
+
+int workspace_reserve(workspace_t *ws, size_t bytes) {
+    if (bytes > ws->high_water) {
+        ws->high_water = bytes;
+    }
+    if (bytes <= ws->capacity) {
+        return 0;
+    }
+    if (ws->used != 0) {
+        return -1;
+    }
+    
+    // Huge-page alignment lets the kernel back large regions with 2 MB pages
+    size_t align = WORKSPACE_ALIGN;
+    size_t capacity = workspace_bytes(bytes, 1);
+    if (capacity >= WORKSPACE_HUGE_PAGE) {
+        align = WORKSPACE_HUGE_PAGE;
+        capacity = (capacity + WORKSPACE_HUGE_PAGE - 1) & ~(WORKSPACE_HUGE_PAGE - 1);
+    }
+    void *base;
+    if (posix_memalign(&base, align, capacity) != 0) {
+        return -1;
+    }
+#ifdef MADV_HUGEPAGE
+    if (align == WORKSPACE_HUGE_PAGE) {
+        madvise(base, capacity, MADV_HUGEPAGE);  // advisory; ignore failure
+    }
+#endif
+    
+    free(ws->base);
+    ws->base = (char *)base;
+    ws->capacity = capacity;
+    return 0;
+}
+
+void *workspace_alloc(workspace_t *ws, size_t bytes) {
+    size_t size = workspace_bytes(bytes, 1);
+    if (ws->used + size > ws->high_water) {
+        ws->high_water = ws->used + size;
+    }
+    if (!ws->base || ws->used + size > ws->capacity) {
+        return NULL;
+    }
+    void *ptr = ws->base + ws->used;
+    ws->used += size;
+    return ptr;
+}
+
+size_t workspace_mark(const workspace_t *ws) {
+    return ws->used;
+}
+
+void workspace_release(workspace_t *ws, size_t mark) {
+    ws->used = mark;
+}
+
+void workspace_free(workspace_t *ws) {
+    free(ws->base);
+    ws->base = NULL;
+    ws->capacity = 0;
+    ws->used = 0;
+    ws->high_water = 0;
+}
+
+workspace_t *workspace_begin(workspace_t *ws, workspace_t *temp, size_t bytes, size_t *mark) {
+    if (ws) {
+        // An empty workspace grows to everything its callers have needed
+        size_t need = ws->used + bytes;
+        if (need > ws->high_water) {
+            ws->high_water = need;
+        }
+        if (ws->used == 0 && workspace_reserve(ws, ws->high_water) != 0) {
+            return NULL;
+        }
+        if (ws->capacity - ws->used >= bytes) {
+            *mark = ws->used;
+            return ws;
+        }
+    }
+    
+    // Nested carve that does not fit: one region for this call only
+    memset(temp, 0, sizeof(*temp));
+    if (workspace_reserve(temp, bytes) != 0) {
+        return NULL;
+    }
+    *mark = 0;
+    return temp;
+}
+
+void workspace_end(workspace_t *active, workspace_t *temp, size_t mark) {
+    if (!active) {
+        return;
+    }
+    if (active == temp) {
+        workspace_free(temp);
+    } else {
+        workspace_release(active, mark);
+    }
+}
+
+void workspace_require(const workspace_t *active, const char *where) {
+    if (!active) {
+        fprintf(stderr, "Error: Memory allocation failed in %s\n", where);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+}
+
+void workspace_first_touch(void *ptr, int rows, size_t row_bytes, int num_threads) {
+    if (num_threads <= 1 || rows < num_threads) {
+        memset(ptr, 0, (size_t)rows * row_bytes);
+        return;
+    }
+    
+#ifdef _OPENMP
+    #pragma omp parallel num_threads(num_threads)
+    {
+        // Split over the granted team, as the kernels do
+        int block_n, block_start;
+        get_row_partition(rows, omp_get_thread_num(), omp_get_num_threads(),
+                          &block_n, &block_start);
+        memset((char *)ptr + (size_t)block_start * row_bytes, 0, (size_t)block_n * row_bytes);
+    }
+#else
+    memset(ptr, 0, (size_t)rows * row_bytes);
+#endif
+}
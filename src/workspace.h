@@ -0,0 +1,113 @@
+/*
+ * workspace.h - Aligned arena allocator for solver working buffers
+ * 
+ * A workspace is one aligned region per rank from which a solver carves
+ * its temporaries with a pointer bump. Every carve starts on a 64-byte
+ * boundary, so per-thread buffers never share a cache line and SIMD
+ * loads are aligned; regions of 2 MB and more are aligned to (and
+ * advised as) huge pages. Nothing is touched at allocation time, so
+ * pages land on the NUMA node of the thread that first writes them
+ * (see workspace_first_touch).
+ * 
+ * Carves are released in LIFO order with workspace_mark/release. A
+ * workspace remembers the largest amount of scratch it was asked for
+ * and grows to it the next time it is empty (a nested carve that does
+ * not fit gets a one-off region meanwhile), so after a warm-up call or
+ * two, repeated solves on the same workspace do no allocator work.
+ */
+
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+
+#include <stddef.h>
+
+#define WORKSPACE_ALIGN 64
+#define WORKSPACE_HUGE_PAGE ((size_t)2 << 20)
+
+typedef struct {
+    char *base;         // aligned region (NULL until reserved)
+    size_t capacity;    // bytes in the region
+    size_t used;        // bytes carved so far
+    size_t high_water;  // largest used + request seen, for the next reserve
+} workspace_t;
+
+/*
+ * Bytes taken by count elements of elem_size, rounded up to the
+ * alignment (use to size a workspace)
+ */
+size_t workspace_bytes(size_t count, size_t elem_size);
+
+/*
+ * Make the region hold at least bytes; only an empty workspace is
+ * reallocated (a zeroed struct is a valid empty workspace)
+ * 
+ * Returns:
+ *   0 on success, -1 if allocation fails or carves are outstanding
+ */
+int workspace_reserve(workspace_t *ws, size_t bytes);
+
+/*
+ * Carve bytes from the workspace, aligned to WORKSPACE_ALIGN
+ * 
+ * Returns:
+ *   pointer into the region, or NULL if it is exhausted
+ */
+void *workspace_alloc(workspace_t *ws, size_t bytes);
+
+/*
+ * Current carve position, and release of everything carved after it
+ */
+size_t workspace_mark(const workspace_t *ws);
+void workspace_release(workspace_t *ws, size_t mark);
+
+/*
+ * Release the region (the struct is left empty and reusable)
+ */
+void workspace_free(workspace_t *ws);
+
+/*
+ * Scratch for one call: returns ws if it has bytes free (growing it to
+ * its high-water mark first if it is empty), otherwise a one-off region
+ * in temp; ws may be NULL. Pair with workspace_end.
+ * 
+ * Parameters:
+ *   ws - caller's workspace, or NULL
+ *   temp - storage for a one-off workspace
+ *   bytes - scratch needed by the call
+ *   mark - carve position to restore (output)
+ * 
+ * Returns:
+ *   the workspace to carve from, or NULL if allocation fails
+ */
+workspace_t *workspace_begin(workspace_t *ws, workspace_t *temp, size_t bytes, size_t *mark);
+
+/*
+ * Release the carves of a call: restores the mark on the caller's
+ * workspace, or frees the one-off region
+ */
+void workspace_end(workspace_t *active, workspace_t *temp, size_t mark);
+
+/*
+ * Abort the MPI job if workspace_begin returned NULL: the callers are
+ * collective solvers, which cannot unwind a failure on one rank
+ * 
+ * Parameters:
+ *   active - result of workspace_begin
+ *   where - calling function, for the error message
+ */
+void workspace_require(const workspace_t *active, const char *where);
+
+/*
+ * Zero a buffer with num_threads OpenMP threads, each writing the
+ * contiguous share that get_row_partition assigns it, so every page is
+ * first touched (and placed) by the thread that will process it
+ * 
+ * Parameters:
+ *   ptr - buffer of rows x row_bytes bytes
+ *   rows - number of rows (the unit of the partition)
+ *   row_bytes - bytes per row
+ *   num_threads - threads of the partition (1 zeroes serially)
+ */
+void workspace_first_touch(void *ptr, int rows, size_t row_bytes, int num_threads);
+
+#endif // WORKSPACE_H